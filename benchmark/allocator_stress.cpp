@@ -0,0 +1,212 @@
+//
+// Created by Dániel Molnár on 2019-11-12.
+//
+
+// Requests and releases device memory blocks from a growing number of
+// threads, through the allocator of a headless renderer, and writes the
+// allocations per second for every thread count as JSON, to the file given as
+// the first argument or to the standard output.
+// In the local run every thread releases its own blocks, oldest first, in the
+// remote run the blocks are released by the next thread, as when resources
+// loaded on a worker are destroyed by the renderer. The planned run is the
+// local one while another thread looks for chunks to evacuate every frame,
+// like the defragmenter of the renderer.
+
+// ----- std -----
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Memory/Allocator.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
+#include <Renderer/Vulkan/Renderer.hpp>
+#include <Window/HeadlessWindow.hpp>
+#include <Window/HeadlessWindowService.hpp>
+#include <configuration.hpp>
+#include "common.hpp"
+
+namespace {
+using Vulkan::Memory::Allocator;
+using Vulkan::Memory::Block;
+using Vulkan::Memory::Category;
+
+constexpr unsigned int AllocationsPerThread = 20000;
+// Blocks a thread keeps alive in the local run
+constexpr unsigned int LiveBlocks = 64;
+// Blocks every thread allocates before they are handed over in the remote run
+constexpr unsigned int RemoteBatch = 500;
+constexpr unsigned int Repetitions = 3;
+
+const std::vector<unsigned int> ThreadCounts = {1, 2, 4, 8, 16};
+
+constexpr auto FrameTime = std::chrono::milliseconds(16);
+
+// From 256 bytes to 64 KiB, the smaller sizes are the more frequent, like
+// uniform slices and small meshes
+VkMemoryRequirements Requirements(std::mt19937& random) {
+    std::geometric_distribution<unsigned int> exponent(0.35);
+    const auto size =
+        VkDeviceSize{256} << std::min(exponent(random), 8u);
+
+    VkMemoryRequirements requirements = {};
+    requirements.size = size - size / 4 * (random() % 2);
+    requirements.alignment = 256;
+    requirements.memoryTypeBits = ~0u;
+    return requirements;
+}
+
+const Block& Request(Allocator& allocator, std::mt19937& random) {
+    return allocator.request_memory(Requirements(random),
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void Local(Allocator& allocator, unsigned int seed) {
+    std::mt19937 random(seed);
+    std::vector<const Block*> live(LiveBlocks, nullptr);
+    for (auto i = 0u; i < AllocationsPerThread; ++i) {
+        auto& slot = live[i % LiveBlocks];
+        if (slot) {
+            allocator.release_memory(*slot);
+        }
+        slot = &Request(allocator, random);
+    }
+    for (const auto* block : live) {
+        if (block) {
+            allocator.release_memory(*block);
+        }
+    }
+}
+
+void RunLocal(Allocator& allocator, unsigned int thread_count) {
+    std::vector<std::thread> threads;
+    for (auto i = 0u; i < thread_count; ++i) {
+        threads.emplace_back(Local, std::ref(allocator), i);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void Planned(Allocator& allocator, unsigned int thread_count) {
+    std::atomic<bool> done = false;
+    std::thread planner([&allocator, &done]() {
+        while (!done) {
+            if (allocator.begin_evacuation(
+                    Configuration::DefragmentationOccupancy,
+                    {Category::Other})) {
+                allocator.end_evacuation();
+            }
+            std::this_thread::sleep_for(FrameTime);
+        }
+    });
+    RunLocal(allocator, thread_count);
+    done = true;
+    planner.join();
+}
+
+// Every round each thread allocates a batch, and releases the batch the
+// previous thread allocated in the round before
+void Remote(Allocator& allocator, unsigned int thread_count) {
+    std::vector<std::vector<const Block*>> batches(thread_count);
+    std::vector<std::mt19937> randoms;
+    for (auto i = 0u; i < thread_count; ++i) {
+        randoms.emplace_back(i);
+    }
+
+    const auto rounds = AllocationsPerThread / RemoteBatch;
+    for (auto round = 0u; round <= rounds; ++round) {
+        std::vector<std::vector<const Block*>> next(thread_count);
+        std::vector<std::thread> threads;
+        for (auto i = 0u; i < thread_count; ++i) {
+            threads.emplace_back([&, i]() {
+                for (const auto* block :
+                     batches[(i + thread_count - 1) % thread_count]) {
+                    allocator.release_memory(*block);
+                }
+                if (round < rounds) {
+                    next[i].reserve(RemoteBatch);
+                    for (auto j = 0u; j < RemoteBatch; ++j) {
+                        next[i].push_back(&Request(allocator, randoms[i]));
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        batches = std::move(next);
+    }
+}
+
+// Median of the repetitions, in allocations per second
+template <class Function>
+double Measure(unsigned int thread_count, Function&& run) {
+    std::vector<double> rates;
+    for (auto repetition = 0u; repetition < Repetitions; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        rates.push_back(static_cast<double>(AllocationsPerThread) *
+                        thread_count / elapsed.count());
+    }
+    return Benchmark::Median(rates);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::ofstream file;
+    if (argc > 1) {
+        file.open(argv[1]);
+        if (!file) {
+            std::cerr << "Could not open " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+    auto& out = file.is_open() ? static_cast<std::ostream&>(file) : std::cout;
+
+    HeadlessWindowService service(1);
+    service.setup(IWindowService::RendererType::Vulkan);
+    auto window = std::static_pointer_cast<HeadlessWindow>(
+        service.spawn_window(64, 64, "allocator_stress"));
+    Vulkan::Renderer renderer(service, window);
+    auto& allocator = renderer.logical_device().allocator();
+
+    out << "{\"allocations_per_thread\": " << AllocationsPerThread
+        << ", \"live_blocks\": " << LiveBlocks
+        << ", \"remote_batch\": " << RemoteBatch << ",\n"
+        << " \"results\": [\n";
+    for (auto i = 0u; i < ThreadCounts.size(); ++i) {
+        const auto thread_count = ThreadCounts[i];
+        std::cerr << "Running " << thread_count << " threads" << std::endl;
+
+        const auto local = Measure(
+            thread_count, [&]() { RunLocal(allocator, thread_count); });
+        const auto remote = Measure(
+            thread_count, [&]() { Remote(allocator, thread_count); });
+        const auto planned = Measure(
+            thread_count, [&]() { Planned(allocator, thread_count); });
+
+        out << "    {\"threads\": " << thread_count
+            << ", \"local_per_second\": " << local
+            << ", \"remote_per_second\": " << remote
+            << ", \"planned_per_second\": " << planned << "}"
+            << (i + 1 < ThreadCounts.size() ? ",\n" : "\n");
+    }
+
+    const auto statistics = allocator.statistics();
+    out << " ],\n \"allocator\": ";
+    Vulkan::Memory::WriteJson(out, statistics);
+    out << "\n}" << std::endl;
+
+    return 0;
+}
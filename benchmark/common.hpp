@@ -0,0 +1,600 @@
+//
+// Created by Dániel Molnár on 2019-10-31.
+//
+
+#pragma once
+#ifndef VULKANENGINE_BENCHMARK_COMMON_HPP
+#define VULKANENGINE_BENCHMARK_COMMON_HPP
+
+// ----- std -----
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+
+// Minimal headless Vulkan setup shared by the benchmarks. Nothing is presented,
+// so no window or surface is needed, and a software rasterizer can be used.
+namespace Benchmark {
+inline void Check(VkResult result, const std::string& action) {
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Could not " + action);
+    }
+}
+
+inline double Median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto middle = values.size() / 2;
+    return values.size() % 2 == 1
+               ? values[middle]
+               : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+// Nearest-rank percentile, percent is in [0, 100]
+inline double Percentile(std::vector<double> values, double percent) {
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto rank = static_cast<std::size_t>(
+        std::ceil(percent / 100.0 * static_cast<double>(values.size())));
+    return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
+}
+
+// Instance, device and queue of the benchmark. A CPU device is preferred, the
+// software rasterizer gives the most stable timings, and the same numbers on
+// every machine it runs on.
+class Context {
+   private:
+    VkInstance _instance = VK_NULL_HANDLE;
+    VkPhysicalDevice _physical_device = VK_NULL_HANDLE;
+    VkDevice _device = VK_NULL_HANDLE;
+    VkQueue _queue = VK_NULL_HANDLE;
+    std::uint32_t _queue_family = 0;
+    VkCommandPool _command_pool = VK_NULL_HANDLE;
+
+    VkPhysicalDeviceProperties _properties = {};
+
+    void create_instance() {
+        VkApplicationInfo app_info = {};
+        app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        app_info.pApplicationName = "Benchmark";
+        app_info.apiVersion = VK_API_VERSION_1_1;
+
+        VkInstanceCreateInfo create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        create_info.pApplicationInfo = &app_info;
+
+        Check(vkCreateInstance(&create_info, nullptr, &_instance),
+              "create instance");
+    }
+
+    void pick_physical_device() {
+        std::uint32_t count = 0;
+        vkEnumeratePhysicalDevices(_instance, &count, nullptr);
+        std::vector<VkPhysicalDevice> devices(count);
+        vkEnumeratePhysicalDevices(_instance, &count, devices.data());
+
+        auto best_score = 0;
+        for (auto device : devices) {
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(device, &properties);
+
+            std::uint32_t family_count = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count,
+                                                     nullptr);
+            std::vector<VkQueueFamilyProperties> families(family_count);
+            vkGetPhysicalDeviceQueueFamilyProperties(device, &family_count,
+                                                     families.data());
+
+            for (auto i = 0u; i < family_count; ++i) {
+                if ((families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0 ||
+                    families[i].timestampValidBits == 0) {
+                    continue;
+                }
+
+                const auto score =
+                    properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU ? 2
+                                                                         : 1;
+                if (score > best_score) {
+                    best_score = score;
+                    _physical_device = device;
+                    _queue_family = i;
+                    _properties = properties;
+                }
+                break;
+            }
+        }
+
+        if (_physical_device == VK_NULL_HANDLE) {
+            throw std::runtime_error(
+                "No device with graphics queue and timestamps");
+        }
+    }
+
+    void create_device() {
+        const float priority = 1.0f;
+        VkDeviceQueueCreateInfo queue_info = {};
+        queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_info.queueFamilyIndex = _queue_family;
+        queue_info.queueCount = 1;
+        queue_info.pQueuePriorities = &priority;
+
+        VkDeviceCreateInfo create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        create_info.queueCreateInfoCount = 1;
+        create_info.pQueueCreateInfos = &queue_info;
+
+        Check(vkCreateDevice(_physical_device, &create_info, nullptr, &_device),
+              "create device");
+        vkGetDeviceQueue(_device, _queue_family, 0, &_queue);
+
+        VkCommandPoolCreateInfo pool_info = {};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = _queue_family;
+
+        Check(vkCreateCommandPool(_device, &pool_info, nullptr, &_command_pool),
+              "create command pool");
+    }
+
+   public:
+    Context() {
+        create_instance();
+        pick_physical_device();
+        create_device();
+
+        std::cout << "Device: " << _properties.deviceName << std::endl;
+    }
+
+    ~Context() {
+        vkDestroyCommandPool(_device, _command_pool, nullptr);
+        vkDestroyDevice(_device, nullptr);
+        vkDestroyInstance(_instance, nullptr);
+    }
+
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+
+    [[nodiscard]] VkDevice device() const { return _device; }
+    [[nodiscard]] VkPhysicalDevice physical_device() const {
+        return _physical_device;
+    }
+    [[nodiscard]] const VkPhysicalDeviceProperties& properties() const {
+        return _properties;
+    }
+
+    [[nodiscard]] std::uint32_t memory_type(
+        std::uint32_t type_bits, VkMemoryPropertyFlags properties) const {
+        VkPhysicalDeviceMemoryProperties memory_properties;
+        vkGetPhysicalDeviceMemoryProperties(_physical_device,
+                                            &memory_properties);
+
+        for (auto i = 0u; i < memory_properties.memoryTypeCount; ++i) {
+            if ((type_bits & (1u << i)) != 0 &&
+                (memory_properties.memoryTypes[i].propertyFlags & properties) ==
+                    properties) {
+                return i;
+            }
+        }
+        throw std::runtime_error("No suitable memory type");
+    }
+
+    // Loads a SPIR-V file compiled by the benchmark build
+    [[nodiscard]] VkShaderModule load_shader(
+        const std::string& file_name) const {
+        const auto path = std::string(BENCHMARK_SHADER_DIR) + "/" + file_name;
+        std::ifstream stream(path, std::ios::binary | std::ios::ate);
+        if (!stream) {
+            throw std::runtime_error("Could not open " + file_name);
+        }
+
+        std::vector<char> code(static_cast<size_t>(stream.tellg()));
+        stream.seekg(0);
+        stream.read(code.data(), code.size());
+
+        VkShaderModuleCreateInfo create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        create_info.codeSize = code.size();
+        create_info.pCode = reinterpret_cast<const std::uint32_t*>(code.data());
+
+        VkShaderModule module;
+        Check(vkCreateShaderModule(_device, &create_info, nullptr, &module),
+              "create shader module " + file_name);
+        return module;
+    }
+
+    // Records a one-off command buffer, submits it and waits until it is
+    // executed
+    void submit(const std::function<void(VkCommandBuffer)>& record) const {
+        VkCommandBufferAllocateInfo alloc_info = {};
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.commandPool = _command_pool;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandBufferCount = 1;
+
+        VkCommandBuffer command_buffer;
+        Check(vkAllocateCommandBuffers(_device, &alloc_info, &command_buffer),
+              "allocate command buffer");
+
+        VkCommandBufferBeginInfo begin_info = {};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(command_buffer, &begin_info);
+        record(command_buffer);
+        vkEndCommandBuffer(command_buffer);
+
+        VkSubmitInfo submit_info = {};
+        submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &command_buffer;
+
+        Check(vkQueueSubmit(_queue, 1, &submit_info, VK_NULL_HANDLE),
+              "submit command buffer");
+        vkQueueWaitIdle(_queue);
+
+        vkFreeCommandBuffers(_device, _command_pool, 1, &command_buffer);
+    }
+};
+
+// Color attachment the benchmarks render into, with a render pass clearing it
+class RenderTarget {
+   private:
+    const Context& _context;
+    std::uint32_t _width;
+    std::uint32_t _height;
+
+    VkImage _image = VK_NULL_HANDLE;
+    VkDeviceMemory _memory = VK_NULL_HANDLE;
+    VkImageView _view = VK_NULL_HANDLE;
+    VkRenderPass _render_pass = VK_NULL_HANDLE;
+    VkFramebuffer _framebuffer = VK_NULL_HANDLE;
+
+   public:
+    RenderTarget(const Context& context, std::uint32_t width,
+                 std::uint32_t height,
+                 VkFormat format = VK_FORMAT_R8G8B8A8_UNORM)
+        : _context(context), _width(width), _height(height) {
+        const auto device = _context.device();
+
+        VkImageCreateInfo image_info = {};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.format = format;
+        image_info.extent = {_width, _height, 1};
+        image_info.mipLevels = 1;
+        image_info.arrayLayers = 1;
+        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                           VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        Check(vkCreateImage(device, &image_info, nullptr, &_image),
+              "create render target");
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device, _image, &requirements);
+
+        VkMemoryAllocateInfo alloc_info = {};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = requirements.size;
+        alloc_info.memoryTypeIndex = _context.memory_type(
+            requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        Check(vkAllocateMemory(device, &alloc_info, nullptr, &_memory),
+              "allocate render target");
+        vkBindImageMemory(device, _image, _memory, 0);
+
+        VkImageViewCreateInfo view_info = {};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = _image;
+        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = format;
+        view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        view_info.subresourceRange.levelCount = 1;
+        view_info.subresourceRange.layerCount = 1;
+        Check(vkCreateImageView(device, &view_info, nullptr, &_view),
+              "create render target view");
+
+        VkAttachmentDescription attachment = {};
+        attachment.format = format;
+        attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+        VkAttachmentReference color_ref = {};
+        color_ref.attachment = 0;
+        color_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass = {};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &color_ref;
+
+        VkRenderPassCreateInfo pass_info = {};
+        pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        pass_info.attachmentCount = 1;
+        pass_info.pAttachments = &attachment;
+        pass_info.subpassCount = 1;
+        pass_info.pSubpasses = &subpass;
+        Check(vkCreateRenderPass(device, &pass_info, nullptr, &_render_pass),
+              "create render pass");
+
+        VkFramebufferCreateInfo framebuffer_info = {};
+        framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebuffer_info.renderPass = _render_pass;
+        framebuffer_info.attachmentCount = 1;
+        framebuffer_info.pAttachments = &_view;
+        framebuffer_info.width = _width;
+        framebuffer_info.height = _height;
+        framebuffer_info.layers = 1;
+        Check(vkCreateFramebuffer(device, &framebuffer_info, nullptr,
+                                  &_framebuffer),
+              "create framebuffer");
+    }
+
+    ~RenderTarget() {
+        const auto device = _context.device();
+        vkDestroyFramebuffer(device, _framebuffer, nullptr);
+        vkDestroyRenderPass(device, _render_pass, nullptr);
+        vkDestroyImageView(device, _view, nullptr);
+        vkDestroyImage(device, _image, nullptr);
+        vkFreeMemory(device, _memory, nullptr);
+    }
+
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+
+    // Begins the render pass, and sets the viewport and scissor to the whole
+    // target
+    void begin(VkCommandBuffer command_buffer) const {
+        VkClearValue clear_value = {};
+
+        VkRenderPassBeginInfo begin_info = {};
+        begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        begin_info.renderPass = _render_pass;
+        begin_info.framebuffer = _framebuffer;
+        begin_info.renderArea.extent = {_width, _height};
+        begin_info.clearValueCount = 1;
+        begin_info.pClearValues = &clear_value;
+        vkCmdBeginRenderPass(command_buffer, &begin_info,
+                             VK_SUBPASS_CONTENTS_INLINE);
+
+        VkViewport viewport = {};
+        viewport.width = static_cast<float>(_width);
+        viewport.height = static_cast<float>(_height);
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+
+        VkRect2D scissor = {};
+        scissor.extent = {_width, _height};
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+    }
+
+    void end(VkCommandBuffer command_buffer) const {
+        vkCmdEndRenderPass(command_buffer);
+    }
+
+    [[nodiscard]] VkRenderPass render_pass() const { return _render_pass; }
+    [[nodiscard]] VkImage image() const { return _image; }
+    [[nodiscard]] std::uint32_t width() const { return _width; }
+    [[nodiscard]] std::uint32_t height() const { return _height; }
+};
+
+// Host visible and coherent buffer, mapped for its whole lifetime
+class HostBuffer {
+   private:
+    const Context& _context;
+    VkDeviceSize _size;
+
+    VkBuffer _buffer = VK_NULL_HANDLE;
+    VkDeviceMemory _memory = VK_NULL_HANDLE;
+    void* _data = nullptr;
+
+   public:
+    HostBuffer(const Context& context, VkDeviceSize size,
+               VkBufferUsageFlags usage)
+        : _context(context), _size(size) {
+        const auto device = _context.device();
+
+        VkBufferCreateInfo buffer_info = {};
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.size = _size;
+        buffer_info.usage = usage;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        Check(vkCreateBuffer(device, &buffer_info, nullptr, &_buffer),
+              "create buffer");
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device, _buffer, &requirements);
+
+        VkMemoryAllocateInfo alloc_info = {};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = requirements.size;
+        alloc_info.memoryTypeIndex = _context.memory_type(
+            requirements.memoryTypeBits,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        Check(vkAllocateMemory(device, &alloc_info, nullptr, &_memory),
+              "allocate buffer");
+        vkBindBufferMemory(device, _buffer, _memory, 0);
+
+        Check(vkMapMemory(device, _memory, 0, _size, 0, &_data),
+              "map buffer");
+    }
+
+    ~HostBuffer() {
+        const auto device = _context.device();
+        vkUnmapMemory(device, _memory);
+        vkDestroyBuffer(device, _buffer, nullptr);
+        vkFreeMemory(device, _memory, nullptr);
+    }
+
+    HostBuffer(const HostBuffer&) = delete;
+    HostBuffer& operator=(const HostBuffer&) = delete;
+
+    [[nodiscard]] VkBuffer handle() const { return _buffer; }
+    [[nodiscard]] VkDeviceSize size() const { return _size; }
+    [[nodiscard]] void* data() const { return _data; }
+};
+
+// Measures the GPU time between begin() and end() with timestamp queries
+class GpuTimer {
+   private:
+    const Context& _context;
+    VkQueryPool _query_pool = VK_NULL_HANDLE;
+
+   public:
+    explicit GpuTimer(const Context& context) : _context(context) {
+        VkQueryPoolCreateInfo create_info = {};
+        create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        create_info.queryCount = 2;
+
+        Check(vkCreateQueryPool(_context.device(), &create_info, nullptr,
+                                &_query_pool),
+              "create query pool");
+    }
+
+    ~GpuTimer() {
+        vkDestroyQueryPool(_context.device(), _query_pool, nullptr);
+    }
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // Has to be recorded outside of render passes
+    void begin(VkCommandBuffer command_buffer) const {
+        vkCmdResetQueryPool(command_buffer, _query_pool, 0, 2);
+        vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            _query_pool, 0);
+    }
+
+    void end(VkCommandBuffer command_buffer) const {
+        vkCmdWriteTimestamp(command_buffer,
+                            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _query_pool,
+                            1);
+    }
+
+    // Valid once the command buffer is executed
+    [[nodiscard]] double milliseconds() const {
+        std::uint64_t timestamps[2] = {};
+        Check(vkGetQueryPoolResults(
+                  _context.device(), _query_pool, 0, 2, sizeof(timestamps),
+                  timestamps, sizeof(std::uint64_t),
+                  VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT),
+              "read timestamps");
+
+        const auto period = _context.properties().limits.timestampPeriod;
+        return static_cast<double>(timestamps[1] - timestamps[0]) * period /
+               1.0e6;
+    }
+};
+
+// Pipeline drawing a vertex buffer-less triangle list into the target, with
+// dynamic viewport and scissor, like the pipelines of the engine
+inline VkPipeline CreatePipeline(
+    const Context& context, const RenderTarget& target,
+    VkShaderModule vertex_shader, VkShaderModule fragment_shader,
+    VkPipelineLayout layout,
+    const VkSpecializationInfo* specialization = nullptr) {
+    VkPipelineShaderStageCreateInfo stages[2] = {};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertex_shader;
+    stages[0].pName = "main";
+
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragment_shader;
+    stages[1].pName = "main";
+    stages[1].pSpecializationInfo = specialization;
+
+    VkPipelineVertexInputStateCreateInfo vertex_input_info = {};
+    vertex_input_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly_info = {};
+    input_assembly_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewport_info = {};
+    viewport_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_info.viewportCount = 1;
+    viewport_info.scissorCount = 1;
+
+    const VkDynamicState dynamic_states[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                             VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamic_info = {};
+    dynamic_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_info.dynamicStateCount = 2;
+    dynamic_info.pDynamicStates = dynamic_states;
+
+    VkPipelineRasterizationStateCreateInfo rasterization_info = {};
+    rasterization_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterization_info.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterization_info.cullMode = VK_CULL_MODE_NONE;
+    rasterization_info.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterization_info.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisample_info = {};
+    multisample_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisample_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState blend = {};
+    blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                           VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo blend_info = {};
+    blend_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    blend_info.attachmentCount = 1;
+    blend_info.pAttachments = &blend;
+
+    VkGraphicsPipelineCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    create_info.stageCount = 2;
+    create_info.pStages = stages;
+    create_info.pVertexInputState = &vertex_input_info;
+    create_info.pInputAssemblyState = &input_assembly_info;
+    create_info.pViewportState = &viewport_info;
+    create_info.pRasterizationState = &rasterization_info;
+    create_info.pMultisampleState = &multisample_info;
+    create_info.pColorBlendState = &blend_info;
+    create_info.pDynamicState = &dynamic_info;
+    create_info.layout = layout;
+    create_info.renderPass = target.render_pass();
+    create_info.basePipelineIndex = -1;
+
+    VkPipeline pipeline;
+    Check(vkCreateGraphicsPipelines(context.device(), VK_NULL_HANDLE, 1,
+                                    &create_info, nullptr, &pipeline),
+          "create pipeline");
+    return pipeline;
+}
+}  // namespace Benchmark
+
+#endif  // VULKANENGINE_BENCHMARK_COMMON_HPP
@@ -0,0 +1,318 @@
+//
+// Created by Dániel Molnár on 2019-11-02.
+//
+
+// Compares the ways of passing the model matrix of every object to the vertex
+// shader, as selected by Configuration::ObjectData. The CPU time covers
+// writing the matrices and recording the draws, the GPU time the render pass.
+
+// ----- std -----
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// ----- in-project dependencies -----
+#include <configuration.hpp>
+#include "common.hpp"
+
+namespace {
+constexpr std::uint32_t Width = 1024;
+constexpr std::uint32_t Height = 1024;
+
+constexpr unsigned int SampleCount = 10;
+const std::vector<unsigned int> ObjectCounts = {100, 1000, 10000};
+
+const std::vector<ObjectDataStrategy> Strategies = {
+    ObjectDataStrategy::DynamicUniformBuffer,
+    ObjectDataStrategy::PushConstants, ObjectDataStrategy::StorageBuffer};
+
+const char* Name(ObjectDataStrategy strategy) {
+    switch (strategy) {
+        case ObjectDataStrategy::PushConstants:
+            return "push constants";
+        case ObjectDataStrategy::StorageBuffer:
+            return "storage buffer";
+        case ObjectDataStrategy::DynamicUniformBuffer:
+        default:
+            return "dynamic uniform";
+    }
+}
+
+const char* VertexShader(ObjectDataStrategy strategy) {
+    switch (strategy) {
+        case ObjectDataStrategy::PushConstants:
+            return "object_push_vert.spv";
+        case ObjectDataStrategy::StorageBuffer:
+            return "object_storage_vert.spv";
+        case ObjectDataStrategy::DynamicUniformBuffer:
+        default:
+            return "object_dynamic_vert.spv";
+    }
+}
+
+// Objects spread over the target in a grid, so all of them are rasterized
+std::vector<glm::mat4> Models(unsigned int count) {
+    std::vector<glm::mat4> models;
+    models.reserve(count);
+    for (auto i = 0u; i < count; ++i) {
+        const auto x = static_cast<float>(i % 100) / 50.0f - 1.0f;
+        const auto y = static_cast<float>(i / 100 % 100) / 50.0f - 1.0f;
+        models.push_back(glm::translate(glm::mat4(1.0f), {x, y, 0.0f}));
+    }
+    return models;
+}
+
+// Buffer, descriptors and pipeline drawing the objects with one strategy
+class Scene {
+   private:
+    const Benchmark::Context& _context;
+    ObjectDataStrategy _strategy;
+
+    // Distance of the matrices in the buffer
+    VkDeviceSize _stride = sizeof(glm::mat4);
+    std::unique_ptr<Benchmark::HostBuffer> _buffer;
+
+    VkShaderModule _vertex_shader = VK_NULL_HANDLE;
+    VkDescriptorSetLayout _set_layout = VK_NULL_HANDLE;
+    VkDescriptorPool _pool = VK_NULL_HANDLE;
+    VkDescriptorSet _set = VK_NULL_HANDLE;
+    VkPipelineLayout _layout = VK_NULL_HANDLE;
+    VkPipeline _pipeline = VK_NULL_HANDLE;
+
+    void create_descriptors(VkDescriptorType type, VkDeviceSize range) {
+        const auto device = _context.device();
+
+        VkDescriptorSetLayoutBinding binding = {};
+        binding.binding = 0;
+        binding.descriptorType = type;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+        VkDescriptorSetLayoutCreateInfo layout_info = {};
+        layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.bindingCount = 1;
+        layout_info.pBindings = &binding;
+        Benchmark::Check(vkCreateDescriptorSetLayout(device, &layout_info,
+                                                     nullptr, &_set_layout),
+                         "create descriptor set layout");
+
+        VkDescriptorPoolSize pool_size = {type, 1};
+        VkDescriptorPoolCreateInfo pool_info = {};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.maxSets = 1;
+        pool_info.poolSizeCount = 1;
+        pool_info.pPoolSizes = &pool_size;
+        Benchmark::Check(
+            vkCreateDescriptorPool(device, &pool_info, nullptr, &_pool),
+            "create descriptor pool");
+
+        VkDescriptorSetAllocateInfo alloc_info = {};
+        alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        alloc_info.descriptorPool = _pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &_set_layout;
+        Benchmark::Check(vkAllocateDescriptorSets(device, &alloc_info, &_set),
+                         "allocate descriptor set");
+
+        VkDescriptorBufferInfo buffer_info = {};
+        buffer_info.buffer = _buffer->handle();
+        buffer_info.range = range;
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = _set;
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pBufferInfo = &buffer_info;
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    }
+
+   public:
+    Scene(const Benchmark::Context& context,
+          const Benchmark::RenderTarget& target, ObjectDataStrategy strategy,
+          unsigned int object_count, VkShaderModule fragment_shader)
+        : _context(context), _strategy(strategy) {
+        const auto device = _context.device();
+
+        VkPipelineLayoutCreateInfo layout_info = {};
+        layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+
+        VkPushConstantRange push_range = {};
+        push_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        push_range.size = sizeof(glm::mat4);
+
+        switch (_strategy) {
+            case ObjectDataStrategy::PushConstants:
+                layout_info.pushConstantRangeCount = 1;
+                layout_info.pPushConstantRanges = &push_range;
+                break;
+            case ObjectDataStrategy::StorageBuffer:
+                _buffer = std::make_unique<Benchmark::HostBuffer>(
+                    _context, _stride * object_count,
+                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+                create_descriptors(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                   _buffer->size());
+                break;
+            case ObjectDataStrategy::DynamicUniformBuffer:
+            default: {
+                const auto& limits = _context.properties().limits;
+                const auto alignment = limits.minUniformBufferOffsetAlignment;
+                _stride = (_stride + alignment - 1) / alignment * alignment;
+                _buffer = std::make_unique<Benchmark::HostBuffer>(
+                    _context, _stride * object_count,
+                    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+                create_descriptors(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                   sizeof(glm::mat4));
+                break;
+            }
+        }
+
+        if (_set_layout != VK_NULL_HANDLE) {
+            layout_info.setLayoutCount = 1;
+            layout_info.pSetLayouts = &_set_layout;
+        }
+        Benchmark::Check(
+            vkCreatePipelineLayout(device, &layout_info, nullptr, &_layout),
+            "create pipeline layout");
+
+        _vertex_shader = _context.load_shader(VertexShader(_strategy));
+        _pipeline = Benchmark::CreatePipeline(_context, target, _vertex_shader,
+                                              fragment_shader, _layout);
+    }
+
+    ~Scene() {
+        const auto device = _context.device();
+        vkDestroyPipeline(device, _pipeline, nullptr);
+        vkDestroyPipelineLayout(device, _layout, nullptr);
+        vkDestroyShaderModule(device, _vertex_shader, nullptr);
+        vkDestroyDescriptorPool(device, _pool, nullptr);
+        vkDestroyDescriptorSetLayout(device, _set_layout, nullptr);
+    }
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    // Pushed matrices are part of the commands, nothing to write up front
+    void upload(const std::vector<glm::mat4>& models) const {
+        if (!_buffer) {
+            return;
+        }
+
+        auto data = static_cast<std::byte*>(_buffer->data());
+        if (_stride == sizeof(glm::mat4)) {
+            std::memcpy(data, models.data(), models.size() * _stride);
+            return;
+        }
+        for (const auto& model : models) {
+            std::memcpy(data, &model, sizeof(model));
+            data += _stride;
+        }
+    }
+
+    // The same draw per object as the engine records, one triangle each
+    void record(VkCommandBuffer command_buffer,
+                const std::vector<glm::mat4>& models) const {
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          _pipeline);
+        if (_strategy == ObjectDataStrategy::StorageBuffer) {
+            vkCmdBindDescriptorSets(command_buffer,
+                                    VK_PIPELINE_BIND_POINT_GRAPHICS, _layout, 0,
+                                    1, &_set, 0, nullptr);
+        }
+
+        for (auto i = 0u; i < models.size(); ++i) {
+            switch (_strategy) {
+                case ObjectDataStrategy::PushConstants:
+                    vkCmdPushConstants(command_buffer, _layout,
+                                       VK_SHADER_STAGE_VERTEX_BIT, 0,
+                                       sizeof(glm::mat4), &models[i]);
+                    break;
+                case ObjectDataStrategy::StorageBuffer:
+                    break;
+                case ObjectDataStrategy::DynamicUniformBuffer:
+                default: {
+                    const auto offset = static_cast<std::uint32_t>(i * _stride);
+                    vkCmdBindDescriptorSets(
+                        command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                        _layout, 0, 1, &_set, 1, &offset);
+                    break;
+                }
+            }
+            vkCmdDraw(command_buffer, 3, 1, 0, i);
+        }
+    }
+};
+
+struct Result {
+    double cpu_milliseconds;
+    double gpu_milliseconds;
+};
+
+Result Measure(const Benchmark::Context& context,
+               const Benchmark::RenderTarget& target,
+               const Benchmark::GpuTimer& timer, const Scene& scene,
+               const std::vector<glm::mat4>& models) {
+    std::vector<double> cpu_samples;
+    std::vector<double> gpu_samples;
+    for (auto i = 0u; i < SampleCount; ++i) {
+        context.submit([&](VkCommandBuffer command_buffer) {
+            const auto start = std::chrono::steady_clock::now();
+            scene.upload(models);
+
+            timer.begin(command_buffer);
+            target.begin(command_buffer);
+            scene.record(command_buffer, models);
+            target.end(command_buffer);
+            timer.end(command_buffer);
+
+            cpu_samples.push_back(std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+        });
+        gpu_samples.push_back(timer.milliseconds());
+    }
+    return {Benchmark::Median(cpu_samples), Benchmark::Median(gpu_samples)};
+}
+}  // namespace
+
+int main() {
+    Benchmark::Context context;
+    Benchmark::RenderTarget target(context, Width, Height);
+    Benchmark::GpuTimer timer(context);
+
+    const auto fragment_shader = context.load_shader("solid_frag.spv");
+
+    std::cout << std::setw(8) << "objects" << std::setw(18) << "strategy"
+              << std::setw(10) << "cpu ms" << std::setw(10) << "gpu ms"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (const auto object_count : ObjectCounts) {
+        const auto models = Models(object_count);
+        for (const auto strategy : Strategies) {
+            const Scene scene(context, target, strategy, object_count,
+                              fragment_shader);
+            const auto result = Measure(context, target, timer, scene, models);
+
+            std::cout << std::setw(8) << object_count << std::setw(18)
+                      << Name(strategy) << std::setw(10)
+                      << result.cpu_milliseconds << std::setw(10)
+                      << result.gpu_milliseconds << std::endl;
+        }
+    }
+
+    vkDestroyShaderModule(context.device(), fragment_shader, nullptr);
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+//
+// Created by Dániel Molnár on 2019-11-06.
+//
+
+// Runs scripted scenes through the whole renderer, headless, for a fixed
+// number of frames each, and writes the results as JSON, to the file given as
+// the first argument or to the standard output. Further arguments select the
+// scenes to run by name.
+
+// ----- std -----
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// ----- libraries -----
+#include <glm/glm.hpp>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Pipelines/PipelineCache.hpp>
+#include <Renderer/Vulkan/Renderer.hpp>
+#include <Window/HeadlessWindow.hpp>
+#include <Window/HeadlessWindowService.hpp>
+#include <configuration.hpp>
+#include "common.hpp"
+
+namespace {
+constexpr unsigned int Width = 1280;
+constexpr unsigned int Height = 720;
+
+// Not part of the timings, pipelines and textures settle in
+constexpr unsigned int WarmupFrames = 10;
+
+const std::vector<std::string> TextureFiles = {"chalet.jpg", "chalet_bw.jpg"};
+
+struct Frame {
+    unsigned int index;
+    Vulkan::Renderer& renderer;
+    HeadlessWindow& window;
+};
+
+struct Scene {
+    std::string name;
+    unsigned int drawable_count;
+    unsigned int texture_count;
+    unsigned int frame_count;
+    // Called before every frame is rendered, may be empty
+    std::function<void(const Frame&)> script;
+    // Compiled as a pipeline variant while the scene already renders
+    bool alpha_test = false;
+};
+
+// The camera circles the origin once every 240 frames
+void OrbitCamera(const Frame& frame) {
+    const auto angle = glm::radians(1.5f * frame.index);
+    const glm::vec3 position(4.0f * std::cos(angle), 4.0f * std::sin(angle),
+                             2.0f);
+    frame.renderer.set_camera(position, glm::vec3(0.0f));
+}
+
+// Changes the size every 5 frames, recreating the swapchain each time
+void ResizeStorm(const Frame& frame) {
+    const std::vector<std::pair<unsigned int, unsigned int>> sizes = {
+        {Width, Height}, {800, 600}, {1920, 1080}, {640, 360}};
+    if (frame.index == 0 || frame.index % 5 != 0) {
+        return;
+    }
+
+    const auto [width, height] = sizes[frame.index / 5 % sizes.size()];
+    frame.window.resize(width, height);
+    frame.renderer.resized(static_cast<int>(width), static_cast<int>(height));
+}
+
+// Loads and uploads 4 textures every 10 frames, and puts them to use
+void AssetLoadStorm(const Frame& frame) {
+    if (frame.index % 10 != 0) {
+        return;
+    }
+
+    for (auto i = 0u; i < 4; ++i) {
+        const auto texture = frame.renderer.load_texture(
+            TextureFiles[(frame.index / 10 + i) % TextureFiles.size()]);
+        frame.renderer.set_texture(
+            (frame.index / 10 * 4 + i) % frame.renderer.drawable_count(),
+            texture);
+    }
+}
+
+const std::vector<Scene> Scenes = {
+    {"static", 16, 2, 300, {}},
+    {"many_drawables", 1000, 2, 300, {}},
+    {"many_textures", 256, 64, 300, {}},
+    {"camera_orbit", 64, 8, 480, OrbitCamera},
+    {"resize_storm", 16, 2, 200, ResizeStorm},
+    {"asset_load_storm", 16, 2, 200, AssetLoadStorm},
+    {"alpha_test", 16, 2, 200, {}, true},
+};
+
+SceneDescription Describe(const Scene& scene) {
+    SceneDescription description;
+    description.textures.clear();
+    for (auto i = 0u; i < scene.texture_count; ++i) {
+        description.textures.push_back(TextureFiles[i % TextureFiles.size()]);
+    }
+    description.drawable_textures.clear();
+    for (auto i = 0u; i < scene.drawable_count; ++i) {
+        description.drawable_textures.push_back(i % scene.texture_count);
+    }
+    description.alternate_textures = false;
+    description.alpha_test = scene.alpha_test;
+    return description;
+}
+
+void WriteTimings(std::ostream& out, const std::vector<double>& samples) {
+    const auto sum = std::accumulate(samples.begin(), samples.end(), 0.0);
+    out << "{\"mean\": " << (samples.empty() ? 0.0 : sum / samples.size())
+        << ", \"p50\": " << Benchmark::Percentile(samples, 50.0)
+        << ", \"p90\": " << Benchmark::Percentile(samples, 90.0)
+        << ", \"p99\": " << Benchmark::Percentile(samples, 99.0)
+        << ", \"max\": " << Benchmark::Percentile(samples, 100.0) << "}";
+}
+
+void Run(const Scene& scene, std::ostream& out) {
+    HeadlessWindowService service(scene.frame_count);
+    service.setup(IWindowService::RendererType::Vulkan);
+    auto window = std::static_pointer_cast<HeadlessWindow>(
+        service.spawn_window(Width, Height, scene.name));
+
+    Vulkan::Renderer renderer(service, window, Configuration::FramesInFlight,
+                              Describe(scene));
+    renderer.initialize();
+    const auto initial_upload = renderer.uploaded_size();
+
+    std::vector<double> frame_times;
+    std::vector<double> submit_times;
+    for (auto index = 0u; !window->should_close(); ++index) {
+        if (scene.script) {
+            scene.script({index, renderer, *window});
+        }
+
+        service.pre_render_hook();
+        const auto start = std::chrono::steady_clock::now();
+        renderer.render(index * Configuration::HeadlessFrameTime);
+        const auto end = std::chrono::steady_clock::now();
+        service.post_render_hook();
+
+        // Frames skipped for a swapchain recreation submit nothing
+        if (index < WarmupFrames || renderer.last_submit() < start) {
+            continue;
+        }
+        frame_times.push_back(
+            std::chrono::duration<double, std::milli>(end - start).count());
+        submit_times.push_back(std::chrono::duration<double, std::milli>(
+                                   renderer.last_submit() - start)
+                                   .count());
+    }
+
+    const auto statistics = renderer.allocator_statistics();
+    out << "    {\"name\": \"" << scene.name
+        << "\", \"frames\": " << scene.frame_count
+        << ", \"drawables\": " << scene.drawable_count
+        << ", \"textures\": " << renderer.texture_count() << ",\n"
+        << "     \"cpu_frame_ms\": ";
+    WriteTimings(out, frame_times);
+    out << ",\n     \"submit_ms\": ";
+    WriteTimings(out, submit_times);
+    out << ",\n     \"upload_bytes\": {\"initial\": " << initial_upload
+        << ", \"frames\": " << renderer.uploaded_size() - initial_upload
+        << "},\n"
+        << "     \"relocated_bytes\": " << renderer.relocated_size() << ",\n";
+    // Scenes after the first one start from the cache the previous one saved
+    const auto& pipeline_cache = renderer.logical_device().pipeline_cache();
+    out << "     \"pipelines\": {\"warm\": "
+        << (pipeline_cache.warm() ? "true" : "false")
+        << ", \"created\": " << pipeline_cache.pipelines_created()
+        << ", \"creation_ms\": "
+        << std::chrono::duration<double, std::milli>(
+               pipeline_cache.creation_time())
+               .count()
+        << "},\n"
+        << "     \"allocator\": ";
+    Vulkan::Memory::WriteJson(out, statistics);
+    out << ",\n     \"gpu_ms\": {";
+    // Rolling, so only the last frames of the scene
+    auto first = true;
+    for (const auto& [label, timing] :
+         renderer.gpu_profiler().statistics()) {
+        out << (first ? "" : ", ") << "\"" << label
+            << "\": {\"min\": " << timing.min
+            << ", \"mean\": " << timing.average << ", \"p99\": " << timing.p99
+            << "}";
+        first = false;
+    }
+    out << "}}";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::ofstream file;
+    if (argc > 1) {
+        file.open(argv[1]);
+        if (!file) {
+            std::cerr << "Could not open " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+    auto& out = file.is_open() ? static_cast<std::ostream&>(file) : std::cout;
+
+    const std::vector<std::string> selected(argv + std::min(argc, 2),
+                                            argv + argc);
+
+    out << "{\"frames_in_flight\": " << Configuration::FramesInFlight
+        << ", \"frame_time_ms\": " << Configuration::HeadlessFrameTime
+        << ", \"warmup_frames\": " << WarmupFrames << ",\n"
+        << " \"scenes\": [\n";
+    auto first = true;
+    for (const auto& scene : Scenes) {
+        if (!selected.empty() &&
+            std::find(selected.begin(), selected.end(), scene.name) ==
+                selected.end()) {
+            continue;
+        }
+
+        std::cerr << "Running " << scene.name << std::endl;
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+        Run(scene, out);
+    }
+    out << "\n]}" << std::endl;
+
+    return 0;
+}
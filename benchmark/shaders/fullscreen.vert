@@ -0,0 +1,10 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) out vec2 frag_tex;
+
+// A single triangle covering the whole viewport, without vertex buffers
+void main() {
+    frag_tex = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(frag_tex * 2.0 - 1.0, 0.0, 1.0);
+}
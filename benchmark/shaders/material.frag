@@ -0,0 +1,48 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Compiled twice: with SPECIALIZED defined the features are specialization
+// constants laid out as MaterialSpecialization, otherwise the same struct is
+// read from push constants and branched on per fragment.
+#ifdef SPECIALIZED
+layout(constant_id = 0) const bool alpha_test = false;
+layout(constant_id = 1) const bool vertex_color = false;
+layout(constant_id = 2) const uint texture_count = 1;
+#else
+layout(push_constant) uniform Features {
+    bool alpha_test;
+    bool vertex_color;
+    uint texture_count;
+} features;
+
+#define alpha_test features.alpha_test
+#define vertex_color features.vertex_color
+#define texture_count features.texture_count
+#endif
+
+const float alpha_cutoff = 0.5;
+
+layout(location = 0) in vec2 frag_tex;
+
+layout(location = 0) out vec4 out_color;
+
+// Stands in for a texture fetch, so the benchmark needs no image data
+vec4 layer(uint index, vec2 uv) {
+    vec2 p = uv * float(4 + 3 * index);
+    return vec4(0.5 + 0.5 * sin(p.x * 6.2831), 0.5 + 0.5 * cos(p.y * 6.2831),
+                fract(p.x * p.y), 0.75 + 0.25 * sin(p.x + p.y));
+}
+
+void main() {
+    vec4 color = vec4(1.0);
+    for (uint i = 0; i < texture_count; ++i) {
+        color *= layer(i, frag_tex);
+    }
+    if (vertex_color) {
+        color.rgb *= vec3(frag_tex, 1.0);
+    }
+    if (alpha_test && color.a < alpha_cutoff) {
+        discard;
+    }
+    out_color = color;
+}
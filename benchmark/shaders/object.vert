@@ -0,0 +1,33 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Compiled once per ObjectDataStrategy: with PUSH_CONSTANTS or STORAGE_BUFFER
+// defined the model matrix is taken like the engine's matching vertex shader,
+// otherwise from a uniform buffer bound at a dynamic offset.
+#if defined(PUSH_CONSTANTS)
+layout(push_constant) uniform Object {
+    mat4 model;
+} object;
+
+#define model object.model
+#elif defined(STORAGE_BUFFER)
+layout(std430, set = 0, binding = 0) readonly buffer Objects {
+    mat4 models[];
+} objects;
+
+#define model objects.models[gl_InstanceIndex]
+#else
+layout(set = 0, binding = 0) uniform Object {
+    mat4 model;
+} object;
+
+#define model object.model
+#endif
+
+// A small triangle around the origin of the object, without vertex buffers
+const vec2 corners[3] = vec2[](vec2(-0.01, -0.01), vec2(0.01, -0.01),
+                               vec2(0.0, 0.01));
+
+void main() {
+    gl_Position = model * vec4(corners[gl_VertexIndex], 0.0, 1.0);
+}
@@ -0,0 +1,141 @@
+//
+// Created by Dániel Molnár on 2019-10-31.
+//
+
+// Compares the GPU time of the material fragment shader when its features
+// are branched on at runtime, and when they are compiled in as
+// specialization constants.
+
+// ----- std -----
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Data/Representation.hpp>
+#include <Renderer/Vulkan/Shaders/SpecializationConstants.hpp>
+#include "common.hpp"
+
+namespace {
+constexpr std::uint32_t Width = 1024;
+constexpr std::uint32_t Height = 1024;
+
+// Fullscreen triangles per sample, and samples per variant
+constexpr unsigned int DrawCount = 16;
+constexpr unsigned int SampleCount = 10;
+
+std::vector<MaterialSpecialization> Variants() {
+    std::vector<MaterialSpecialization> variants;
+    for (const auto texture_count : {1u, 2u, 4u}) {
+        for (const auto vertex_color : {VK_FALSE, VK_TRUE}) {
+            for (const auto alpha_test : {VK_FALSE, VK_TRUE}) {
+                MaterialSpecialization variant;
+                variant.alpha_test = alpha_test;
+                variant.vertex_color = vertex_color;
+                variant.texture_count = texture_count;
+                variants.push_back(variant);
+            }
+        }
+    }
+    return variants;
+}
+
+// Median GPU time of the draws, the features are pushed when given
+double Measure(const Benchmark::Context& context,
+               const Benchmark::RenderTarget& target,
+               const Benchmark::GpuTimer& timer, VkPipeline pipeline,
+               VkPipelineLayout layout,
+               const MaterialSpecialization* features) {
+    std::vector<double> samples;
+    for (auto i = 0u; i < SampleCount; ++i) {
+        context.submit([&](VkCommandBuffer command_buffer) {
+            timer.begin(command_buffer);
+            target.begin(command_buffer);
+
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              pipeline);
+            if (features != nullptr) {
+                vkCmdPushConstants(command_buffer, layout,
+                                   VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                   sizeof(MaterialSpecialization), features);
+            }
+            for (auto draw = 0u; draw < DrawCount; ++draw) {
+                vkCmdDraw(command_buffer, 3, 1, 0, 0);
+            }
+
+            target.end(command_buffer);
+            timer.end(command_buffer);
+        });
+        samples.push_back(timer.milliseconds());
+    }
+    return Benchmark::Median(samples);
+}
+}  // namespace
+
+int main() {
+    Benchmark::Context context;
+    Benchmark::RenderTarget target(context, Width, Height);
+    Benchmark::GpuTimer timer(context);
+
+    const auto device = context.device();
+    const auto vertex_shader = context.load_shader("fullscreen_vert.spv");
+    const auto branchy_shader = context.load_shader("material_branchy.spv");
+    const auto specialized_shader =
+        context.load_shader("material_specialized.spv");
+
+    VkPushConstantRange features_range = {};
+    features_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    features_range.size = sizeof(MaterialSpecialization);
+
+    VkPipelineLayoutCreateInfo layout_info = {};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.pushConstantRangeCount = 1;
+    layout_info.pPushConstantRanges = &features_range;
+
+    VkPipelineLayout layout;
+    Benchmark::Check(
+        vkCreatePipelineLayout(device, &layout_info, nullptr, &layout),
+        "create pipeline layout");
+
+    // One pipeline serves every variant when branching
+    const auto branchy_pipeline = Benchmark::CreatePipeline(
+        context, target, vertex_shader, branchy_shader, layout);
+
+    std::cout << std::setw(8) << "textures" << std::setw(8) << "color"
+              << std::setw(8) << "alpha" << std::setw(14) << "branchy ms"
+              << std::setw(14) << "special. ms" << std::setw(10) << "speedup"
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (const auto& variant : Variants()) {
+        const auto constants =
+            Vulkan::SpecializationConstants::From(variant);
+        const auto info = constants.info();
+        const auto specialized_pipeline = Benchmark::CreatePipeline(
+            context, target, vertex_shader, specialized_shader, layout, &info);
+
+        const auto branchy = Measure(context, target, timer, branchy_pipeline,
+                                     layout, &variant);
+        const auto specialized = Measure(context, target, timer,
+                                         specialized_pipeline, layout, nullptr);
+
+        std::cout << std::setw(8) << variant.texture_count << std::setw(8)
+                  << (variant.vertex_color ? "on" : "off") << std::setw(8)
+                  << (variant.alpha_test ? "on" : "off") << std::setw(14)
+                  << branchy << std::setw(14) << specialized << std::setw(10)
+                  << branchy / specialized << std::endl;
+
+        vkDestroyPipeline(device, specialized_pipeline, nullptr);
+    }
+
+    vkDestroyPipeline(device, branchy_pipeline, nullptr);
+    vkDestroyPipelineLayout(device, layout, nullptr);
+    vkDestroyShaderModule(device, specialized_shader, nullptr);
+    vkDestroyShaderModule(device, branchy_shader, nullptr);
+    vkDestroyShaderModule(device, vertex_shader, nullptr);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+//
+// Created by Dániel Molnár on 2019-11-12.
+//
+
+// Declares the render targets of a deferred frame on transient attachments,
+// through the device of a headless renderer, creates them at a few extents and
+// writes the memory taken with and without aliasing as JSON, to the file given
+// as the first argument or to the standard output.
+// The G-buffer is done with before bloom starts, so the bloom and tonemapped
+// targets have to share memory with it. Fails when nothing was aliased.
+
+// ----- std -----
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Renderer.hpp>
+#include <Renderer/Vulkan/TransientAttachments.hpp>
+#include <Renderer/Vulkan/Utils.hpp>
+#include <Window/HeadlessWindow.hpp>
+#include <Window/HeadlessWindowService.hpp>
+#include "common.hpp"
+
+namespace {
+const std::vector<VkExtent2D> Extents = {
+    {1280, 720}, {1920, 1080}, {3840, 2160}};
+
+// Sampled by the following passes, so none of them is created transient
+constexpr VkImageUsageFlags ColorUsage =
+    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+constexpr VkImageUsageFlags DepthUsage =
+    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+void Declare(Vulkan::TransientAttachments& attachments,
+             const Vulkan::PhysicalDevice& physical_device) {
+    const auto depth_format = Vulkan::Utils::FindDepthFormat(physical_device);
+    attachments.declare("Depth", depth_format, DepthUsage, "GBuffer",
+                        "Lighting");
+    attachments.declare("Albedo", VK_FORMAT_R8G8B8A8_UNORM, ColorUsage,
+                        "GBuffer", "Lighting");
+    attachments.declare("Normal", VK_FORMAT_R16G16B16A16_SFLOAT, ColorUsage,
+                        "GBuffer", "Lighting");
+    attachments.declare("HDR", VK_FORMAT_R16G16B16A16_SFLOAT, ColorUsage,
+                        "Lighting", "Bloom");
+    attachments.declare("Bloom", VK_FORMAT_R16G16B16A16_SFLOAT, ColorUsage,
+                        "Bloom", "Tonemap");
+    attachments.declare("LDR", VK_FORMAT_R8G8B8A8_UNORM, ColorUsage,
+                        "Tonemap", "Tonemap");
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::ofstream file;
+    if (argc > 1) {
+        file.open(argv[1]);
+        if (!file) {
+            std::cerr << "Could not open " << argv[1] << std::endl;
+            return 1;
+        }
+    }
+    auto& out = file.is_open() ? static_cast<std::ostream&>(file) : std::cout;
+
+    HeadlessWindowService service(1);
+    service.setup(IWindowService::RendererType::Vulkan);
+    auto window = std::static_pointer_cast<HeadlessWindow>(
+        service.spawn_window(64, 64, "transient_attachments"));
+    Vulkan::Renderer renderer(service, window);
+
+    Vulkan::TransientAttachments attachments(
+        renderer.physical_device(), renderer.logical_device(),
+        {"GBuffer", "Lighting", "Bloom", "Tonemap"});
+    Declare(attachments, renderer.physical_device());
+
+    auto aliased = true;
+    out << "{\"results\": [\n";
+    for (auto i = 0u; i < Extents.size(); ++i) {
+        const auto extent = Extents[i];
+        attachments.create(extent);
+
+        const auto size = attachments.size();
+        const auto unaliased_size = attachments.unaliased_size();
+        if (size >= unaliased_size) {
+            std::cerr << "No attachments share memory at " << extent.width
+                      << "x" << extent.height << std::endl;
+            aliased = false;
+        }
+
+        out << "    {\"width\": " << extent.width
+            << ", \"height\": " << extent.height
+            << ", \"aliased_bytes\": " << size
+            << ", \"unaliased_bytes\": " << unaliased_size << "}"
+            << (i + 1 < Extents.size() ? ",\n" : "\n");
+    }
+    out << "]}" << std::endl;
+
+    return aliased ? 0 : 1;
+}
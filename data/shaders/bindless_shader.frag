@@ -0,0 +1,20 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+// Placed after the model matrix the vertex stage may push, see
+// MaterialPushConstants
+layout(push_constant) uniform Material {
+    layout(offset = 64) uint texture_index;
+} material;
+
+layout(location = 0) in vec3 frag_color;
+layout(location = 1) in vec2 frag_tex;
+
+layout(location = 0) out vec4 out_color;
+
+void main() {
+    out_color = texture(textures[material.texture_index], frag_tex);
+}
@@ -1,7 +1,7 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(binding = 1) uniform sampler2D texture_sampler;
+layout(set = 1, binding = 0) uniform sampler2D texture_sampler;
 
 layout(location = 0) in vec3 frag_color;
 layout(location = 1) in vec2 frag_tex;
@@ -1,6 +1,14 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+// Material features, see MaterialSpecialization. Untextured materials have
+// a texture count of 0, the material set still holds a texture for them.
+layout(constant_id = 0) const bool alpha_test = false;
+layout(constant_id = 1) const bool vertex_color = false;
+layout(constant_id = 2) const uint texture_count = 1;
+
+const float alpha_cutoff = 0.5;
+
 layout(set = 1, binding = 0) uniform sampler2D texture_sampler;
 
 layout(location = 0) in vec3 frag_color;
@@ -9,5 +17,15 @@ layout(location = 1) in vec2 frag_tex;
 layout(location = 0) out vec4 out_color;
 
 void main() {
-    out_color = texture(texture_sampler, frag_tex);
+    vec4 color = vec4(1.0);
+    if (texture_count > 0) {
+        color = texture(texture_sampler, frag_tex);
+    }
+    if (vertex_color) {
+        color.rgb *= frag_color;
+    }
+    if (alpha_test && color.a < alpha_cutoff) {
+        discard;
+    }
+    out_color = color;
 }
@@ -6,12 +6,10 @@ layout(set = 0, binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
+// ObjectDataStrategy::DynamicUniformBuffer, bound at the offset of the object
 layout(set = 0, binding = 1) uniform Object {
     mat4 model;
 } object;
-//layout(push_constant) uniform PushConsts {
-//    mat4 obj_model;
-//} push_consts;
 
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 color;
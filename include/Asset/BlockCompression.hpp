@@ -0,0 +1,64 @@
+//
+// Created by Dániel Molnár on 2019-10-20.
+//
+
+#pragma once
+#ifndef VULKANENGINE_BLOCKCOMPRESSION_HPP
+#define VULKANENGINE_BLOCKCOMPRESSION_HPP
+
+// ----- std -----
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+
+namespace Asset {
+enum class TextureFormat { R8G8B8A8, BC1, BC3, BC5, BC7 };
+
+namespace BlockCompression {
+// Bump whenever the encoder output changes, it invalidates cached results.
+constexpr const unsigned int EncoderVersion = 1;
+constexpr const unsigned int BlockDimension = 4;
+
+[[nodiscard]] constexpr bool IsCompressed(TextureFormat format) {
+    return format != TextureFormat::R8G8B8A8;
+}
+
+// Bytes per 4x4 block, or per texel for uncompressed formats.
+[[nodiscard]] constexpr unsigned int BlockBytes(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R8G8B8A8:
+            return 4;
+        case TextureFormat::BC1:
+            return 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC5:
+        case TextureFormat::BC7:
+            return 16;
+    }
+    return 0;
+}
+
+[[nodiscard]] size_t LevelSize(TextureFormat format, unsigned int width,
+                               unsigned int height);
+
+// Each encoder takes a 4x4 block of RGBA8 texels in row-major order.
+void EncodeBC1(const std::uint8_t* texels, std::uint8_t* out);
+void EncodeBC3(const std::uint8_t* texels, std::uint8_t* out);
+void EncodeBC5(const std::uint8_t* texels, std::uint8_t* out);
+void EncodeBC7(const std::uint8_t* texels, std::uint8_t* out);
+
+// Compresses a whole RGBA8 image, splitting the block rows between
+// thread_count workers (0 means one per hardware thread).
+std::vector<std::byte> Compress(const std::byte* rgba, unsigned int width,
+                                unsigned int height, TextureFormat format,
+                                unsigned int thread_count = 0);
+}  // namespace BlockCompression
+}  // namespace Asset
+
+#endif  // VULKANENGINE_BLOCKCOMPRESSION_HPP
@@ -14,6 +14,8 @@
 // ----- in-project dependencies -----
 #include <Asset/Image.hpp>
 #include <Asset/Mesh.hpp>
+#include <Asset/Texture.hpp>
+#include <configuration.hpp>
 
 // ----- forward-decl -----
 namespace Asset {
@@ -22,17 +24,25 @@ class Manager {
     static ID counter;
 
     Core::FileManager _file_manager;
+    Core::FileManager::Path _cache_directory;
 
     std::map<ID, std::unique_ptr<Resource>> _resources;
 
    public:
-    explicit Manager(std::vector<Core::FileManager::Path> search_paths);
+    explicit Manager(std::vector<Core::FileManager::Path> search_paths,
+                     Core::FileManager::Path cache_directory =
+                         Configuration::TextureCacheDirectory);
 
     std::optional<std::reference_wrapper<const Image>> load_image(
         const std::string& name);
 
     std::optional<std::reference_wrapper<const Mesh>> load_mesh(
         const std::string& name);
+
+    // Compressed formats are encoded at load time unless the file is a
+    // KTX2/DDS container, which is loaded in its own format.
+    std::optional<std::reference_wrapper<const Texture>> load_texture(
+        const std::string& name, TextureFormat format);
 };
 }  // namespace Asset
 
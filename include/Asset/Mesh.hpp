@@ -26,6 +26,7 @@ class Mesh : public Resource {
     std::string _file_name;
     bool _has_colors;
     bool _has_texture_coords;
+    float _bounding_radius = 0.0f;
     Vertices _vertices;
     Indices _indices;
    public:
@@ -46,6 +47,9 @@ class Mesh : public Resource {
     [[nodiscard]] size_t index_data_size() const {
         return _indices.size() * sizeof(decltype(_indices)::value_type);
     }
+
+    // Radius of the bounding sphere around the model space origin
+    [[nodiscard]] float bounding_radius() const { return _bounding_radius; }
 };
 }
 
@@ -0,0 +1,61 @@
+//
+// Created by Dániel Molnár on 2019-10-20.
+//
+
+#pragma once
+#ifndef VULKANENGINE_ASSET_TEXTURE_HPP
+#define VULKANENGINE_ASSET_TEXTURE_HPP
+
+// ----- std -----
+#include <filesystem>
+#include <string>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+#include <Asset/BlockCompression.hpp>
+#include <Asset/Resource.hpp>
+#include <Asset/TextureContainer.hpp>
+
+// ----- forward-decl -----
+
+namespace Asset {
+// A texture with its full mip chain, ready to be uploaded as is.
+// KTX2 and DDS files are loaded verbatim, any other image is decoded, mip
+// mapped and encoded to the requested format. Encoded results are cached in
+// cache_directory keyed by the hash of the source texels.
+class Texture : public Resource {
+   private:
+    std::string _file_name;
+    TextureData _texture;
+
+    void encode(TextureFormat format,
+                const std::filesystem::path& cache_directory);
+
+   public:
+    Texture(ID id, std::string file_name, TextureFormat format,
+            const std::filesystem::path& cache_directory);
+    ~Texture() override = default;
+
+    [[nodiscard]] TextureFormat format() const { return _texture.format; }
+    [[nodiscard]] bool srgb() const { return _texture.srgb; }
+
+    [[nodiscard]] const std::vector<MipLevel>& levels() const {
+        return _texture.levels;
+    }
+
+    [[nodiscard]] const std::byte* data() const {
+        return _texture.data.data();
+    }
+    [[nodiscard]] size_t size() const { return _texture.data.size(); }
+
+    [[nodiscard]] unsigned int width() const {
+        return _texture.levels.front().width;
+    }
+    [[nodiscard]] unsigned int height() const {
+        return _texture.levels.front().height;
+    }
+};
+}  // namespace Asset
+
+#endif  // VULKANENGINE_ASSET_TEXTURE_HPP
@@ -0,0 +1,47 @@
+//
+// Created by Dániel Molnár on 2019-10-20.
+//
+
+#pragma once
+#ifndef VULKANENGINE_TEXTURECONTAINER_HPP
+#define VULKANENGINE_TEXTURECONTAINER_HPP
+
+// ----- std -----
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+#include <Asset/BlockCompression.hpp>
+
+// ----- forward-decl -----
+
+namespace Asset {
+struct MipLevel {
+    unsigned int width;
+    unsigned int height;
+    size_t offset;
+    size_t size;
+};
+
+// Texel data of a whole mip chain, levels are stored largest first.
+struct TextureData {
+    TextureFormat format = TextureFormat::R8G8B8A8;
+    bool srgb = false;
+    std::vector<MipLevel> levels;
+    std::vector<std::byte> data;
+};
+
+namespace TextureContainer {
+[[nodiscard]] std::optional<TextureData> ReadKTX2(
+    const std::vector<std::byte>& file);
+[[nodiscard]] std::optional<TextureData> ReadDDS(
+    const std::vector<std::byte>& file);
+
+[[nodiscard]] std::vector<std::byte> WriteDDS(const TextureData& texture);
+}  // namespace TextureContainer
+}  // namespace Asset
+
+#endif  // VULKANENGINE_TEXTURECONTAINER_HPP
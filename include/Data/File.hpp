@@ -0,0 +1,77 @@
+//
+// Created by Dániel Molnár on 2019-11-12.
+//
+
+#pragma once
+#ifndef VULKANENGINE_FILE_HPP
+#define VULKANENGINE_FILE_HPP
+
+// ----- std -----
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+
+// ----- forward decl -----
+
+// Binary files of the on-disk caches: compressed textures, pipeline cache data
+// and compiled shaders.
+namespace File {
+// std::nullopt when the file does not exist or could not be read
+inline std::optional<std::vector<std::byte>> Read(
+    const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) return std::nullopt;
+
+    std::vector<std::byte> content(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+    if (!stream.read(reinterpret_cast<char*>(content.data()), content.size())) {
+        return std::nullopt;
+    }
+    return content;
+}
+
+// Next to the file, unique to the calling thread. A file written here and
+// moved in place is never seen torn, not even with several writers.
+inline std::filesystem::path Temporary(const std::filesystem::path& path) {
+    auto temporary = path;
+    temporary += ".tmp" + std::to_string(std::hash<std::thread::id>()(
+                              std::this_thread::get_id()));
+    return temporary;
+}
+
+// Through a temporary, creating the missing directories. Returns whether the
+// file was written.
+inline bool Write(const std::filesystem::path& path,
+                  const std::vector<std::byte>& content) {
+    std::error_code error;
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+        if (error) return false;
+    }
+
+    const auto temporary = Temporary(path);
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(content.data()),
+                     content.size());
+        if (!stream) {
+            stream.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+}  // namespace File
+
+#endif  // VULKANENGINE_FILE_HPP
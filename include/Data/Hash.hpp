@@ -0,0 +1,48 @@
+//
+// Created by Dániel Molnár on 2019-10-20.
+//
+
+#pragma once
+#ifndef VULKANENGINE_HASH_HPP
+#define VULKANENGINE_HASH_HPP
+
+// ----- std -----
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+
+// ----- forward decl -----
+
+namespace Hash {
+constexpr const std::uint64_t FNV1aOffsetBasis = 14695981039346656037ull;
+constexpr const std::uint64_t FNV1aPrime = 1099511628211ull;
+
+// Stable across runs and platforms, so it can be used to key on-disk caches.
+inline std::uint64_t FNV1a(const void* data, size_t size,
+                           std::uint64_t seed = FNV1aOffsetBasis) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    auto hash = seed;
+    for (auto i = 0ul; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV1aPrime;
+    }
+    return hash;
+}
+
+template <class T>
+std::uint64_t FNV1a(const T& value, std::uint64_t seed = FNV1aOffsetBasis) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable values can be hashed bytewise");
+    return FNV1a(&value, sizeof(T), seed);
+}
+
+inline std::uint64_t Combine(std::uint64_t seed, std::uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+}  // namespace Hash
+
+#endif  // VULKANENGINE_HASH_HPP
@@ -78,6 +78,15 @@ struct Vertex {
 using Vertices = std::vector<Vertex>;
 using Indices = std::vector<uint32_t>;
 
+// Packed data of the descriptor update template of the scene set
+struct SceneDescriptors {
+    VkDescriptorBufferInfo camera;
+    VkDescriptorBufferInfo model;
+
+    static constexpr std::array<VkDescriptorUpdateTemplateEntry, 2>
+    update_template_entries();
+};
+
 struct UniformBufferObject {
     glm::mat4 view;
     glm::mat4 proj;
@@ -105,6 +114,23 @@ constexpr VkDescriptorSetLayoutBinding Model_descriptor() {
     return layout_binding;
 }
 
+constexpr std::array<VkDescriptorUpdateTemplateEntry, 2>
+SceneDescriptors::update_template_entries() {
+    std::array<VkDescriptorUpdateTemplateEntry, 2> entries = {};
+    entries[0].dstBinding = UniformBufferObject::binding_descriptor().binding;
+    entries[0].descriptorType =
+        UniformBufferObject::binding_descriptor().descriptorType;
+    entries[0].descriptorCount = 1;
+    entries[0].offset = offsetof(SceneDescriptors, camera);
+
+    entries[1].dstBinding = Model_descriptor().binding;
+    entries[1].descriptorType = Model_descriptor().descriptorType;
+    entries[1].descriptorCount = 1;
+    entries[1].offset = offsetof(SceneDescriptors, model);
+
+    return entries;
+}
+
 constexpr VkDescriptorSetLayoutBinding Texture_sampler_descriptor() {
     VkDescriptorSetLayoutBinding layout_binding = {};
     layout_binding.binding = 0;
@@ -116,4 +142,61 @@ constexpr VkDescriptorSetLayoutBinding Texture_sampler_descriptor() {
     return layout_binding;
 }
 
+constexpr VkDescriptorSetLayoutBinding Bindless_texture_descriptor(
+    unsigned int count) {
+    VkDescriptorSetLayoutBinding layout_binding = {};
+    layout_binding.binding = 0;
+    layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    layout_binding.descriptorCount = count;
+    layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    layout_binding.pImmutableSamplers = nullptr;
+
+    return layout_binding;
+}
+
+// Placed after the model matrix, which the vertex stage may take from push
+// constants as well
+struct MaterialPushConstants {
+    static constexpr uint32_t Offset = sizeof(glm::mat4);
+
+    uint32_t texture_index;
+
+    static constexpr VkPushConstantRange range() {
+        VkPushConstantRange push_constant_range = {};
+        push_constant_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        push_constant_range.offset = Offset;
+        push_constant_range.size = sizeof(MaterialPushConstants);
+
+        return push_constant_range;
+    }
+};
+
+// Material features of the scene fragment shader, compiled into the pipeline
+// as specialization constants instead of being branched on per fragment
+struct MaterialSpecialization {
+    VkBool32 alpha_test = VK_FALSE;
+    VkBool32 vertex_color = VK_FALSE;
+    uint32_t texture_count = 1;
+
+    static constexpr std::array<VkSpecializationMapEntry, 3> Entries();
+};
+
+constexpr std::array<VkSpecializationMapEntry, 3>
+MaterialSpecialization::Entries() {
+    std::array<VkSpecializationMapEntry, 3> entries = {};
+    entries[0].constantID = 0;
+    entries[0].offset = offsetof(MaterialSpecialization, alpha_test);
+    entries[0].size = sizeof(VkBool32);
+
+    entries[1].constantID = 1;
+    entries[1].offset = offsetof(MaterialSpecialization, vertex_color);
+    entries[1].size = sizeof(VkBool32);
+
+    entries[2].constantID = 2;
+    entries[2].offset = offsetof(MaterialSpecialization, texture_count);
+    entries[2].size = sizeof(uint32_t);
+
+    return entries;
+}
+
 #endif  // VULKANENGINE_REPRESENTATION_HPP
@@ -0,0 +1,103 @@
+//
+// Created by Dániel Molnár on 2019-11-07.
+//
+
+#pragma once
+#ifndef VULKANENGINE_TRACE_HPP
+#define VULKANENGINE_TRACE_HPP
+
+// ----- std -----
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+#include <configuration.hpp>
+
+// ----- forward-decl -----
+
+// CPU instrumentation written in the Chrome trace event format, loadable in
+// chrome://tracing and Perfetto. Every thread records into its own ring
+// buffer, so recording takes no lock other threads contend for, and only the
+// latest events are kept. Names are not copied, they have to outlive the
+// trace, string literals are expected.
+// Nothing is recorded until Start is called, and without
+// Configuration::Tracing the instrumentation compiles to nothing.
+namespace Profiling {
+using Clock = std::chrono::steady_clock;
+
+namespace Detail {
+inline std::atomic<bool> recording = false;
+
+void RecordZone(const char* name, Clock::time_point start,
+                Clock::time_point end);
+}  // namespace Detail
+
+// Clears the buffers of every thread, and keeps at most events_per_thread
+// events for each from now on
+void Start(
+    std::size_t events_per_thread = Configuration::TraceEventsPerThread);
+void Stop();
+
+[[nodiscard]] inline bool Recording() {
+    if constexpr (Configuration::Tracing) {
+        return Detail::recording.load(std::memory_order_relaxed);
+    } else {
+        return false;
+    }
+}
+
+// Writes the recorded events of all threads, throws std::runtime_error when
+// the file can not be written. Threads still recording are not waited for.
+void Write(const std::string& path);
+
+// Shown instead of the thread id, applies to the calling thread
+void SetThreadName(std::string name);
+
+void Counter(const char* name, double value);
+
+// Zone measured elsewhere, e.g. on the device, shown on a track of its own
+// instead of the calling thread
+void TrackZone(const char* track, const char* name, Clock::time_point start,
+               Clock::duration duration);
+
+// A flow connects the zones enclosing its begin and end, even across
+// threads. The returned id has to be passed to the end.
+[[nodiscard]] std::uint64_t BeginFlow(const char* name);
+void EndFlow(const char* name, std::uint64_t id);
+
+// Measures the scope it lives in
+class Zone {
+   private:
+    const char* _name;
+    Clock::time_point _start;
+
+   public:
+    explicit Zone(const char* name) : _name(name) {
+        if (Recording()) {
+            _start = Clock::now();
+        }
+    }
+
+    ~Zone() {
+        // Zones open when recording started are dropped
+        if (Recording() && _start != Clock::time_point()) {
+            Detail::RecordZone(_name, _start, Clock::now());
+        }
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+};
+}  // namespace Profiling
+
+#define PROFILING_CONCAT_IMPL(a, b) a##b
+#define PROFILING_CONCAT(a, b) PROFILING_CONCAT_IMPL(a, b)
+#define TRACE_ZONE(name) \
+    const ::Profiling::Zone PROFILING_CONCAT(trace_zone_, __LINE__)(name)
+
+#endif  // VULKANENGINE_TRACE_HPP
@@ -0,0 +1,51 @@
+//
+// Created by Dániel Molnár on 2019-11-04.
+//
+
+#pragma once
+#ifndef VULKANENGINE_FRAMEPACER_HPP
+#define VULKANENGINE_FRAMEPACER_HPP
+
+// ----- std -----
+#include <chrono>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+
+// Limits the frame rate of the main loop, and measures how old the input is
+// by the time the frame using it is submitted.
+class FramePacer {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+   private:
+    // Zero when the frame rate is not limited
+    Clock::duration _target_frame_time;
+    Clock::time_point _next_frame;
+
+    Clock::time_point _input_sampled;
+    Clock::duration _latency_sum = Clock::duration::zero();
+    Clock::duration _latency_max = Clock::duration::zero();
+    unsigned int _latency_samples = 0;
+
+   public:
+    explicit FramePacer(Clock::duration target_frame_time);
+
+    // Sleeps until the target frame time has passed since the previous frame
+    // started. A late frame moves the schedule instead of shortening the
+    // frames after it.
+    void limit();
+
+    void input_sampled();
+    void submitted(Clock::time_point submit_time);
+
+    // Over the frames since the last reset
+    [[nodiscard]] Clock::duration average_latency() const;
+    [[nodiscard]] Clock::duration max_latency() const { return _latency_max; }
+    void reset_latency();
+};
+
+#endif  // VULKANENGINE_FRAMEPACER_HPP
@@ -17,6 +17,9 @@ class IRenderer {
     virtual void initialize() = 0;
 
     virtual void resized(int width, int height) = 0;
+    // Blocks until the device can take another frame, render() does it too
+    // when it was not called before
+    virtual void wait_for_frame() = 0;
     virtual void render(uint64_t delta_time) = 0;
     virtual void shutdown() = 0;
 };
@@ -0,0 +1,37 @@
+//
+// Created by Dániel Molnár on 2019-11-06.
+//
+
+#pragma once
+#ifndef VULKANENGINE_SCENEDESCRIPTION_HPP
+#define VULKANENGINE_SCENEDESCRIPTION_HPP
+
+// ----- std -----
+#include <string>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+
+// What the renderer loads when it is constructed. The defaults are the demo
+// scene, the benchmarks script their own.
+struct SceneDescription {
+    std::string mesh = "chalet.obj";
+    // Every entry is loaded and uploaded separately, names may repeat
+    std::vector<std::string> textures = {"chalet.jpg", "chalet_bw.jpg"};
+    // One drawable of the mesh per entry, with the texture of that index
+    std::vector<unsigned int> drawable_textures = {0, 0, 1, 0};
+    // The drawable of this index switches between the first two textures
+    // every second
+    bool alternate_textures = true;
+    unsigned int alternating_drawable = 2;
+    // Discards texels below half alpha. The specialized pipeline is compiled
+    // in the background, the default one draws until it is ready. Ignored
+    // with bindless textures.
+    bool alpha_test = false;
+};
+
+#endif  // VULKANENGINE_SCENEDESCRIPTION_HPP
@@ -7,6 +7,7 @@
 #define VULKANENGINE_BUFFERS_HPP
 
 // ----- std -----
+#include <memory>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -39,7 +40,8 @@ struct SubBufferDescriptor {
 
 struct IndexBufferTag {
     static constexpr VkBufferUsageFlags Usage =
-        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     static constexpr VkSharingMode SharingMode = VK_SHARING_MODE_EXCLUSIVE;
     static constexpr VkMemoryPropertyFlags MemoryProperties =
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
@@ -47,7 +49,8 @@ struct IndexBufferTag {
 
 struct VertexBufferTag {
     static constexpr VkBufferUsageFlags Usage =
-        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     static constexpr VkSharingMode SharingMode = VK_SHARING_MODE_EXCLUSIVE;
     static constexpr VkMemoryPropertyFlags MemoryProperties =
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
@@ -97,18 +100,35 @@ class Buffer {
     [[nodiscard]] bool has_usage(VkBufferUsageFlagBits use) const {
         return _usage & use;
     }
+    // Null until allocated
+    [[nodiscard]] const Memory::Block* block() const { return _block; }
 
     void allocate();
     void transfer(void* data, unsigned int size,
                   unsigned int target_offset = 0);
     void transfer(void* data, const SubBufferDescriptor& desc);
+    // Only for host-visible buffers, the writes of the device have to be
+    // finished
+    void read(void* data, unsigned int size,
+              unsigned int source_offset = 0) const;
 
-    void copy_to(TempCommandBuffer& buffer, Buffer& dst,
+    void copy_to(VkCommandBuffer command_buffer, Buffer& dst,
                  const std::vector<SubBufferDescriptor>& src_descs,
                  const std::vector<SubBufferDescriptor>& dst_descs);
 
-    void copy_to(TempCommandBuffer& buffer, const SubBufferDescriptor& src_desc,
-                 Image& dst);
+    void copy_to(VkCommandBuffer command_buffer,
+                 const SubBufferDescriptor& src_desc, Image& dst);
+
+    // One descriptor per mip level, starting from the base level
+    void copy_to(VkCommandBuffer command_buffer,
+                 const std::vector<SubBufferDescriptor>& mip_descs, Image& dst);
+
+    // Records a copy of the contents to memory requested now, and takes it
+    // over, so the object (and everything pointing to it) is kept. The
+    // buffer needs transfer source usage. The returned buffer receives the
+    // previous memory, and has to live until the copy is finished.
+    [[nodiscard]] std::unique_ptr<Buffer> relocate(
+        VkCommandBuffer command_buffer);
 };
 
 class VertexBuffer : public Buffer {
@@ -157,10 +177,12 @@ class PolymorphBuffer : public Buffer {
                  FirstSubBuffer::MemoryProperties) {}
 
     template <class SubBufferTag>
-    SubBufferDescriptor commit_sub_buffer(VkDeviceSize size) {
+    SubBufferDescriptor commit_sub_buffer(VkDeviceSize size,
+                                          VkDeviceSize alignment = 1) {
         static_assert(Core::contains<SubBufferTag, SubBufferTags...>(),
                       "Invalid sub buffer tag");
 
+        _size = (_size + alignment - 1) / alignment * alignment;
         SubBufferDescriptor descriptor{SubBufferTag::Usage, size, _size};
         _usage |= SubBufferTag::Usage;
         _size += size;
@@ -199,6 +221,14 @@ class DynamicUniformBuffer : public Buffer {
     [[nodiscard]] SubBufferDescriptor acquire_slot();
 };
 
+// Host visible, written every frame like the uniform buffers
+class StorageBuffer : public Buffer {
+   public:
+    StorageBuffer(LogicalDevice& logical_device, VkDeviceSize buffer_size);
+
+    ~StorageBuffer() override = default;
+};
+
 }  // namespace Vulkan
 
 #endif  // VULKANENGINE_BUFFERS_HPP
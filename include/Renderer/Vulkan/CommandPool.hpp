@@ -43,6 +43,9 @@ class CommandPool {
 
     void allocate_buffers(unsigned int count);
     void free_buffers();
+    // Returns every buffer of the pool to the initial state, none of them may
+    // be pending execution
+    void reset() const;
 
     [[nodiscard]] TempCommandBuffer allocate_temp_buffer() const;
 
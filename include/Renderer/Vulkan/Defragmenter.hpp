@@ -0,0 +1,100 @@
+//
+// Created by Dániel Molnár on 2019-11-10.
+//
+
+#pragma once
+#ifndef VULKANENGINE_DEFRAGMENTER_HPP
+#define VULKANENGINE_DEFRAGMENTER_HPP
+
+// ----- std -----
+#include <memory>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <configuration.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class Buffer;
+class Drawable;
+class GpuProfiler;
+class LogicalDevice;
+class Texture2D;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Gives sparsely used device memory chunks back by moving the textures and
+// geometry buffers out of them. The allocator picks the chunks to empty, and
+// their resources are copied a few at a time, up to the budget per frame, to
+// blocks placed elsewhere. The objects are kept, only their storage is
+// swapped, and the textures get new descriptors.
+// Moves are planned at plan, and the copies recorded into the command buffer
+// of the frame in record. The previous storage is kept until the frame comes
+// around again, so moving never waits for the device.
+class Defragmenter {
+   private:
+    // Storage moved away from, the frames in flight may still use it
+    struct FrameSlot {
+        std::vector<std::unique_ptr<Texture2D>> textures;
+        std::vector<std::unique_ptr<Buffer>> buffers;
+    };
+
+    LogicalDevice& _logical_device;
+
+    double _max_occupancy;
+    VkDeviceSize _budget;
+    unsigned int _interval;
+    unsigned int _idle_frames = 0;
+
+    std::vector<Texture2D*> _textures;
+    std::vector<Buffer*> _buffers;
+
+    std::vector<FrameSlot> _slots;
+    unsigned int _current = 0;
+
+    VkDeviceSize _relocated_size = 0;
+
+   public:
+    Defragmenter(
+        LogicalDevice& logical_device, unsigned int frame_count,
+        double max_occupancy = Configuration::DefragmentationOccupancy,
+        VkDeviceSize budget = Configuration::DefragmentationBudget,
+        unsigned int interval = Configuration::DefragmentationInterval);
+
+    Defragmenter(const Defragmenter&) = delete;
+    Defragmenter& operator=(const Defragmenter&) = delete;
+
+    // The frame was waited for, releases the storage moved away from when it
+    // came around the last time. With the last block of a chunk the chunk is
+    // freed.
+    void begin_frame(unsigned int frame);
+
+    // Picks the resources to move in this frame, returns whether there is
+    // anything to record. The resources have to stay alive until the record.
+    // Called every frame, new chunks to empty are only looked for every
+    // interval frames.
+    bool plan(
+        const std::vector<std::unique_ptr<Texture2D>>& textures,
+        const std::vector<Drawable>& drawables);
+
+    // Records the copies of the planned resources into the command buffer of
+    // the current frame, outside of a render pass, and swaps their storage.
+    // The copy is timed when a profiler is given.
+    void record(VkCommandBuffer command_buffer,
+                GpuProfiler* profiler = nullptr);
+
+    // Drops the storage moved away from, the device has to be idle. Has to
+    // happen before the descriptors of the textures are destroyed.
+    void release();
+
+    // Moved by all commits so far, in bytes
+    [[nodiscard]] VkDeviceSize relocated_size() const {
+        return _relocated_size;
+    }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_DEFRAGMENTER_HPP
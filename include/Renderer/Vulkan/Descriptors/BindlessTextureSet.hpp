@@ -0,0 +1,72 @@
+//
+// Created by Dániel Molnár on 2019-10-24.
+//
+
+#pragma once
+#ifndef VULKANENGINE_BINDLESSTEXTURESET_HPP
+#define VULKANENGINE_BINDLESSTEXTURESET_HPP
+
+// ----- std -----
+#include <memory>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Descriptors/DescriptorPool.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorSetLayout.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorWriteBatch.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class DescriptorSet;
+class Image;
+class ImageView;
+class LogicalDevice;
+class PhysicalDevice;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// A single, partially bound sampler2D[] descriptor holding every texture.
+// The set is bound once per command buffer, draws select their texture by
+// index, so switching textures does not break batches anymore.
+// Slots are written with update-after-bind, but like any other descriptor
+// they must not change while a submitted command buffer may read them.
+class BindlessTextureSet {
+   private:
+    const LogicalDevice& _logical_device;
+    unsigned int _capacity;
+
+    DescriptorSetLayout _layout;
+    DescriptorPool _pool;
+    DescriptorSet* _descriptor_set;
+
+    unsigned int _next_index = 0;
+    std::vector<unsigned int> _free_indices;
+
+   public:
+    BindlessTextureSet(LogicalDevice& logical_device,
+                       const PhysicalDevice& physical_device);
+
+    BindlessTextureSet(const BindlessTextureSet&) = delete;
+    BindlessTextureSet& operator=(const BindlessTextureSet&) = delete;
+
+    // Returns the index of the slot the texture was written to
+    [[nodiscard]] unsigned int add(const Image& image, const ImageView& view,
+                                   VkSampler sampler);
+    void write(unsigned int index, const Image& image, const ImageView& view,
+               VkSampler sampler, DescriptorWriteBatch<>& batch);
+    // The slot is reused by a later add, the caller guarantees nothing
+    // samples it in the meantime
+    void remove(unsigned int index);
+
+    [[nodiscard]] VkDescriptorSetLayout layout() const {
+        return _layout.handle();
+    }
+    [[nodiscard]] const VkDescriptorSet& handle() const;
+    [[nodiscard]] unsigned int capacity() const { return _capacity; }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_BINDLESSTEXTURESET_HPP
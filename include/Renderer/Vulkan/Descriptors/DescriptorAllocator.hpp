@@ -0,0 +1,145 @@
+//
+// Created by Dániel Molnár on 2019-10-25.
+//
+
+#pragma once
+#ifndef VULKANENGINE_DESCRIPTORALLOCATOR_HPP
+#define VULKANENGINE_DESCRIPTORALLOCATOR_HPP
+
+// ----- std -----
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Buffers.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorPool.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorWriteBatch.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class DescriptorSet;
+class Image;
+class ImageView;
+class LogicalDevice;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// The resources a set is written with. Together with the layout it
+// identifies a cached set, two sets with equal bindings are interchangeable.
+// Views are compared by handle, so sets are only shared for the same view,
+// e.g. by a texture attached again.
+class DescriptorBindings {
+   private:
+    struct ImageBinding {
+        VkDescriptorSetLayoutBinding layout;
+        unsigned int index;
+        const Image* image;
+        const ImageView* view;
+        VkSampler sampler;
+    };
+
+    struct BufferBinding {
+        VkDescriptorSetLayoutBinding layout;
+        unsigned int index;
+        const Buffer* buffer;
+        SubBufferDescriptor descriptor;
+    };
+
+    std::vector<ImageBinding> _images;
+    std::vector<BufferBinding> _buffers;
+    std::uint64_t _hash;
+
+   public:
+    DescriptorBindings();
+
+    DescriptorBindings& image(VkDescriptorSetLayoutBinding layout,
+                              unsigned int index, const Image& image,
+                              const ImageView& view, VkSampler sampler);
+    DescriptorBindings& buffer(VkDescriptorSetLayoutBinding layout,
+                               unsigned int index, const Buffer& buffer,
+                               SubBufferDescriptor descriptor);
+
+    [[nodiscard]] std::uint64_t hash() const { return _hash; }
+    [[nodiscard]] bool operator==(const DescriptorBindings& other) const;
+
+    void write(const DescriptorSet& set, DescriptorWriteBatch<>& batch) const;
+};
+
+// Hands out descriptor sets from a chain of pools, a new (larger) pool is
+// created whenever the current ones are exhausted, so new materials can be
+// loaded at runtime.
+// Transient sets come from per-frame pools, which are reset wholesale when
+// the frame comes around again, and recycled instead of destroyed.
+class DescriptorAllocator {
+   public:
+    using PoolSizes = std::vector<std::pair<VkDescriptorType, unsigned long>>;
+
+   private:
+    struct CachedSet {
+        VkDescriptorSetLayout layout;
+        DescriptorBindings bindings;
+        DescriptorSet* set;
+        unsigned int references;
+    };
+
+    const LogicalDevice& _logical_device;
+
+    PoolSizes _pool_sizes;
+    unsigned long _max_sets;
+    unsigned int _growth = 1;
+
+    std::vector<std::unique_ptr<DescriptorPool>> _pools;
+
+    // Used pools of every frame, the last one is the one allocated from
+    std::vector<std::vector<std::unique_ptr<DescriptorPool>>> _frame_pools;
+    std::vector<std::unique_ptr<DescriptorPool>> _free_pools;
+    unsigned int _frame = 0;
+
+    std::unordered_multimap<std::uint64_t, CachedSet> _cache;
+    // Released cached sets by layout, the pools do not free single sets
+    std::unordered_multimap<VkDescriptorSetLayout, DescriptorSet*> _free_sets;
+
+    [[nodiscard]] std::unique_ptr<DescriptorPool> create_pool(
+        unsigned int factor) const;
+    [[nodiscard]] std::unique_ptr<DescriptorPool> acquire_transient_pool();
+
+   public:
+    // pool_sizes and max_sets describe the first pool, every pool chained
+    // after it doubles in size, up to 16 times the first one
+    DescriptorAllocator(const LogicalDevice& logical_device,
+                        PoolSizes pool_sizes, unsigned long max_sets,
+                        unsigned int frame_count);
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    // Lives as long as the allocator
+    [[nodiscard]] DescriptorSet* allocate(VkDescriptorSetLayout layout);
+
+    // Lives until begin_frame is called with the current frame index again
+    [[nodiscard]] DescriptorSet* allocate_transient(
+        VkDescriptorSetLayout layout);
+
+    // Returns an already written set with the same layout and bindings, or
+    // allocates, writes and caches a new one. Has to be released by every
+    // caller.
+    [[nodiscard]] DescriptorSet* cached(VkDescriptorSetLayout layout,
+                                        const DescriptorBindings& bindings);
+    // Once released by everyone, the set is reused by the next cached set of
+    // its layout, and may not be in use by the device anymore
+    void release_cached(DescriptorSet* set);
+
+    // The transient sets of frame may not be in use by the device anymore
+    void begin_frame(unsigned int frame);
+
+    [[nodiscard]] size_t pool_count() const;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_DESCRIPTORALLOCATOR_HPP
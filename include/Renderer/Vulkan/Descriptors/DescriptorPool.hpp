@@ -34,13 +34,20 @@ class DescriptorPool {
     DescriptorPool(const LogicalDevice& logical_device,
                    const std::vector<std::pair<VkDescriptorType, unsigned long>>&
                        pool_sizes,
-                   unsigned long max_sets);
+                   unsigned long max_sets,
+                   VkDescriptorPoolCreateFlags flags = 0);
     ~DescriptorPool();
 
     std::vector<DescriptorSet*> allocate_sets(
         unsigned int count, const std::vector<VkDescriptorSetLayout>& layouts);
 
     DescriptorSet* allocate_set(const VkDescriptorSetLayout& layout);
+
+    // Returns nullptr instead of throwing when the pool is exhausted
+    DescriptorSet* try_allocate_set(const VkDescriptorSetLayout& layout);
+
+    // Frees every set allocated from the pool at once
+    void reset();
 };
 }  // namespace Vulkan
 
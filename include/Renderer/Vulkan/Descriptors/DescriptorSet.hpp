@@ -50,6 +50,8 @@ class DescriptorSet {
     VkDescriptorSet _descriptor_set;
 
     std::vector<ScheduledDescriptorWrite> _scheduled_writes;
+    // Kept between updates, so its storage is reused
+    std::vector<VkWriteDescriptorSet> _writes;
 
     void write(VkDescriptorSetLayoutBinding layout, unsigned int index,
                std::vector<VkDescriptorBufferInfo> buffer_infos);
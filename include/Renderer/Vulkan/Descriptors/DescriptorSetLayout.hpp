@@ -27,9 +27,12 @@ class DescriptorSetLayout {
     VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
 
    public:
+    // binding_flags is either empty or has one entry per binding, layouts
+    // with update-after-bind bindings need a pool created to match
     DescriptorSetLayout(
         LogicalDevice& logical_device,
-        const std::vector<VkDescriptorSetLayoutBinding>& bindings);
+        const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+        const std::vector<VkDescriptorBindingFlagsEXT>& binding_flags = {});
     ~DescriptorSetLayout();
 
     [[nodiscard]] VkDescriptorSetLayout handle() const { return _layout; }
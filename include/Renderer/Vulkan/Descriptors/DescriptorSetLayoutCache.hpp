@@ -0,0 +1,58 @@
+//
+// Created by Dániel Molnár on 2019-10-30.
+//
+
+#pragma once
+#ifndef VULKANENGINE_DESCRIPTORSETLAYOUTCACHE_HPP
+#define VULKANENGINE_DESCRIPTORSETLAYOUTCACHE_HPP
+
+// ----- std -----
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Descriptors/DescriptorSetLayout.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+}
+
+namespace Vulkan {
+// Hands out one layout per distinct set of bindings, so pipelines declaring
+// the same set share the layout, and with it the descriptor sets bound to it.
+class DescriptorSetLayoutCache {
+   private:
+    struct Entry {
+        std::vector<VkDescriptorSetLayoutBinding> bindings;
+        std::unique_ptr<DescriptorSetLayout> layout;
+    };
+
+    LogicalDevice& _logical_device;
+
+    std::mutex _guard;
+    std::unordered_multimap<std::uint64_t, Entry> _layouts;
+
+   public:
+    explicit DescriptorSetLayoutCache(LogicalDevice& logical_device);
+
+    DescriptorSetLayoutCache(const DescriptorSetLayoutCache&) = delete;
+    DescriptorSetLayoutCache& operator=(const DescriptorSetLayoutCache&) =
+        delete;
+
+    // Immutable samplers are not supported, the bindings may come in any
+    // order. The layout lives as long as the cache.
+    [[nodiscard]] DescriptorSetLayout& get(
+        std::vector<VkDescriptorSetLayoutBinding> bindings);
+
+    [[nodiscard]] size_t size() const { return _layouts.size(); }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_DESCRIPTORSETLAYOUTCACHE_HPP
@@ -0,0 +1,59 @@
+//
+// Created by Dániel Molnár on 2019-10-26.
+//
+
+#pragma once
+#ifndef VULKANENGINE_DESCRIPTORUPDATETEMPLATE_HPP
+#define VULKANENGINE_DESCRIPTORUPDATETEMPLATE_HPP
+
+// ----- std -----
+#include <type_traits>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+namespace Vulkan {
+class DescriptorSet;
+class DescriptorSetLayout;
+class LogicalDevice;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Writes every binding of a set from a single packed struct, laid out as
+// the entries describe (offsetof of the descriptor infos in the struct).
+// The driver reads the struct directly, no VkWriteDescriptorSet is built.
+class DescriptorUpdateTemplate {
+   private:
+    const LogicalDevice& _logical_device;
+    VkDescriptorUpdateTemplate _template = VK_NULL_HANDLE;
+
+   public:
+    DescriptorUpdateTemplate(
+        const LogicalDevice& logical_device, const DescriptorSetLayout& layout,
+        const std::vector<VkDescriptorUpdateTemplateEntry>& entries);
+    ~DescriptorUpdateTemplate();
+
+    DescriptorUpdateTemplate(const DescriptorUpdateTemplate&) = delete;
+    DescriptorUpdateTemplate& operator=(const DescriptorUpdateTemplate&) =
+        delete;
+
+    [[nodiscard]] VkDescriptorUpdateTemplate handle() const {
+        return _template;
+    }
+
+    void update(const DescriptorSet& set, const void* data) const;
+
+    template <class Data>
+    void update(const DescriptorSet& set, const Data& data) const {
+        static_assert(std::is_standard_layout_v<Data>,
+                      "Template data has to have a fixed layout");
+        update(set, static_cast<const void*>(&data));
+    }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_DESCRIPTORUPDATETEMPLATE_HPP
@@ -0,0 +1,94 @@
+//
+// Created by Dániel Molnár on 2019-10-26.
+//
+
+#pragma once
+#ifndef VULKANENGINE_DESCRIPTORWRITEBATCH_HPP
+#define VULKANENGINE_DESCRIPTORWRITEBATCH_HPP
+
+// ----- std -----
+#include <array>
+#include <cstddef>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+
+// ----- forward-decl -----
+
+namespace Vulkan {
+// Collects single descriptor writes of any number of sets, and submits them
+// with one vkUpdateDescriptorSets call. Storage is fixed, the batch flushes
+// itself when full and on destruction, so it never touches the heap.
+// Written sets must not be in use by pending command buffers at flush time.
+template <size_t Capacity = 32>
+class DescriptorWriteBatch {
+   private:
+    const LogicalDevice& _logical_device;
+
+    std::array<VkWriteDescriptorSet, Capacity> _writes;
+    // One of them is used by every write, at the index of the write
+    std::array<VkDescriptorImageInfo, Capacity> _image_infos;
+    std::array<VkDescriptorBufferInfo, Capacity> _buffer_infos;
+    size_t _size = 0;
+
+    VkWriteDescriptorSet& next_write(VkDescriptorSet set,
+                                     VkDescriptorSetLayoutBinding layout,
+                                     unsigned int index) {
+        if (_size == Capacity) {
+            flush();
+        }
+
+        auto& write = _writes[_size];
+        write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = layout.binding;
+        write.dstArrayElement = index;
+        write.descriptorType = layout.descriptorType;
+        write.descriptorCount = 1;
+        return write;
+    }
+
+   public:
+    explicit DescriptorWriteBatch(const LogicalDevice& logical_device)
+        : _logical_device(logical_device) {}
+
+    DescriptorWriteBatch(const DescriptorWriteBatch&) = delete;
+    DescriptorWriteBatch& operator=(const DescriptorWriteBatch&) = delete;
+
+    ~DescriptorWriteBatch() { flush(); }
+
+    void write(VkDescriptorSet set, VkDescriptorSetLayoutBinding layout,
+               unsigned int index, const VkDescriptorImageInfo& info) {
+        auto& write = next_write(set, layout, index);
+        _image_infos[_size] = info;
+        write.pImageInfo = &_image_infos[_size];
+        ++_size;
+    }
+
+    void write(VkDescriptorSet set, VkDescriptorSetLayoutBinding layout,
+               unsigned int index, const VkDescriptorBufferInfo& info) {
+        auto& write = next_write(set, layout, index);
+        _buffer_infos[_size] = info;
+        write.pBufferInfo = &_buffer_infos[_size];
+        ++_size;
+    }
+
+    void flush() {
+        if (_size == 0) {
+            return;
+        }
+
+        vkUpdateDescriptorSets(_logical_device.handle(), _size, _writes.data(),
+                               0, nullptr);
+        _size = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return _size; }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_DESCRIPTORWRITEBATCH_HPP
@@ -28,7 +28,7 @@ class Drawable {
     LogicalDevice& _logical_device;
     std::unique_ptr<Buffer> _buffer;
 
-    SubBufferDescriptor _uniform_buffer_desc;
+    SubBufferDescriptor _uniform_buffer_desc = {};
     SubBufferDescriptor _vertex_buffer_desc;
     SubBufferDescriptor _index_buffer_desc;
 
@@ -55,12 +55,21 @@ class Drawable {
     void set_texture(Texture2D* texture);
 
     [[nodiscard]] Texture2D* texture() const;
+    // Vertices followed by the indices
+    [[nodiscard]] Buffer& buffer() const { return *_buffer; }
+    [[nodiscard]] const Asset::Mesh& mesh() const { return _mesh; }
+    [[nodiscard]] const glm::highp_vec3& position() const { return _position; }
 
     [[nodiscard]] const glm::mat4& model_matrix() const;
     void transform(const glm::mat4& transformation);
 
+    // Model matrix placed at the position of the drawable
+    [[nodiscard]] glm::mat4 world_matrix() const;
+
+    void update(uint64_t delta_time);
     void update(Buffer& buffer, uint64_t delta_time);
-    void draw(VkCommandBuffer command_buffer);
+    // The first instance indexes the model matrix in the storage buffer
+    void draw(VkCommandBuffer command_buffer, uint32_t first_instance = 0);
     void consume_uniform_buffer(DynamicUniformBuffer& buffer);
     const SubBufferDescriptor& uniform_buffer_desc() const;
 };
@@ -0,0 +1,85 @@
+//
+// Created by Dániel Molnár on 2019-11-03.
+//
+
+#pragma once
+#ifndef VULKANENGINE_FRAMECONTEXT_HPP
+#define VULKANENGINE_FRAMECONTEXT_HPP
+
+// ----- std -----
+#include <memory>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Buffers.hpp>
+#include <Renderer/Vulkan/CommandPool.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class DescriptorSet;
+class LogicalDevice;
+class Swapchain;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Everything a frame writes or records while the frames before it may still
+// be executing. The renderer cycles through its frame contexts, and reuses
+// one only after the fence of its last submission is signaled.
+class FrameContext {
+   private:
+    LogicalDevice& _logical_device;
+
+    // Reset as a whole every time the frame comes around again
+    CommandPool _command_pool;
+
+    VkSemaphore _image_available = VK_NULL_HANDLE;
+    VkSemaphore _render_finished = VK_NULL_HANDLE;
+    VkFence _in_flight = VK_NULL_HANDLE;
+
+    std::unique_ptr<Buffer> _uniform_buffer;
+    // None when the model matrices are pushed
+    std::unique_ptr<Buffer> _object_buffer;
+    // Scene set referencing the buffers above, written again every frame
+    DescriptorSet* _scene_set = nullptr;
+
+   public:
+    FrameContext(LogicalDevice& logical_device, const Swapchain& swapchain,
+                 std::unique_ptr<Buffer> uniform_buffer,
+                 std::unique_ptr<Buffer> object_buffer);
+    ~FrameContext();
+
+    FrameContext(const FrameContext&) = delete;
+    FrameContext& operator=(const FrameContext&) = delete;
+
+    // Blocks until the device is done with the last submission of the frame
+    void wait() const;
+
+    // Resets the command buffer of the frame and begins its recording, the
+    // frame has to be waited for
+    [[nodiscard]] VkCommandBuffer begin();
+
+    [[nodiscard]] VkCommandBuffer command_buffer() const {
+        return _command_pool.buffer(0);
+    }
+
+    [[nodiscard]] VkSemaphore image_available() const {
+        return _image_available;
+    }
+    [[nodiscard]] VkSemaphore render_finished() const {
+        return _render_finished;
+    }
+    // Unsignaled from begin() until the submission of the frame finishes
+    [[nodiscard]] VkFence in_flight() const { return _in_flight; }
+
+    [[nodiscard]] Buffer& uniform_buffer() const { return *_uniform_buffer; }
+    [[nodiscard]] Buffer* object_buffer() const {
+        return _object_buffer.get();
+    }
+    [[nodiscard]] DescriptorSet& scene_set() const { return *_scene_set; }
+    void set_scene_set(DescriptorSet* scene_set) { _scene_set = scene_set; }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_FRAMECONTEXT_HPP
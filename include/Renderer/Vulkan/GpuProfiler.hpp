@@ -0,0 +1,137 @@
+//
+// Created by Dániel Molnár on 2019-11-08.
+//
+
+#pragma once
+#ifndef VULKANENGINE_GPUPROFILER_HPP
+#define VULKANENGINE_GPUPROFILER_HPP
+
+// ----- std -----
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <configuration.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+class PhysicalDevice;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Measures labelled scopes of command buffers with timestamp queries. Every
+// frame in flight writes its own query pool, which is only read when the
+// frame comes around again, after its fence is waited for, so reading never
+// stalls. Command buffers flushed right away, like uploads, share one more
+// pool, read after the flush.
+// The durations of the last samples are kept per label, and while a trace
+// is recorded every scope is added to it as a zone of the "GPU" track.
+// Labels are not copied, string literals are expected. Without timestamp
+// support on the queue family everything is a no-op.
+class GpuProfiler {
+   public:
+    // In milliseconds
+    struct Statistics {
+        double min;
+        double average;
+        double p99;
+        std::size_t samples;
+    };
+
+    // Returned by begin when the scope is not measured
+    static constexpr unsigned int NoScope =
+        std::numeric_limits<unsigned int>::max();
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Scope {
+        const char* label;
+        // The end timestamp follows in the next query
+        std::uint32_t query;
+    };
+
+    struct Slot {
+        VkQueryPool query_pool = VK_NULL_HANDLE;
+        std::vector<Scope> scopes;
+        // Reset recorded, results not collected yet
+        bool pending = false;
+        // The device can not start the queries before this
+        Clock::time_point recorded;
+    };
+
+    struct History {
+        std::vector<double> samples;
+        std::size_t next = 0;
+    };
+
+    const LogicalDevice& _logical_device;
+
+    bool _supported;
+    double _period;
+    std::uint64_t _valid_mask;
+    unsigned int _scopes_per_slot;
+    std::size_t _history_size;
+
+    // One per frame, the last one for immediate command buffers
+    std::vector<Slot> _slots;
+    unsigned int _current = 0;
+
+    std::map<std::string, History> _histories;
+
+    // Device minus CPU time, in nanoseconds, the smallest seen so far is the
+    // closest, the device never starts before the recording
+    std::optional<std::int64_t> _clock_offset;
+
+    void collect(Slot& slot);
+    void reset(VkCommandBuffer command_buffer, unsigned int slot);
+
+   public:
+    GpuProfiler(
+        const PhysicalDevice& physical_device,
+        const LogicalDevice& logical_device, unsigned int queue_family,
+        unsigned int frame_count,
+        unsigned int scopes_per_frame = Configuration::GpuScopesPerFrame,
+        std::size_t history_size = Configuration::GpuTimingHistory);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    [[nodiscard]] bool supported() const { return _supported; }
+
+    // Collects the results the frame wrote the last time, and resets its
+    // queries, the frame has to be waited for. Recorded first, outside of
+    // render passes, later scopes go to this frame.
+    void begin_frame(VkCommandBuffer command_buffer, unsigned int frame);
+
+    // Like begin_frame, for a command buffer that is waited for right after
+    // its submission
+    void begin_immediate(VkCommandBuffer command_buffer);
+    // Collects the scopes of the immediate command buffer once it is finished
+    void end_immediate();
+
+    // Scopes beyond the capacity of the frame are not measured
+    [[nodiscard]] unsigned int begin(
+        VkCommandBuffer command_buffer, const char* label,
+        VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    void end(
+        VkCommandBuffer command_buffer, unsigned int scope,
+        VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    // Over the last samples of every label measured so far
+    [[nodiscard]] std::map<std::string, Statistics> statistics() const;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_GPUPROFILER_HPP
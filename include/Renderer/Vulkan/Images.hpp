@@ -21,7 +21,8 @@ class LogicalDevice;
 class Swapchain;
 namespace Memory {
 class Block;
-}
+struct Resource;
+}  // namespace Memory
 }  // namespace Vulkan
 
 namespace Vulkan {
@@ -50,6 +51,10 @@ class Image {
           VkImageLayout initial_layout, VkImageUsageFlags usage,
           VkSharingMode sharing_mode, VkMemoryPropertyFlags properties);
 
+    // Exchanges the underlying image and memory, so the object identity (and
+    // everything pointing to it) can be kept while the storage is replaced.
+    void swap_storage(Image& other);
+
    public:
     Image(LogicalDevice& logical_device, VkImageType type, unsigned int width,
           unsigned int height, unsigned int depth, unsigned int mip_levels,
@@ -67,6 +72,8 @@ class Image {
     [[nodiscard]] unsigned int array_layers() const { return _array_layers; }
     [[nodiscard]] VkFormat format() const { return _format; }
     [[nodiscard]] VkImageLayout layout() const { return _layout; }
+    // Null for swapchain images
+    [[nodiscard]] const Memory::Block* block() const { return _block; }
 
     virtual void transition_layout(VkCommandBuffer command_buffer,
                                    VkImageLayout new_layout);
@@ -99,11 +106,21 @@ class SwapchainImage : public Image {
     }
 };
 
-class DepthImage : public Image {
+// Render target without memory of its own, the owner binds it, possibly to
+// memory shared with other attachments, see TransientAttachments
+class AttachmentImage : public Image {
    public:
-    DepthImage(const Swapchain& swapchain, VkFormat depth_format);
+    AttachmentImage(LogicalDevice& logical_device, VkExtent2D extent,
+                    VkFormat format, VkImageUsageFlags usage,
+                    VkMemoryPropertyFlags properties);
+
+    ~AttachmentImage() override = default;
 
-    ~DepthImage() override = default;
+    // Whether the driver asks for memory of its own is set in the resource
+    [[nodiscard]] VkMemoryRequirements memory_requirements(
+        Memory::Resource& resource) const;
+    // The block is not released with the image
+    void bind(const Memory::Block& block);
 
     [[nodiscard]] VkImageViewType view_type() const override {
         return VK_IMAGE_VIEW_TYPE_2D;
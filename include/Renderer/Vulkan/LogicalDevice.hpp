@@ -7,6 +7,7 @@
 #define VULKANENGINE_LOGICALDEVICE_HPP
 
 // ----- std -----
+#include <memory>
 
 // ----- libraries -----
 #include <vulkan/vulkan.h>
@@ -16,7 +17,10 @@
 
 // ----- forward decl -----
 namespace Vulkan {
+class DescriptorSetLayoutCache;
 class PhysicalDevice;
+class PipelineCache;
+class ShaderModuleCache;
 class Surface;
 }  // namespace Vulkan
 
@@ -27,21 +31,65 @@ class LogicalDevice {
     VkQueue _graphics_queue;
     VkQueue _present_queue;
 
+    bool _bindless_textures = false;
+    bool _memory_budget = false;
+    bool _dedicated_allocation = false;
+
     Memory::Allocator _allocator;
 
+    std::unique_ptr<PipelineCache> _pipeline_cache;
+    std::unique_ptr<ShaderModuleCache> _shader_modules;
+    std::unique_ptr<DescriptorSetLayoutCache> _descriptor_set_layouts;
+
    public:
     LogicalDevice(PhysicalDevice& physicalDevice, Surface& surface);
     virtual ~LogicalDevice();
 
-    const Memory::Block& request_memory(VkMemoryRequirements mem_req,
-                                        VkMemoryPropertyFlags properties);
+    // Queries the requirements of the resource, including whether the
+    // driver prefers it to have memory of its own
+    const Memory::Block& request_buffer_memory(
+        VkBuffer buffer, VkMemoryPropertyFlags properties,
+        Memory::Category category = Memory::Category::Other);
+    const Memory::Block& request_image_memory(
+        VkImage image, VkMemoryPropertyFlags properties,
+        Memory::Category category = Memory::Category::Other);
     void release_memory(const Memory::Block& block);
+    // For images bound to memory requested elsewhere, e.g. aliased
+    [[nodiscard]] VkMemoryRequirements image_memory_requirements(
+        VkImage image, Memory::Resource& resource) const;
+    [[nodiscard]] const Memory::Allocator& allocator() const {
+        return _allocator;
+    }
+    [[nodiscard]] Memory::Allocator& allocator() { return _allocator; }
 
     VkDevice handle() const { return _device; }
 
     VkQueue graphics_queue_handle() const { return _graphics_queue; }
 
     VkQueue present_queue_handle() const { return _present_queue; }
+
+    // Descriptor indexing is enabled for sampled image arrays
+    [[nodiscard]] bool bindless_textures() const { return _bindless_textures; }
+
+    // VK_EXT_memory_budget is enabled, the allocator reports the budgets
+    [[nodiscard]] bool memory_budget() const { return _memory_budget; }
+    // VK_KHR_dedicated_allocation, core since 1.1
+    [[nodiscard]] bool dedicated_allocation() const {
+        return _dedicated_allocation;
+    }
+
+    // Shared by every pipeline created on the device
+    [[nodiscard]] PipelineCache& pipeline_cache() const {
+        return *_pipeline_cache;
+    }
+
+    [[nodiscard]] ShaderModuleCache& shader_modules() const {
+        return *_shader_modules;
+    }
+
+    [[nodiscard]] DescriptorSetLayoutCache& descriptor_set_layouts() const {
+        return *_descriptor_set_layouts;
+    }
 };
 }  // namespace Vulkan
 
@@ -7,14 +7,23 @@
 #define VULKANENGINE_ALLOCATOR_HPP
 
 // ----- std -----
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
 #include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
 #include <vector>
 
 // ----- libraries -----
 
 // ----- in-project dependencies -----
 #include <Renderer/Vulkan/Memory/Block.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
 #include <Renderer/Vulkan/Memory/Chunk.hpp>
+#include <configuration.hpp>
 
 // ----- forward-decl -----
 namespace Vulkan {
@@ -27,22 +36,198 @@ class Block;
 }
 
 namespace Vulkan::Memory {
+// Safe to use from any thread, except for deallocate. Every memory type has
+// a lock of its own, and blocks up to Configuration::AllocatorCachedBlockSize
+// released by a thread go to its cache first, taken by its next requests of
+// the same size without locking the memory type. A release finding the
+// memory type locked does not wait, the block is pushed to a lock-free list,
+// and released by the next thread locking it.
 class Allocator {
+   public:
+    struct Usage {
+        unsigned int chunk_count = 0;
+        unsigned int allocation_count = 0;
+        // Device memory allocated for the chunks, the part of it handed out
+        // in blocks, and the rest
+        VkDeviceSize allocated_size = 0;
+        VkDeviceSize used_size = 0;
+        VkDeviceSize free_size = 0;
+        VkDeviceSize largest_free_block = 0;
+
+        // Share of the free memory outside of the largest free block, 0 when
+        // all of it could be handed out at once
+        [[nodiscard]] double fragmentation() const;
+    };
+
+    struct Heap {
+        VkDeviceSize size = 0;
+        VkMemoryHeapFlags flags = 0;
+        Usage usage;
+        // Reported by VK_EXT_memory_budget, for the whole process, 0 without
+        // the extension
+        VkDeviceSize budget = 0;
+        VkDeviceSize process_usage = 0;
+    };
+
+    struct CategoryUsage {
+        unsigned int allocation_count = 0;
+        VkDeviceSize used_size = 0;
+    };
+
+    struct Statistics {
+        Usage total;
+        // By memory type index, only the types with chunks
+        std::map<unsigned int, Usage> memory_types;
+        // By heap index, all heaps of the device
+        std::vector<Heap> heaps;
+        std::array<CategoryUsage, CategoryCount> categories = {};
+        bool budget_available = false;
+        // Held by the thread caches, counted as used in the chunks
+        VkDeviceSize cached_size = 0;
+    };
+
    private:
+    // Blocks handed out and not released yet
+    struct Allocation {
+        unsigned int memory_type;
+        Category category;
+        const char* tag;
+    };
+
+    struct PendingRelease {
+        const Block* block;
+        PendingRelease* next;
+    };
+
+    struct MemoryType {
+        std::mutex guard;
+        std::list<Chunk> chunks;
+        // Pushed without the lock, drained by the holder
+        std::atomic<PendingRelease*> pending = nullptr;
+    };
+
+    // Split by block, so threads rarely wait for each other's bookkeeping
+    struct AllocationShard {
+        std::mutex guard;
+        std::unordered_map<const Block*, Allocation> allocations;
+    };
+    static constexpr std::size_t AllocationShards = 16;
+
+    struct ThreadCache {
+        std::mutex guard;
+        std::vector<const Block*> blocks;
+    };
+
     const PhysicalDevice& _physical_device;
     const LogicalDevice& _logical_device;
 
-    std::multimap<unsigned int, Chunk> _chunks;
+    VkPhysicalDeviceMemoryProperties _memory_properties;
+
+    // Locked by the statistics as well
+    mutable std::array<MemoryType, VK_MAX_MEMORY_TYPES> _memory_types;
+    mutable std::array<AllocationShard, AllocationShards> _shards;
+    std::array<ThreadCache, Configuration::AllocatorThreadCaches> _caches;
+
+    // The statistics apply the pending releases as well, as far as the
+    // callers are concerned the blocks are released already
+    mutable std::atomic<VkDeviceSize> _allocated_size = 0;
+    std::atomic<VkDeviceSize> _used_size = 0;
+    std::atomic<VkDeviceSize> _cached_size = 0;
+
+    // Blocks released to chunks and chunks created, a chunk only becomes
+    // worth emptying after either, and the count at the last check finding
+    // none
+    mutable std::atomic<std::uint64_t> _chunk_changes = 0;
+    std::atomic<std::uint64_t> _checked_changes = ~std::uint64_t{0};
+    // Including those freed by pending releases
+    mutable std::atomic<unsigned int> _evacuating_chunks = 0;
+
+    [[nodiscard]] AllocationShard& shard_of(const Block* block) const;
+    [[nodiscard]] ThreadCache& thread_cache();
+    void record(const Block& block, const Allocation& allocation);
+
+    // The lock of the memory type has to be held for these
+    // Of the next shared chunk of the memory type, large enough for the
+    // request
+    [[nodiscard]] VkDeviceSize chunk_size(const MemoryType& type,
+                                          unsigned int memory_type,
+                                          VkDeviceSize request_size) const;
+    [[nodiscard]] const Block& place(MemoryType& type,
+                                     unsigned int memory_type,
+                                     VkMemoryRequirements memory_requirements,
+                                     VkMemoryPropertyFlags properties,
+                                     bool dedicated, const Resource& resource);
+    void release_locked(MemoryType& type, const Block& block) const;
+    void drain(MemoryType& type) const;
+    // Dedicated and evacuated chunks are freed right away, one empty shared
+    // chunk is kept per memory type, so allocations going back and forth
+    // across a chunk boundary do not allocate device memory every time
+    void free_if_unused(MemoryType& type, const Chunk& chunk) const;
+    // Takes the blocks of the chunk out of the thread caches, the chunk may
+    // be freed by the time it returns
+    void release_cached(MemoryType& type, const Chunk& chunk);
+
+    // Without the lock of the memory type held
+    void release_to_chunk(const Block& block);
+    // Returns the blocks of every thread cache to their chunks
+    void flush_caches();
 
    public:
     Allocator(const PhysicalDevice& physical_device,
               const LogicalDevice& logical_device);
 
+    // Frees every chunk, the blocks still handed out are reported as leaks.
+    // No other thread may use the allocator meanwhile.
     void deallocate();
+    // The block is tagged with the innermost TagScope of the calling thread.
+    // Resources preferring it, or of Configuration::DedicatedAllocationSize,
+    // get a chunk of their own.
     const Block& request_memory(VkMemoryRequirements memory_requirements,
-                                VkMemoryPropertyFlags properties);
+                                VkMemoryPropertyFlags properties,
+                                Category category = Category::Other,
+                                const Resource& resource = {});
     void release_memory(const Block& block);
+
+    // Marks the shared chunks used up to max_occupancy, holding blocks of the
+    // relocatable categories only, to be emptied, as long as the other
+    // chunks of their memory type have room for their blocks. New blocks are
+    // placed elsewhere, and the chunks are freed with their last block.
+    // Nothing new is marked while chunks are still being emptied, and the
+    // chunks are only walked when blocks were released or chunks created
+    // since the last call marking none. Returns whether any chunk is being
+    // emptied.
+    bool begin_evacuation(double max_occupancy,
+                          const std::vector<Category>& relocatable);
+    // The chunks being emptied are used for new blocks again
+    void end_evacuation();
+    // The block should be moved elsewhere
+    [[nodiscard]] bool evacuating(const Block& block) const {
+        return block._owner.evacuating();
+    }
+    [[nodiscard]] bool evacuation_in_progress() const {
+        return _evacuating_chunks.load(std::memory_order_relaxed) > 0;
+    }
+
+    // Cheap, unlike the statistics
+    [[nodiscard]] VkDeviceSize allocated_size() const {
+        return _allocated_size.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] VkDeviceSize used_size() const {
+        return _used_size.load(std::memory_order_relaxed);
+    }
+
+    // Walks every chunk, and queries the budget when the device supports it.
+    // Locks every memory type in turn, so the parts may not add up exactly
+    // while other threads allocate.
+    [[nodiscard]] Statistics statistics() const;
+
+    // Blocks not released yet, largest first, one per line. Writes nothing
+    // when there are none.
+    void report_leaks(std::ostream& out) const;
 };
+
+// As a single JSON object, sizes in bytes
+void WriteJson(std::ostream& out, const Allocator::Statistics& statistics);
 }  // namespace Vulkan::Memory
 
 #endif  // VULKANENGINE_ALLOCATOR_HPP
@@ -51,6 +51,7 @@ class Block {
     VkDeviceMemory memory() const;
 
     void transfer(void* data, size_t size, size_t target_offset) const;
+    void read(void* data, size_t size, size_t source_offset) const;
 
     bool operator==(const Block& other) const {
         return other._offset == _offset && other._size == _size;
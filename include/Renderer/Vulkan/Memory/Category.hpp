@@ -0,0 +1,59 @@
+//
+// Created by Dániel Molnár on 2019-11-09.
+//
+
+#pragma once
+#ifndef VULKANENGINE_CATEGORY_HPP
+#define VULKANENGINE_CATEGORY_HPP
+
+// ----- std -----
+#include <cstddef>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+
+namespace Vulkan::Memory {
+// What a block of device memory is used for, deduced from the usage of the
+// buffer or image bound to it
+enum class Category : unsigned int {
+    Geometry,
+    Uniform,
+    Storage,
+    Staging,
+    Readback,
+    Texture,
+    Attachment,
+    Other
+};
+constexpr const std::size_t CategoryCount =
+    static_cast<std::size_t>(Category::Other) + 1;
+
+[[nodiscard]] const char* CategoryName(Category category);
+[[nodiscard]] Category BufferCategory(VkBufferUsageFlags usage,
+                                      VkMemoryPropertyFlags properties);
+[[nodiscard]] Category ImageCategory(VkImageUsageFlags usage);
+
+// Names the allocations the calling thread makes while it lives, they are
+// listed by it when never released. Scopes nest, the innermost one applies.
+// The name is not copied, string literals are expected.
+class TagScope {
+   private:
+    const char* _previous;
+
+   public:
+    explicit TagScope(const char* tag);
+    ~TagScope();
+
+    TagScope(const TagScope&) = delete;
+    TagScope& operator=(const TagScope&) = delete;
+
+    // Of the calling thread, "untagged" outside of every scope
+    [[nodiscard]] static const char* current();
+};
+}  // namespace Vulkan::Memory
+
+#endif  // VULKANENGINE_CATEGORY_HPP
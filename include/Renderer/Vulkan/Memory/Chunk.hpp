@@ -7,6 +7,7 @@
 #define VULKANENGINE_CHUNK_HPP
 
 // ----- std -----
+#include <atomic>
 #include <mutex>
 #include <vector>
 
@@ -26,6 +27,22 @@ class LogicalDevice;
 }
 
 namespace Vulkan::Memory {
+// The size of the block serving value bytes, and of the chunks it is split
+// from. 64 bits wide, requests of 4 GiB and more are not truncated.
+[[nodiscard]] VkDeviceSize CeilPowerOfTwo(VkDeviceSize value);
+
+// The buffer or image memory is requested for, when known
+struct Resource {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkImage image = VK_NULL_HANDLE;
+    // Preferred or required by the driver, see VK_KHR_dedicated_allocation
+    bool prefers_dedicated = false;
+    bool requires_dedicated = false;
+};
+
+// Device memory handed out in power of two sized blocks, or as a whole when
+// dedicated to a single resource. Not thread-safe apart from mapping, the
+// allocator locks the memory type of the chunk.
 class Chunk {
    private:
     const LogicalDevice& _logical_device;
@@ -35,8 +52,16 @@ class Chunk {
 
     VkDeviceMemory _memory = VK_NULL_HANDLE;
     VkMemoryPropertyFlags _properties;
+    unsigned int _memory_type;
 
     Core::SizeLiterals::Byte _size;
+    bool _dedicated;
+    // New blocks are not placed in it, see Allocator::begin_evacuation. Read
+    // without the lock of the memory type.
+    std::atomic<bool> _evacuating = false;
+    // Sum of the blocks handed out, after rounding up to powers of two
+    VkDeviceSize _used_size = 0;
+    unsigned int _allocation_count = 0;
 
     std::byte* _data;
     unsigned int _mapping_counter = 0;
@@ -50,8 +75,11 @@ class Chunk {
     void try_merge(const MemoryTree::Node& block);
 
    public:
+    // Dedicated to the resource when given, which is then bound to the
+    // memory through VkMemoryDedicatedAllocateInfo if the device supports it
     Chunk(const LogicalDevice& logical_device, VkMemoryPropertyFlags properties,
-          unsigned int memory_type_index, Core::SizeLiterals::Byte size);
+          unsigned int memory_type_index, Core::SizeLiterals::Byte size,
+          const Resource* dedicated_to = nullptr);
 
     ~Chunk();
 
@@ -60,10 +88,23 @@ class Chunk {
     }
 
     VkDeviceMemory memory() const { return _memory; }
+    [[nodiscard]] unsigned int memory_type() const { return _memory_type; }
+    [[nodiscard]] Core::SizeLiterals::Byte size() const { return _size; }
+    [[nodiscard]] VkDeviceSize used_size() const { return _used_size; }
+    [[nodiscard]] unsigned int allocation_count() const {
+        return _allocation_count;
+    }
+    [[nodiscard]] bool empty() const { return _allocation_count == 0; }
+    [[nodiscard]] bool dedicated() const { return _dedicated; }
+    [[nodiscard]] bool evacuating() const { return _evacuating; }
+    void set_evacuating(bool evacuating) { _evacuating = evacuating; }
+    // Walks the blocks
+    [[nodiscard]] VkDeviceSize largest_free_block() const;
 
     void map();
     void unmap();
     void transfer(void* data, size_t size, Core::SizeLiterals::Byte offset);
+    void read(void* data, size_t size, Core::SizeLiterals::Byte offset) const;
 
     std::optional<std::reference_wrapper<const Block>> request_memory(
         VkMemoryRequirements memory_requirements);
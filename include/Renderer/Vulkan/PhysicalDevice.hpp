@@ -7,6 +7,8 @@
 #define VULKANENGINE_PHYSICALDEVICE_HPP
 
 // ----- std -----
+#include <set>
+#include <string>
 
 // ----- libraries -----
 #include <vulkan/vulkan.h>
@@ -25,6 +27,16 @@ class PhysicalDevice {
     VkPhysicalDeviceFeatures _features;
 
     VkPhysicalDeviceProperties _properties;
+
+    std::set<std::string> _extensions;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT
+        _descriptor_indexing_features = {};
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT
+        _descriptor_indexing_properties = {};
+
+    void query_extension_features();
+
    public:
     PhysicalDevice(Instance& instance, Surface& surface);
 
@@ -39,6 +51,23 @@ class PhysicalDevice {
     [[nodiscard]] const VkPhysicalDeviceProperties& properties() const {
         return _properties;
     }
+
+    [[nodiscard]] bool supports_extension(const std::string& name) const {
+        return _extensions.find(name) != _extensions.end();
+    }
+
+    [[nodiscard]] const VkPhysicalDeviceDescriptorIndexingFeaturesEXT&
+    descriptor_indexing_features() const {
+        return _descriptor_indexing_features;
+    }
+
+    [[nodiscard]] const VkPhysicalDeviceDescriptorIndexingPropertiesEXT&
+    descriptor_indexing_properties() const {
+        return _descriptor_indexing_properties;
+    }
+
+    // Partially bound, update-after-bind arrays of sampled images
+    [[nodiscard]] bool supports_bindless_textures() const;
 };
 }
 
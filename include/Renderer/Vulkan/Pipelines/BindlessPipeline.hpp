@@ -0,0 +1,43 @@
+//
+// Created by Dániel Molnár on 2019-10-24.
+//
+
+#pragma once
+#ifndef VULKANENGINE_BINDLESSPIPELINE_HPP
+#define VULKANENGINE_BINDLESSPIPELINE_HPP
+
+// ----- std -----
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Pipelines/Pipeline.hpp>
+
+// ----- forward-decl -----
+
+namespace Vulkan {
+// Same as the single model pipeline, but the texture is selected from the
+// bindless texture array by the MaterialPushConstants of the draw.
+class BindlessPipeline : public Pipeline<BindlessPipeline> {
+   public:
+    using Specialization = NoSpecialization;
+
+    static const IPipeline::VertexBindingDescContainer& BindingDescriptions();
+    static const IPipeline::VertexAttribDescContainer& AttributeDescriptions();
+
+    explicit BindlessPipeline(
+        const Swapchain& swapchain,
+        const std::vector<VkDescriptorSetLayout>& layouts)
+        : Pipeline(swapchain, layouts) {}
+
+    static std::vector<ShaderStage> ShaderStages() {
+        return {
+            ShaderStage::SceneVertex(),
+            {VK_SHADER_STAGE_FRAGMENT_BIT, "bindless_shader_frag.spv", "main"}};
+    }
+
+    ~BindlessPipeline() override = default;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_BINDLESSPIPELINE_HPP
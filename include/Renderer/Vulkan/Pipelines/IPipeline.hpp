@@ -7,6 +7,8 @@
 #define VULKANENGINE_IPIPELINE_HPP
 
 // ----- std -----
+#include <string>
+#include <vector>
 
 // ----- libraries -----
 #include <vulkan/vulkan_core.h>
@@ -29,6 +31,10 @@ class IPipeline {
     [[nodiscard]] virtual const VkPipelineLayout& pipeline_layout() const = 0;
     virtual void recreate() = 0;
 
+    // Whether one of the stages is loaded from the SPIR-V file
+    [[nodiscard]] virtual bool uses_shader(
+        const std::string& file_name) const = 0;
+
     virtual ~IPipeline() = default;
 };
 }  // namespace Vulkan
@@ -18,24 +18,22 @@
 namespace Vulkan {
 class InstancedPipeline : public Pipeline<InstancedPipeline> {
    public:
+    using Specialization = MaterialSpecialization;
+
     static const IPipeline::VertexBindingDescContainer& BindingDescriptions();
     static const IPipeline::VertexAttribDescContainer& AttributeDescriptions();
-    static const IPipeline::PushConstantContainer& PushConstants();
 
     explicit InstancedPipeline(
         const Swapchain& swapchain,
-        const std::vector<VkDescriptorSetLayout>& layouts)
-        : Pipeline(swapchain, layouts) {}
-
-    static std::vector<std::unique_ptr<IShader>> Shaders(
-        LogicalDevice& logical_device) {
-        std::vector<std::unique_ptr<IShader>> result;
-        result.emplace_back(std::make_unique<VertexShader>(
-            logical_device, "instanced_shader_vert.spv", "main"));
-        result.emplace_back(std::make_unique<FragmentShader>(
-            logical_device, "shader_frag.spv", "main"));
-
-        return result;
+        const std::vector<VkDescriptorSetLayout>& layouts,
+        const Specialization& specialization = {})
+        : Pipeline(swapchain, layouts,
+                   SpecializationConstants::From(specialization)) {}
+
+    static std::vector<ShaderStage> ShaderStages() {
+        return {
+            {VK_SHADER_STAGE_VERTEX_BIT, "instanced_shader_vert.spv", "main"},
+            {VK_SHADER_STAGE_FRAGMENT_BIT, "shader_frag.spv", "main"}};
     }
 
     virtual ~InstancedPipeline() = default;
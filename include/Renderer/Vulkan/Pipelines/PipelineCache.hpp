@@ -0,0 +1,68 @@
+//
+// Created by Dániel Molnár on 2019-10-27.
+//
+
+#pragma once
+#ifndef VULKANENGINE_PIPELINECACHE_HPP
+#define VULKANENGINE_PIPELINECACHE_HPP
+
+// ----- std -----
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+class PhysicalDevice;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Device-wide pipeline cache, seeded from disk when the stored data was
+// written by the same driver for the same device, so pipelines compiled in a
+// previous run are not compiled again.
+class PipelineCache {
+   private:
+    const LogicalDevice& _logical_device;
+    std::filesystem::path _path;
+
+    VkPipelineCache _cache;
+
+    // Whether the cache started out with data from a previous run
+    bool _warm = false;
+    // Of the data last loaded or saved, the file is only written on changes
+    std::uint64_t _saved_hash = 0;
+
+    // Pipelines may be compiled on several threads at once
+    mutable std::mutex _stats_guard;
+    unsigned int _pipelines_created = 0;
+    std::chrono::steady_clock::duration _creation_time{};
+
+   public:
+    PipelineCache(const LogicalDevice& logical_device,
+                  const PhysicalDevice& physical_device,
+                  std::filesystem::path path);
+    ~PipelineCache();
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    // Writes the cache data to the file, unless it is already there
+    void save();
+
+    void record_creation(std::chrono::steady_clock::duration duration);
+
+    [[nodiscard]] VkPipelineCache handle() const { return _cache; }
+    [[nodiscard]] bool warm() const { return _warm; }
+    [[nodiscard]] unsigned int pipelines_created() const;
+    [[nodiscard]] std::chrono::steady_clock::duration creation_time() const;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_PIPELINECACHE_HPP
@@ -0,0 +1,136 @@
+//
+// Created by Dániel Molnár on 2019-10-28.
+//
+
+#pragma once
+#ifndef VULKANENGINE_PIPELINEREGISTRY_HPP
+#define VULKANENGINE_PIPELINEREGISTRY_HPP
+
+// ----- std -----
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Pipelines/IPipeline.hpp>
+#include <Renderer/Vulkan/Pipelines/PipelineState.hpp>
+#include <configuration.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+}
+
+namespace Vulkan {
+// A pipeline which is compiled in the background. Until it is ready, the
+// handle of the fallback is handed out instead, which has to be compatible
+// with the layout of the variant.
+class PipelineVariant {
+   private:
+    friend class PipelineRegistry;
+
+    VkPipelineLayout _layout;
+    const IPipeline* _fallback;
+
+    // Written once by a worker, before _ready is set
+    VkPipeline _pipeline = VK_NULL_HANDLE;
+    std::atomic<bool> _ready = false;
+
+   public:
+    PipelineVariant(VkPipelineLayout layout, const IPipeline* fallback)
+        : _layout(layout), _fallback(fallback) {}
+
+    [[nodiscard]] bool ready() const { return _ready.load(); }
+
+    // VK_NULL_HANDLE while compiling without a fallback
+    [[nodiscard]] VkPipeline handle() const;
+    [[nodiscard]] VkPipelineLayout pipeline_layout() const { return _layout; }
+};
+
+// Owns every pipeline variant requested by the renderer, keyed by the full
+// pipeline state. Missing variants are compiled on worker threads through the
+// pipeline cache of the device, so a new material does not stall the frame
+// it first shows up in.
+// Requests are expected from a single thread, variants are valid as long as
+// the registry is.
+class PipelineRegistry {
+   private:
+    struct Entry {
+        PipelineState state;
+        std::shared_ptr<PipelineVariant> variant;
+    };
+
+    struct Job {
+        PipelineState state;
+        std::vector<std::unique_ptr<IShader>> shaders;
+        std::shared_ptr<PipelineVariant> variant;
+        // Connects the request to the compilation in traces
+        std::uint64_t flow = 0;
+    };
+
+    LogicalDevice& _logical_device;
+
+    std::unordered_multimap<std::uint64_t, Entry> _variants;
+
+    mutable std::mutex _jobs_guard;
+    std::condition_variable _job_added;
+    std::condition_variable _job_done;
+    std::deque<Job> _jobs;
+    unsigned int _running = 0;
+    bool _stopping = false;
+
+    // Started with the first compilation, a registry nothing is requested
+    // from keeps no idle threads
+    unsigned int _thread_count;
+    std::vector<std::thread> _workers;
+
+    void work();
+    void enqueue(const PipelineState& state,
+                 std::shared_ptr<PipelineVariant> variant);
+    // Destroys the pipeline of the variant, and queues it again
+    void recompile(Entry& entry);
+
+   public:
+    // A thread_count of 0 leaves one hardware thread for the renderer
+    explicit PipelineRegistry(
+        LogicalDevice& logical_device,
+        unsigned int thread_count = Configuration::PipelineCompileThreads);
+    ~PipelineRegistry();
+
+    PipelineRegistry(const PipelineRegistry&) = delete;
+    PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+    // Returns the variant compiled from state, queueing its compilation when
+    // it was never requested before. The shader modules and the layout are
+    // created right away, only the compilation itself is deferred.
+    [[nodiscard]] std::shared_ptr<const PipelineVariant> request(
+        const PipelineState& state, const IPipeline* fallback = nullptr);
+
+    // Compiles every variant again against a new render pass. The variants
+    // fall back until they are ready again.
+    void retarget(VkRenderPass render_pass);
+
+    // Compiles the variants using any of the SPIR-V files again, after
+    // their code was reloaded. The descriptor and push constant interface
+    // of the shaders has to stay the same, the layouts are kept.
+    void reload(const std::vector<std::string>& file_names);
+
+    // Blocks until every queued variant is compiled
+    void wait_idle();
+
+    [[nodiscard]] size_t pending() const;
+    [[nodiscard]] size_t size() const { return _variants.size(); }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_PIPELINEREGISTRY_HPP
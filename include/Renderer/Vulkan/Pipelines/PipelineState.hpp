@@ -0,0 +1,70 @@
+//
+// Created by Dániel Molnár on 2019-10-28.
+//
+
+#pragma once
+#ifndef VULKANENGINE_PIPELINESTATE_HPP
+#define VULKANENGINE_PIPELINESTATE_HPP
+
+// ----- std -----
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Pipelines/IPipeline.hpp>
+#include <Renderer/Vulkan/Shaders/IShader.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderStage.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+}
+
+namespace Vulkan {
+// Everything a graphics pipeline is compiled from. Two pipelines created from
+// equal states are interchangeable, the viewport and scissor are dynamic.
+struct PipelineState {
+    std::vector<ShaderStage> shaders;
+    IPipeline::VertexBindingDescContainer bindings;
+    IPipeline::VertexAttribDescContainer attributes;
+
+    std::vector<VkDescriptorSetLayout> set_layouts;
+    IPipeline::PushConstantContainer push_constants;
+
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygon_mode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cull_mode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+    bool depth_test = true;
+    bool depth_write = true;
+    VkCompareOp depth_compare_op = VK_COMPARE_OP_LESS;
+
+    VkPipelineColorBlendAttachmentState blend = OpaqueBlend();
+
+    VkRenderPass render_pass = VK_NULL_HANDLE;
+    unsigned int subpass = 0;
+
+    static VkPipelineColorBlendAttachmentState OpaqueBlend();
+
+    [[nodiscard]] std::uint64_t hash() const;
+    [[nodiscard]] bool operator==(const PipelineState& other) const;
+};
+
+[[nodiscard]] VkPipelineLayout CreatePipelineLayout(
+    const LogicalDevice& logical_device, const PipelineState& state);
+
+// Compiles the state through the pipeline cache of the device, shaders are
+// the loaded modules of state.shaders, in the same order.
+// May be called from several threads at once.
+[[nodiscard]] VkPipeline CreateGraphicsPipeline(
+    const LogicalDevice& logical_device, const PipelineState& state,
+    const std::vector<std::unique_ptr<IShader>>& shaders,
+    VkPipelineLayout layout);
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_PIPELINESTATE_HPP
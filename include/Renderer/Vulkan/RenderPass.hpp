@@ -14,6 +14,7 @@
 // ----- in-project dependencies -----
 #include <Renderer/Vulkan/ImageView.hpp>
 #include <Renderer/Vulkan/Images.hpp>
+#include <Renderer/Vulkan/TransientAttachments.hpp>
 
 // ----- forward-decl -----
 namespace Vulkan {
@@ -30,17 +31,30 @@ class RenderPass {
     const Swapchain& _swapchain;
 
     VkRenderPass _render_pass;
+    VkFormat _color_format;
 
-    std::unique_ptr<Image> _depth_image;
-    std::unique_ptr<ImageView> _depth_image_view;
+    // In the order of the passes, only the scene pass so far
+    TransientAttachments _attachments;
+    unsigned int _depth_attachment;
+
+    void create_depth_image();
 
    public:
     RenderPass(const Swapchain& swapchain);
     ~RenderPass();
 
-    ImageView& depth_image_view() const { return *_depth_image_view; }
+    // Recreates the depth image with the current extent of the swapchain
+    void resize();
+
+    ImageView& depth_image_view() const {
+        return _attachments.view(_depth_attachment);
+    }
+    [[nodiscard]] const TransientAttachments& attachments() const {
+        return _attachments;
+    }
 
     [[nodiscard]] const VkRenderPass& handle() const { return _render_pass; }
+    [[nodiscard]] VkFormat color_format() const { return _color_format; }
 };
 }  // namespace Vulkan
 
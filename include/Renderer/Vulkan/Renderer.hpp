@@ -8,8 +8,10 @@
 
 // ----- std -----
 #include <array>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -20,20 +22,32 @@
 #include <Core/FileManager/BinaryFile.hpp>
 #include <Core/FileManager/FileManager.hpp>
 
+#include <glm/glm.hpp>
+
 // ----- in-project dependencies -----
 #include <Asset/Manager.hpp>
 #include <Renderer/IRenderer.hpp>
+#include <Renderer/SceneDescription.hpp>
 #include <Renderer/Vulkan/Buffers.hpp>
-#include <Renderer/Vulkan/Descriptors/DescriptorPool.hpp>
+#include <Renderer/Vulkan/Defragmenter.hpp>
+#include <Renderer/Vulkan/Descriptors/BindlessTextureSet.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorAllocator.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorUpdateTemplate.hpp>
 #include <Renderer/Vulkan/Descriptors/DescriptorSetLayout.hpp>
 #include <Renderer/Vulkan/Drawable.hpp>
+#include <Renderer/Vulkan/FrameContext.hpp>
+#include <Renderer/Vulkan/GpuProfiler.hpp>
 #include <Renderer/Vulkan/Images.hpp>
 #include <Renderer/Vulkan/Instance.hpp>
 #include <Renderer/Vulkan/LogicalDevice.hpp>
 #include <Renderer/Vulkan/PhysicalDevice.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderReflection.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderWatcher.hpp>
 #include <Renderer/Vulkan/Surface.hpp>
 #include <Renderer/Vulkan/Swapchain.hpp>
 #include <Renderer/Vulkan/Texture2D.hpp>
+#include <Renderer/Vulkan/TextureStreamer.hpp>
+#include <configuration.hpp>
 
 // ----- forward decl -----
 class IWindowService;
@@ -42,9 +56,18 @@ class IWindow;
 namespace Vulkan {
 class Renderer : public IRenderer {
    private:
-    static constexpr int MaxFramesInFlight = 2;
+    unsigned int _frames_in_flight;
     unsigned int _current_frame = 0;
     bool _framebuffer_resized = false;
+    std::chrono::steady_clock::time_point _last_submit;
+    bool _alternate_textures;
+    unsigned int _alternating_drawable;
+
+    glm::vec3 _camera_position;
+    glm::vec3 _camera_target = glm::vec3(0.0f);
+
+    // Staged at initialization and by load_texture, streaming not included
+    VkDeviceSize _uploaded_size = 0;
 
     Asset::Manager _asset_manager;
 
@@ -62,54 +85,148 @@ class Renderer : public IRenderer {
 
     Swapchain _swapchain;
     IPipeline* _single_model_pipeline;
+    // The material variant of the scene, compiled by the pipeline registry.
+    // _single_model_pipeline is bound until it is ready, or without one.
+    std::shared_ptr<const PipelineVariant> _scene_pipeline;
+
+    // Reflected once from the scene shaders
+    ShaderInterface _scene_interface;
+    // From the interface above, shared through the device-wide cache
+    DescriptorSetLayout& _material_layout;
+    DescriptorSetLayout& _uniform_layout;
 
-    DescriptorSetLayout _material_layout;
-    DescriptorSetLayout _uniform_layout;
+    TextureStreamer _texture_streamer;
+    Defragmenter _defragmenter;
 
-    std::unique_ptr<DescriptorPool> _descriptor_pool;
-    DescriptorSet* _descriptor_set;
+    // Slots for every frame in flight, read when the frame comes around
+    GpuProfiler _gpu_profiler;
 
+    // Only with Configuration::ShaderHotReload, when the sources are found
+    std::unique_ptr<ShaderWatcher> _shader_watcher;
+
+    std::unique_ptr<DescriptorAllocator> _descriptor_allocator;
+    std::unique_ptr<DescriptorUpdateTemplate> _scene_update_template;
+
+    // Only when the device supports it, the textures release their slots
+    // on destruction, so it has to outlive them
+    std::unique_ptr<BindlessTextureSet> _bindless_textures;
     std::vector<std::unique_ptr<Texture2D>> _textures;
     VkSampler _texture_sampler;
 
-    std::unique_ptr<Buffer> _uniform_buffer;
-    std::unique_ptr<Buffer> _dynamic_uniform_buffer;
-
-    std::vector<VkSemaphore> _image_available;
-    std::vector<VkSemaphore> _render_finished;
-    std::vector<VkFence> _in_flight;
+    // One per frame in flight, indexed by _current_frame
+    std::vector<std::unique_ptr<FrameContext>> _frames;
 
     std::vector<Drawable> _drawables;
 
-    void stage_textures();
+    // Written by the next render() when not empty, the readback buffer is
+    // kept for later captures of the same size
+    std::string _capture_path;
+    std::unique_ptr<Buffer> _capture_buffer;
+
+    [[nodiscard]] Asset::TextureFormat texture_format() const;
+    // Uploads and attaches the textures from index first on
+    void stage_textures(std::size_t first = 0);
     void stage_drawables();
     void create_sampler();
-    void record_command_buffers(unsigned int batch = 0);
-    void create_synchronization_objects();
+    void record_command_buffer(FrameContext& frame, unsigned int image_index);
+    void record_capture(VkCommandBuffer command_buffer,
+                        unsigned int image_index);
+    void write_capture(const FrameContext& frame);
 
-    void create_uniform_buffers();
-    void write_descriptor_sets();
+    void create_frames();
+    // From the transient pools of the frame, as the set of the previous
+    // frame with the same index is not in use anymore
+    void write_scene_set(FrameContext& frame);
 
     void recreate_swap_chain();
 
+    void report_texture_usage();
+    void stream_textures();
+    void defragment();
+
+    void reload_shaders();
+
    public:
     static const std::vector<const char*> RequiredExtensions;
     static constexpr const std::array<const char*, 1> ValidationLayers = {
         "VK_LAYER_KHRONOS_validation"};
-
-    Renderer(IWindowService& service, std::shared_ptr<const IWindow> window);
+    static constexpr unsigned int MinFramesInFlight = 1;
+    static constexpr unsigned int MaxFramesInFlight = 4;
+
+    // Throws std::invalid_argument when frames_in_flight is out of range, or
+    // the scene refers to drawables or textures it does not have
+    Renderer(IWindowService& service, std::shared_ptr<const IWindow> window,
+             unsigned int frames_in_flight = Configuration::FramesInFlight,
+             const SceneDescription& scene = {});
     virtual ~Renderer();
 
     [[nodiscard]] const Instance& get_instance() const { return _instance; }
+    [[nodiscard]] unsigned int frames_in_flight() const {
+        return _frames_in_flight;
+    }
 
     void initialize() override;
 
     void resized(int width, int height) override;
 
+    // Recreates the swapchain right away, waiting for the frames in flight
+    void set_present_policy(PresentPolicy policy);
+    [[nodiscard]] PresentPolicy present_policy() const {
+        return _swapchain.present_policy();
+    }
+
+    void set_camera(const glm::vec3& position, const glm::vec3& target);
+
+    // Loads and uploads a texture while rendering, returns its index. Throws
+    // std::runtime_error when the file can not be loaded.
+    unsigned int load_texture(const std::string& name);
+    // Both are indices, the drawables follow the order of the scene
+    void set_texture(unsigned int drawable, unsigned int texture);
+    [[nodiscard]] std::size_t drawable_count() const {
+        return _drawables.size();
+    }
+    [[nodiscard]] std::size_t texture_count() const {
+        return _textures.size();
+    }
+
+    // Texel and vertex data staged for the device so far, in bytes
+    [[nodiscard]] VkDeviceSize uploaded_size() const {
+        return _uploaded_size + _texture_streamer.uploaded_size();
+    }
+    [[nodiscard]] Memory::Allocator::Statistics allocator_statistics() const {
+        return _logical_device.allocator().statistics();
+    }
+    // For tools using the device directly, e.g. the allocator benchmark
+    [[nodiscard]] LogicalDevice& logical_device() { return _logical_device; }
+    [[nodiscard]] const PhysicalDevice& physical_device() const {
+        return _physical_device;
+    }
+    // Moved by the defragmenter so far, in bytes
+    [[nodiscard]] VkDeviceSize relocated_size() const {
+        return _defragmenter.relocated_size();
+    }
+    // Device time of the render pass, uploads and captures, lagging behind
+    // by the frames in flight
+    [[nodiscard]] const GpuProfiler& gpu_profiler() const {
+        return _gpu_profiler;
+    }
+
+    void wait_for_frame() override;
     void render(uint64_t delta_time) override;
 
+    // Reads the next rendered frame back and writes it to a PNG file, the
+    // render() call waits for the device to finish it. Throws when the
+    // swapchain images can not be copied or have no 8 bit RGBA format.
+    void capture(std::string path);
+
+    // When the command buffer of the last rendered frame was submitted
+    [[nodiscard]] std::chrono::steady_clock::time_point last_submit() const {
+        return _last_submit;
+    }
+
     void shutdown() override;
-    void update_uniform_buffer(uint64_t delta_time);
+    void update_uniform_buffer(FrameContext& frame, uint64_t delta_time);
+    void update_object_data(FrameContext& frame, uint64_t delta_time);
     void create_desc_pool();
 };
 }  // namespace Vulkan
@@ -7,9 +7,10 @@
 #define VULKANENGINE_SHADERBASE_HPP
 
 // ----- std -----
+#include <string>
 
 // ----- libraries -----
-#include <Core/FileManager/FileManager.hpp>
+#include <vulkan/vulkan_core.h>
 
 // ----- in-project dependencies -----
 #include <Renderer/Vulkan/Shaders/IShader.hpp>
@@ -22,8 +23,6 @@ class LogicalDevice;
 namespace Vulkan {
 class ShaderBase : public IShader {
    private:
-    static Core::FileManager& ShaderManager();
-
     LogicalDevice& _logical_device;
 
     std::string _file_name;
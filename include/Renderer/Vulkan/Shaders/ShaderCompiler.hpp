@@ -0,0 +1,49 @@
+//
+// Created by Dániel Molnár on 2019-11-01.
+//
+
+#pragma once
+#ifndef VULKANENGINE_SHADERCOMPILER_HPP
+#define VULKANENGINE_SHADERCOMPILER_HPP
+
+// ----- std -----
+#include <filesystem>
+#include <string>
+
+// ----- libraries -----
+#include <Core/FileManager/BinaryFile.hpp>
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+
+namespace Vulkan {
+// Compiles GLSL sources to SPIR-V with the glslc found at configure time.
+// The results are stored on disk, keyed by the hash of the source, so an
+// unchanged shader is never compiled twice, not even across runs.
+// Sources are expected to be self-contained, #include is not tracked.
+class ShaderCompiler {
+   private:
+    std::filesystem::path _compiler;
+    std::filesystem::path _cache_directory;
+
+   public:
+    ShaderCompiler(std::filesystem::path compiler,
+                   std::filesystem::path cache_directory);
+
+    // Throws with the compiler output when the source does not compile.
+    // May be called from several threads at once.
+    [[nodiscard]] Core::BinaryFile::ByteSequence compile(
+        const std::filesystem::path& source) const;
+
+    // Whether the compiler exists, it is missing from installed builds
+    [[nodiscard]] bool available() const;
+
+    // The source the SPIR-V file is built from, by the naming of the build:
+    // shader_frag.spv is compiled from shader.frag
+    [[nodiscard]] static std::string SourceName(
+        const std::string& spirv_file_name);
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_SHADERCOMPILER_HPP
@@ -0,0 +1,126 @@
+//
+// Created by Dániel Molnár on 2019-10-29.
+//
+
+#pragma once
+#ifndef VULKANENGINE_SHADERMODULECACHE_HPP
+#define VULKANENGINE_SHADERMODULECACHE_HPP
+
+// ----- std -----
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+#include <Core/FileManager/BinaryFile.hpp>
+#include <Core/FileManager/FileManager.hpp>
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+class ShaderCompiler;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Shader modules shared by every pipeline on the device. The SPIR-V of each
+// file is read once and kept in memory, and modules are keyed by the hash of
+// their code, so files with the same content share one module as well.
+// Unreferenced modules stay alive until trim is called, so pipelines which
+// are recreated do not recreate their modules.
+// With Configuration::CompileShadersAtRuntime the GLSL sources are compiled
+// instead of loading the prebuilt SPIR-V, when they can be found, and edited
+// sources can be recompiled while running.
+class ShaderModuleCache {
+   public:
+    struct Statistics {
+        unsigned int files_loaded = 0;
+        unsigned int files_compiled = 0;
+        unsigned int files_reloaded = 0;
+        unsigned int modules_created = 0;
+        unsigned int hits = 0;
+        std::chrono::steady_clock::duration load_time{};
+        std::chrono::steady_clock::duration compile_time{};
+    };
+
+   private:
+    struct File {
+        std::uint64_t hash;
+        Core::BinaryFile::ByteSequence code;
+
+        // Empty when loaded from prebuilt SPIR-V
+        std::filesystem::path source;
+        std::filesystem::file_time_type source_time;
+    };
+
+    struct Module {
+        VkShaderModule module;
+        unsigned int references;
+    };
+
+    const LogicalDevice& _logical_device;
+    Core::FileManager _file_manager;
+    std::unique_ptr<ShaderCompiler> _compiler;
+
+    // Pipelines are compiled on several threads
+    mutable std::mutex _guard;
+
+    std::unordered_map<std::string, File> _files;
+    // Recompiled files, waiting for apply_reloads
+    std::unordered_map<std::string, File> _reloaded;
+    std::unordered_map<std::uint64_t, Module> _modules;
+    std::unordered_map<VkShaderModule, std::uint64_t> _hashes;
+
+    Statistics _statistics;
+
+    // Compiled or read without holding the lock, which is released meanwhile
+    [[nodiscard]] File load(const std::string& file_name) const;
+    // The lock has to be held, it is released while loading a new file
+    [[nodiscard]] const File& file(const std::string& file_name,
+                                   std::unique_lock<std::mutex>& lock);
+    [[nodiscard]] std::filesystem::path source_of(
+        const std::string& file_name) const;
+
+   public:
+    explicit ShaderModuleCache(const LogicalDevice& logical_device);
+    ~ShaderModuleCache();
+
+    ShaderModuleCache(const ShaderModuleCache&) = delete;
+    ShaderModuleCache& operator=(const ShaderModuleCache&) = delete;
+
+    // The module has to be released by the caller
+    [[nodiscard]] VkShaderModule acquire(const std::string& file_name);
+    void release(VkShaderModule module);
+
+    // The SPIR-V of the file, copied as a reload may replace it
+    [[nodiscard]] Core::BinaryFile::ByteSequence code(
+        const std::string& file_name);
+
+    // Whether loaded files may come from GLSL sources, and be reloaded
+    [[nodiscard]] bool compiles_sources() const { return _compiler != nullptr; }
+
+    // Recompiles the sources edited since they were compiled last. The new
+    // code is only used after apply_reloads, compile errors are reported and
+    // the previous code stays in use. Called by the ShaderWatcher thread.
+    void recompile_changed();
+
+    // Makes the recompiled code visible to new acquires, and returns the
+    // names of the files it belongs to. Pipelines using them have to be
+    // recreated to pick it up.
+    [[nodiscard]] std::vector<std::string> apply_reloads();
+
+    // Destroys the modules nobody references, the SPIR-V is kept
+    void trim();
+
+    [[nodiscard]] Statistics statistics() const;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_SHADERMODULECACHE_HPP
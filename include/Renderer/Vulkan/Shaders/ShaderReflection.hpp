@@ -0,0 +1,103 @@
+//
+// Created by Dániel Molnár on 2019-10-30.
+//
+
+#pragma once
+#ifndef VULKANENGINE_SHADERREFLECTION_HPP
+#define VULKANENGINE_SHADERREFLECTION_HPP
+
+// ----- std -----
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Pipelines/IPipeline.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderStage.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+}
+
+namespace Vulkan {
+// The resource interface of a single SPIR-V module: the descriptors it
+// binds, the range of its push constant block and, for vertex shaders, the
+// locations and formats of its inputs.
+class ShaderReflection {
+   public:
+    struct Binding {
+        unsigned int set;
+        // Runtime arrays have a descriptorCount of 0
+        VkDescriptorSetLayoutBinding layout;
+    };
+
+    struct Input {
+        unsigned int location;
+        VkFormat format;
+    };
+
+   private:
+    VkShaderStageFlagBits _stage;
+    std::vector<Binding> _bindings;
+    std::vector<Input> _inputs;
+    std::uint32_t _push_constant_offset = 0;
+    std::uint32_t _push_constant_size = 0;
+
+   public:
+    explicit ShaderReflection(const std::vector<std::byte>& code);
+
+    [[nodiscard]] VkShaderStageFlagBits stage() const { return _stage; }
+    [[nodiscard]] const std::vector<Binding>& bindings() const {
+        return _bindings;
+    }
+    [[nodiscard]] const std::vector<Input>& inputs() const { return _inputs; }
+    // Stages sharing push constants place their blocks at different offsets
+    [[nodiscard]] std::uint32_t push_constant_offset() const {
+        return _push_constant_offset;
+    }
+    [[nodiscard]] std::uint32_t push_constant_size() const {
+        return _push_constant_size;
+    }
+};
+
+// The interface of every stage of a pipeline merged together, the source of
+// its descriptor set layouts, push constant ranges and vertex attributes.
+class ShaderInterface {
+   private:
+    std::map<unsigned int, std::vector<VkDescriptorSetLayoutBinding>> _sets;
+    IPipeline::PushConstantContainer _push_constants;
+    std::vector<ShaderReflection::Input> _vertex_inputs;
+
+   public:
+    explicit ShaderInterface(const std::vector<ShaderReflection>& stages);
+
+    [[nodiscard]] static ShaderInterface Reflect(
+        LogicalDevice& logical_device, const std::vector<ShaderStage>& stages);
+
+    // SPIR-V does not tell dynamic buffers apart, they are marked by hand
+    void make_dynamic(unsigned int set, unsigned int binding);
+
+    // Sorted by binding, empty for sets no stage uses
+    [[nodiscard]] std::vector<VkDescriptorSetLayoutBinding> set_bindings(
+        unsigned int set) const;
+
+    // One range per stage with a push constant block
+    [[nodiscard]] const IPipeline::PushConstantContainer& push_constants()
+        const {
+        return _push_constants;
+    }
+
+    // The declared attributes of the locations the vertex stage reads, the
+    // declarations provide the buffer layout. Throws when the stage reads a
+    // location which is not declared.
+    [[nodiscard]] IPipeline::VertexAttribDescContainer vertex_attributes(
+        const IPipeline::VertexAttribDescContainer& declared) const;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_SHADERREFLECTION_HPP
@@ -0,0 +1,52 @@
+//
+// Created by Dániel Molnár on 2019-10-28.
+//
+
+#pragma once
+#ifndef VULKANENGINE_SHADERSTAGE_HPP
+#define VULKANENGINE_SHADERSTAGE_HPP
+
+// ----- std -----
+#include <memory>
+#include <string>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/Shaders/IShader.hpp>
+#include <Renderer/Vulkan/Shaders/SpecializationConstants.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+}
+
+namespace Vulkan {
+// Describes a shader of a pipeline without loading it, so pipelines can be
+// identified before any of their modules exist
+struct ShaderStage {
+    VkShaderStageFlagBits stage;
+    std::string file_name;
+    std::string entry_point = "main";
+
+    // Constant ids the module does not declare are ignored by the driver
+    SpecializationConstants specialization = {};
+
+    [[nodiscard]] bool operator==(const ShaderStage& other) const {
+        return stage == other.stage && file_name == other.file_name &&
+               entry_point == other.entry_point &&
+               specialization == other.specialization;
+    }
+
+    // Creates the module of the stage
+    [[nodiscard]] std::unique_ptr<IShader> load(
+        LogicalDevice& logical_device) const;
+
+    // The vertex shader of the scene pipelines, as it takes the model matrix
+    // according to Configuration::ObjectData
+    [[nodiscard]] static ShaderStage SceneVertex();
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_SHADERSTAGE_HPP
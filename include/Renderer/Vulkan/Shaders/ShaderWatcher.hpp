@@ -0,0 +1,51 @@
+//
+// Created by Dániel Molnár on 2019-11-01.
+//
+
+#pragma once
+#ifndef VULKANENGINE_SHADERWATCHER_HPP
+#define VULKANENGINE_SHADERWATCHER_HPP
+
+// ----- std -----
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+namespace Vulkan {
+class ShaderModuleCache;
+}
+
+namespace Vulkan {
+// Polls the sources of the loaded shaders on a background thread, and
+// recompiles the edited ones. The renderer picks the results up with
+// ShaderModuleCache::apply_reloads at a frame boundary.
+class ShaderWatcher {
+   private:
+    ShaderModuleCache& _shader_modules;
+    std::chrono::milliseconds _interval;
+
+    std::mutex _guard;
+    std::condition_variable _stop_requested;
+    bool _stopping = false;
+
+    std::thread _thread;
+
+    void watch();
+
+   public:
+    ShaderWatcher(ShaderModuleCache& shader_modules,
+                  std::chrono::milliseconds interval);
+    ~ShaderWatcher();
+
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_SHADERWATCHER_HPP
@@ -0,0 +1,83 @@
+//
+// Created by Dániel Molnár on 2019-10-31.
+//
+
+#pragma once
+#ifndef VULKANENGINE_SPECIALIZATIONCONSTANTS_HPP
+#define VULKANENGINE_SPECIALIZATIONCONSTANTS_HPP
+
+// ----- std -----
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+
+// ----- forward-decl -----
+
+namespace Vulkan {
+// Specialization of a pipeline without constants
+struct NoSpecialization {
+    static constexpr std::array<VkSpecializationMapEntry, 0> Entries() {
+        return {};
+    }
+};
+
+// The values of the specialization constants of a shader stage, together
+// with their layout. Built from a description struct, which holds the values
+// as members, and lists them with their constant ids in a constexpr
+// Entries() function:
+//
+//     struct Specialization {
+//         VkBool32 alpha_test = VK_FALSE;
+//
+//         static constexpr std::array<VkSpecializationMapEntry, 1> Entries();
+//     };
+class SpecializationConstants {
+   private:
+    std::vector<VkSpecializationMapEntry> _entries;
+    std::vector<std::byte> _data;
+
+   public:
+    SpecializationConstants() = default;
+
+    template <class Description>
+    static SpecializationConstants From(const Description& description) {
+        static_assert(std::is_trivially_copyable_v<Description>,
+                      "Specialization descriptions are copied bytewise");
+
+        SpecializationConstants constants;
+        const auto entries = Description::Entries();
+        if (entries.empty()) {
+            return constants;
+        }
+
+        constants._entries.assign(entries.begin(), entries.end());
+        constants._data.resize(sizeof(Description));
+        std::memcpy(constants._data.data(), &description, sizeof(Description));
+        return constants;
+    }
+
+    // The returned info points into the constants, it is valid as long as
+    // they are neither modified nor destroyed
+    [[nodiscard]] VkSpecializationInfo info() const;
+
+    [[nodiscard]] bool empty() const { return _entries.empty(); }
+    [[nodiscard]] std::uint64_t hash(std::uint64_t seed) const;
+
+    // Compares the values of the constants only, so descriptions differing
+    // in padding are still equal
+    [[nodiscard]] bool operator==(const SpecializationConstants& other) const;
+    [[nodiscard]] bool operator!=(const SpecializationConstants& other) const {
+        return !(*this == other);
+    }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_SPECIALIZATIONCONSTANTS_HPP
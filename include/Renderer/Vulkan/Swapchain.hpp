@@ -8,6 +8,7 @@
 
 // ----- std -----
 #include <memory>
+#include <string>
 #include <vector>
 
 // ----- libraries -----
@@ -19,7 +20,9 @@
 #include <Renderer/Vulkan/ImageView.hpp>
 #include <Renderer/Vulkan/Images.hpp>
 #include <Renderer/Vulkan/Pipelines/IPipeline.hpp>
+#include <Renderer/Vulkan/Pipelines/PipelineRegistry.hpp>
 #include <Renderer/Vulkan/RenderPass.hpp>
+#include <configuration.hpp>
 
 // ----- forward-decl -----
 
@@ -43,7 +46,11 @@ class Swapchain {
     VkExtent2D _extent;
     VkFormat _format;
 
+    PresentPolicy _present_policy = Configuration::Presentation;
+    VkPresentModeKHR _present_mode;
+
     VkSharingMode _image_sharing_mode;
+    VkImageUsageFlags _image_usage;
 
     std::vector<SwapchainImage> _images;
     std::vector<std::unique_ptr<ImageView>> _image_views;
@@ -51,10 +58,13 @@ class Swapchain {
 
     std::unique_ptr<RenderPass> _render_pass;
     std::vector<std::unique_ptr<IPipeline>> _pipelines;
+    PipelineRegistry _pipeline_registry;
 
+    // Only for one-time transfers, frames record into their own pools
     CommandPool _command_pool;
 
-    void create();
+    // The old swapchain is retired, but has to be destroyed by the caller
+    void create(VkSwapchainKHR old_swapchain = VK_NULL_HANDLE);
     void teardown();
 
    public:
@@ -62,8 +72,20 @@ class Swapchain {
               LogicalDevice& logical_device);
     ~Swapchain();
 
+    // The device has to be idle, the old swapchain is handed over to the
+    // new one, so the presentation engine can switch without a gap
     void recreate();
 
+    // Takes effect at the next recreate()
+    void set_present_policy(PresentPolicy policy) { _present_policy = policy; }
+    [[nodiscard]] PresentPolicy present_policy() const {
+        return _present_policy;
+    }
+    // Chosen for the policy from the modes the surface supports
+    [[nodiscard]] VkPresentModeKHR present_mode() const {
+        return _present_mode;
+    }
+
     [[nodiscard]] const Surface& surface() const { return _surface; }
     [[nodiscard]] const PhysicalDevice& physical_device() const {
         return _physical_device;
@@ -82,6 +104,11 @@ class Swapchain {
     [[nodiscard]] const VkSharingMode& image_sharing_mode() const {
         return _image_sharing_mode;
     }
+    // Includes the transfer source usage when the surface allows reading
+    // the presented images back
+    [[nodiscard]] VkImageUsageFlags image_usage() const {
+        return _image_usage;
+    }
 
     [[nodiscard]] const std::vector<Framebuffer>& framebuffers() const {
         return _framebuffers;
@@ -100,6 +127,24 @@ class Swapchain {
         return *ref;
     }
 
+    // Compiles the pipeline in the background, the fallback is used until it
+    // is ready. Equal requests share the same variant.
+    template <class PipelineType>
+    std::shared_ptr<const PipelineVariant> request_pipeline(
+        const std::vector<VkDescriptorSetLayout>& layouts,
+        const IPipeline* fallback = nullptr,
+        const typename PipelineType::Specialization& specialization = {}) {
+        return _pipeline_registry.request(
+            PipelineType::State(
+                *this, layouts,
+                SpecializationConstants::From(specialization)),
+            fallback);
+    }
+
+    // Recreates the pipelines using any of the SPIR-V files, after their code
+    // was reloaded. The device has to be idle.
+    void reload_shaders(const std::vector<std::string>& file_names);
+
     VkResult acquireNextImage(unsigned int& index, VkSemaphore signal);
 
     VkResult present(unsigned int index, VkSemaphore wait);
@@ -7,11 +7,14 @@
 #define VULKANENGINE_TEXTURE2D_HPP
 
 // ----- std -----
+#include <memory>
+#include <vector>
 
 // ----- libraries -----
 
 // ----- in-project dependencies -----
 #include <Asset/Image.hpp>
+#include <Asset/Texture.hpp>
 #include <Renderer/Vulkan/Buffers.hpp>
 #include <Renderer/Vulkan/CommandPool.hpp>
 #include <Renderer/Vulkan/Descriptors/DescriptorSet.hpp>
@@ -19,23 +22,40 @@
 
 // ----- forward-decl -----
 namespace Vulkan {
-class DescriptorPool;
+class BindlessTextureSet;
+class DescriptorAllocator;
 class DescriptorSetLayout;
 }  // namespace Vulkan
 
 namespace Vulkan {
 class Texture2D : public Image {
    private:
-    const Asset::Image& _image_asset;
+    const std::byte* _data;
+    VkDeviceSize _data_size;
+    VkDeviceSize _texel_block_size;
+    std::vector<Asset::MipLevel> _levels;
+    unsigned int _first_mip = 0;
+
     std::unique_ptr<ImageView> _view;
-    DescriptorPool* _descriptor_pool;
-    DescriptorSetLayout* _descriptor_set_layout;
-    DescriptorSet* _descriptor_set;
+    DescriptorAllocator* _descriptor_allocator = nullptr;
+    DescriptorSetLayout* _descriptor_set_layout = nullptr;
+    DescriptorSet* _descriptor_set = nullptr;
+    VkSampler _sampler = VK_NULL_HANDLE;
+
+    BindlessTextureSet* _bindless_set = nullptr;
+    unsigned int _bindless_index = 0;
+
+    // Same size, format and levels as layout, with nothing staged
+    Texture2D(LogicalDevice& logical_device, const Texture2D& layout);
 
    public:
     Texture2D(LogicalDevice& logical_device, const Asset::Image& image);
+    // Only the levels from first_mip down to the smallest one become
+    // resident, first_mip of the asset is the top level of the image
+    Texture2D(LogicalDevice& logical_device, const Asset::Texture& texture,
+              unsigned int first_mip = 0);
 
-    ~Texture2D() override = default;
+    ~Texture2D() override;
 
     [[nodiscard]] VkImageViewType view_type() const override {
         return VK_IMAGE_VIEW_TYPE_2D;
@@ -44,14 +64,39 @@ class Texture2D : public Image {
     void transfer(TempCommandBuffer& command_buffer, VkQueue queue);
 
     SubBufferDescriptor pre_stage(PolymorphBuffer<StagingBufferTag>& stage);
-    void stage(TempCommandBuffer& command_buffer,
+    void stage(VkCommandBuffer command_buffer,
                PolymorphBuffer<StagingBufferTag>& stage,
                const SubBufferDescriptor& desc);
 
-    void attach_desc_pool(DescriptorPool* pool, DescriptorSetLayout* layout,
-                          VkSampler sampler);
+    // The set is released with the texture, or when attached again
+    void attach_descriptors(DescriptorAllocator* allocator,
+                            DescriptorSetLayout* layout, VkSampler sampler);
 
     VkDescriptorSet desc_handle() const;
+
+    // Alternative to attach_descriptors, the texture takes a slot in set
+    void attach_bindless(BindlessTextureSet* set, VkSampler sampler);
+    [[nodiscard]] unsigned int bindless_index() const {
+        return _bindless_index;
+    }
+
+    [[nodiscard]] unsigned int first_mip() const { return _first_mip; }
+    [[nodiscard]] VkDeviceSize resident_size() const { return _data_size; }
+
+    // Takes over the image of other, which has to be staged and in shader
+    // read layout already. Sets in use are never rewritten: the texture gets
+    // a new descriptor set (or bindless slot) for the new view, to be bound
+    // by the command buffers recorded from now on. other receives the
+    // previous image together with the previous set, and has to live until
+    // no submitted command buffer uses them.
+    void swap_residency(Texture2D& other);
+
+    // Records a copy of the resident levels to an image bound to memory
+    // requested now, and swaps it in like swap_residency. The returned
+    // texture receives the previous image, and has to live until the copy is
+    // finished.
+    [[nodiscard]] std::unique_ptr<Texture2D> relocate(
+        VkCommandBuffer command_buffer);
 };
 }  // namespace Vulkan
 
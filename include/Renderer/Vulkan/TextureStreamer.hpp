@@ -0,0 +1,136 @@
+//
+// Created by Dániel Molnár on 2019-10-22.
+//
+
+#pragma once
+#ifndef VULKANENGINE_TEXTURESTREAMER_HPP
+#define VULKANENGINE_TEXTURESTREAMER_HPP
+
+// ----- std -----
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Asset/Texture.hpp>
+#include <Renderer/Vulkan/Buffers.hpp>
+#include <configuration.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class GpuProfiler;
+class LogicalDevice;
+class Texture2D;
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Keeps the mip chains of textures partially resident. Textures start out
+// with their smallest levels only, higher levels are streamed in as the
+// reported screen space usage asks for them, and the top levels of the least
+// recently used textures are evicted whenever the budget runs out.
+// Residency changes are planned at end_frame, and their levels are uploaded
+// by the command buffer of the frame in record. The new images are swapped
+// in by begin_frame when the frame comes around again, the replaced ones are
+// kept for another round of frames, so streaming never waits for the device.
+// Only one upload is in flight at a time.
+class TextureStreamer {
+   private:
+    struct Entry {
+        const Asset::Texture* asset;
+        Texture2D* texture;
+
+        // Levels above this one may be evicted
+        unsigned int min_first_mip;
+        unsigned int desired_first_mip;
+
+        // Largest on-screen size reported since the last end_frame, in pixels
+        float screen_size = 0.0f;
+        uint64_t last_used_frame = 0;
+    };
+
+    struct Change {
+        Entry* entry;
+        unsigned int first_mip;
+    };
+
+    // Everything a frame in flight may still use
+    struct FrameSlot {
+        // Recorded into the command buffer of the frame
+        std::unique_ptr<PolymorphBuffer<StagingBufferTag>> stage;
+        std::vector<Change> changes;
+        std::vector<std::unique_ptr<Texture2D>> replacements;
+
+        // Hold the images and descriptors swapped out when the frame came
+        // around the last time
+        std::vector<std::unique_ptr<Texture2D>> retired;
+    };
+
+    LogicalDevice& _logical_device;
+
+    VkDeviceSize _budget;
+    VkDeviceSize _upload_limit;
+
+    // Textures are created while changes are in flight, a deque keeps the
+    // entries the changes point to in place
+    std::deque<Entry> _entries;
+    std::vector<Change> _pending;
+
+    std::vector<FrameSlot> _slots;
+    unsigned int _current = 0;
+    bool _uploading = false;
+
+    uint64_t _frame = 0;
+    VkDeviceSize _uploaded_size = 0;
+
+    [[nodiscard]] Entry& entry_of(const Texture2D& texture);
+    void fit_budget();
+    void plan();
+
+   public:
+    TextureStreamer(
+        LogicalDevice& logical_device, unsigned int frame_count,
+        VkDeviceSize budget = Configuration::TextureStreamingBudget,
+        VkDeviceSize upload_limit = Configuration::TextureStreamingUploadLimit);
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Creates the texture with its smallest levels resident. The asset and
+    // the texture have to outlive the streamer.
+    [[nodiscard]] std::unique_ptr<Texture2D> create(
+        const Asset::Texture& texture);
+
+    // screen_size is the height of the area the texture covers, in pixels
+    void report_usage(const Texture2D& texture, float screen_size);
+
+    // The frame was waited for. Releases the images retired when it came
+    // around the last time, and swaps in the levels it uploaded. Returns
+    // whether the residency of any texture changed.
+    bool begin_frame(unsigned int frame);
+
+    // Plans the residency changes based on the usage of the last frame,
+    // returns whether there is anything to record. Nothing is planned while
+    // an upload is in flight.
+    bool end_frame();
+
+    // Records the upload of the planned levels into the command buffer of
+    // the current frame, timed when a profiler is given
+    void record(VkCommandBuffer command_buffer,
+                GpuProfiler* profiler = nullptr);
+
+    // Drops the uploads in flight and the retired images, the device has to
+    // be idle. Has to happen before their descriptors are destroyed.
+    void release();
+
+    [[nodiscard]] VkDeviceSize budget() const { return _budget; }
+    [[nodiscard]] VkDeviceSize resident_size() const;
+    // Staged by all commits so far, in bytes
+    [[nodiscard]] VkDeviceSize uploaded_size() const { return _uploaded_size; }
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_TEXTURESTREAMER_HPP
@@ -0,0 +1,118 @@
+//
+// Created by Dániel Molnár on 2019-11-11.
+//
+
+#pragma once
+#ifndef VULKANENGINE_TRANSIENTATTACHMENTS_HPP
+#define VULKANENGINE_TRANSIENTATTACHMENTS_HPP
+
+// ----- std -----
+#include <memory>
+#include <string>
+#include <vector>
+
+// ----- libraries -----
+#include <vulkan/vulkan_core.h>
+
+// ----- in-project dependencies -----
+#include <Renderer/Vulkan/ImageView.hpp>
+#include <Renderer/Vulkan/Images.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class LogicalDevice;
+class PhysicalDevice;
+namespace Memory {
+class Block;
+}
+}  // namespace Vulkan
+
+namespace Vulkan {
+// Render targets living within a frame, e.g. depth, intermediate color and
+// HDR buffers. Their lifetimes are given as the first and last pass using
+// them, out of the pass order declared up front, and attachments with
+// lifetimes not overlapping share the same device memory.
+// Attachments used within a single pass, as attachments only, are created
+// transient, in lazily allocated memory when the device has such, so tiled
+// GPUs may not back them at all.
+// The contents of an aliased attachment are undefined at its first pass, it
+// has to start from the undefined layout, after a barrier on the memory
+// against the last pass of the previous attachment.
+// Attachments the driver requires dedicated memory for are not aliased.
+class TransientAttachments {
+   private:
+    struct Attachment {
+        std::string name;
+        VkFormat format;
+        VkImageUsageFlags usage;
+        unsigned int first_pass;
+        unsigned int last_pass;
+
+        std::unique_ptr<AttachmentImage> image;
+        std::unique_ptr<ImageView> view;
+        // Required by the image alone
+        VkDeviceSize size = 0;
+        // Memory of its own, instead of a slot
+        const Memory::Block* dedicated = nullptr;
+    };
+
+    // Memory shared by attachments, the requirements of all of them combined
+    struct Slot {
+        VkMemoryRequirements requirements;
+        VkMemoryPropertyFlags properties;
+        // Indices of the attachments
+        std::vector<unsigned int> attachments;
+        const Memory::Block* block = nullptr;
+    };
+
+    const PhysicalDevice& _physical_device;
+    LogicalDevice& _logical_device;
+
+    std::vector<std::string> _passes;
+    std::vector<Attachment> _attachments;
+    std::vector<Slot> _slots;
+
+    // The device has a lazily allocated memory type
+    bool _lazily_allocated;
+
+    [[nodiscard]] unsigned int pass_index(const std::string& pass) const;
+    [[nodiscard]] bool transient(const Attachment& attachment) const;
+    void release();
+
+   public:
+    // Throws std::invalid_argument when a pass is listed twice
+    TransientAttachments(const PhysicalDevice& physical_device,
+                         LogicalDevice& logical_device,
+                         std::vector<std::string> pass_order);
+    ~TransientAttachments();
+
+    TransientAttachments(const TransientAttachments&) = delete;
+    TransientAttachments& operator=(const TransientAttachments&) = delete;
+
+    // Returns the index of the attachment, created by the next create. Throws
+    // std::invalid_argument for unknown passes, or the last one preceding
+    // the first.
+    unsigned int declare(const std::string& name, VkFormat format,
+                         VkImageUsageFlags usage,
+                         const std::string& first_pass,
+                         const std::string& last_pass);
+
+    // Recreates every attachment with the extent, the previous ones may not
+    // be in use anymore
+    void create(VkExtent2D extent);
+
+    [[nodiscard]] AttachmentImage& image(unsigned int attachment) const {
+        return *_attachments.at(attachment).image;
+    }
+    [[nodiscard]] ImageView& view(unsigned int attachment) const {
+        return *_attachments.at(attachment).view;
+    }
+
+    // Device memory taken by the attachments, and what it would be without
+    // aliasing, in bytes
+    [[nodiscard]] VkDeviceSize size() const;
+    [[nodiscard]] VkDeviceSize unaliased_size() const;
+};
+}  // namespace Vulkan
+
+#endif  // VULKANENGINE_TRANSIENTATTACHMENTS_HPP
@@ -68,9 +68,6 @@ VkFormat FindDepthFormat(const PhysicalDevice& physical_device);
 VkFormat FindDepthFormat(VkPhysicalDevice physical_device);
 
 bool HasStencilFormat(VkFormat format);
-
-VkShaderModule CreateShaderModule(const Vulkan::LogicalDevice& logical_device,
-                                  const Core::BinaryFile::ByteSequence& code);
 }  // namespace Vulkan::Utils
 
 #endif  // VULKANENGINE_UTILS_HPP
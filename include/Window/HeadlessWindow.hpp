@@ -0,0 +1,69 @@
+//
+// Created by Dániel Molnár on 2019-11-05.
+//
+
+#pragma once
+#ifndef VULKANENGINE_HEADLESSWINDOW_HPP
+#define VULKANENGINE_HEADLESSWINDOW_HPP
+
+// ----- std -----
+#include <optional>
+#include <utility>
+
+// ----- libraries -----
+#include <vulkan/vulkan.h>
+
+// ----- in-project dependencies -----
+#include <Window/IWindow.hpp>
+
+// ----- forward-decl -----
+namespace Vulkan {
+class Renderer;
+}
+
+// Window without a display, backed by a VK_EXT_headless_surface. Its size
+// only changes when asked to, and it asks to be closed after a fixed number
+// of frames, so every run renders exactly the same.
+class HeadlessWindow : public IWindow {
+   private:
+    int _width;
+    int _height;
+
+    const unsigned int _frame_count;
+    unsigned int _frames_rendered = 0;
+
+   public:
+    HeadlessWindow(unsigned width, unsigned height, unsigned int frame_count);
+
+    virtual ~HeadlessWindow() = default;
+
+    std::optional<VkSurfaceKHR> create_surface(
+        Vulkan::Renderer& renderer) const override;
+
+    [[nodiscard]] std::pair<int, int> size() const override {
+        return {_width, _height};
+    }
+
+    [[nodiscard]] int width() const override { return _width; }
+    [[nodiscard]] int height() const override { return _height; }
+
+    [[nodiscard]] bool should_close() const override {
+        return _frames_rendered >= _frame_count;
+    }
+
+    [[nodiscard]] unsigned int frames_rendered() const {
+        return _frames_rendered;
+    }
+
+    // The renderer has to be told through resized(), the surface reports no
+    // extent of its own
+    void resize(unsigned width, unsigned height) {
+        _width = static_cast<int>(width);
+        _height = static_cast<int>(height);
+    }
+
+    // Called by the service once per rendered frame
+    void frame_rendered() { ++_frames_rendered; }
+};
+
+#endif  // VULKANENGINE_HEADLESSWINDOW_HPP
@@ -0,0 +1,45 @@
+//
+// Created by Dániel Molnár on 2019-11-05.
+//
+
+#pragma once
+#ifndef VULKANENGINE_HEADLESSWINDOWSERVICE_HPP
+#define VULKANENGINE_HEADLESSWINDOWSERVICE_HPP
+
+// ----- std -----
+#include <memory>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies -----
+#include <Window/HeadlessWindow.hpp>
+#include <Window/IWindowService.hpp>
+
+// ----- forward-decl -----
+
+// Window service for machines without a display, e.g. CI runners rendering
+// with lavapipe or SwiftShader. Needs no windowing library, only an instance
+// supporting VK_EXT_headless_surface.
+class HeadlessWindowService : public IWindowService {
+   private:
+    const unsigned int _frame_count;
+    std::vector<std::shared_ptr<HeadlessWindow>> _windows;
+
+   public:
+    // Every spawned window closes after frame_count frames
+    explicit HeadlessWindowService(unsigned int frame_count);
+    virtual ~HeadlessWindowService() = default;
+
+    std::shared_ptr<IWindow> spawn_window(unsigned width, unsigned height,
+                                          const std::string& title) override;
+
+    void pre_render_hook() override;
+    void post_render_hook() override;
+
+    void setup(RendererType) override;
+
+    std::pair<unsigned int, const char**> get_extensions() const override;
+};
+
+#endif  // VULKANENGINE_HEADLESSWINDOWSERVICE_HPP
@@ -21,6 +21,8 @@ class IWindowService {
         Vulkan
     };
 
+    virtual ~IWindowService() = default;
+
     virtual std::shared_ptr<IWindow> spawn_window(unsigned width,
                                                   unsigned height,
                                                   const std::string& title) = 0;
@@ -1,6 +1,41 @@
 #ifndef _VULKANENGINE_CONFIGURATION_HPP_
 #define _VULKANENGINE_CONFIGURATION_HPP_
 
+// How the model matrix of every object reaches the vertex shader
+enum class ObjectDataStrategy {
+    // One slot per object, the scene set is rebound at its offset per draw
+    DynamicUniformBuffer,
+    // Pushed per draw while the command buffer of the frame is recorded
+    PushConstants,
+    // One array for all objects, indexed by the first instance of the draw
+    StorageBuffer
+};
+
+// Order of the main loop
+enum class FramePacing {
+    // Input is polled first, then the frame waits for its slot on the device
+    Throughput,
+    // The frame slot is waited for before polling input, so the input is as
+    // fresh as possible when the frame is recorded and submitted
+    LowLatency
+};
+
+// How finished frames reach the screen, see the README for the trade-offs.
+// An extra swapchain image costs a full color target, ~8 MB at 1080p.
+enum class PresentPolicy {
+    // Mailbox with one image more than the minimum, usually 3. No tearing,
+    // the newest frame is shown at the next vertical blank, but frames that
+    // are never shown are still rendered.
+    LowLatency,
+    // FIFO with the fewest images the surface allows, usually 2. Renders at
+    // the refresh rate and saves memory, frames can queue up behind the
+    // vertical blank, which adds up to a refresh interval of latency each.
+    VSync,
+    // Immediate with one image more than the minimum. No waiting at all and
+    // the lowest latency, at the cost of tearing.
+    Uncapped
+};
+
 namespace Configuration {
 #if NDEBUG
 constexpr const bool Debug = false;
@@ -9,8 +44,90 @@ constexpr const bool Debug = true;
 #endif
 constexpr const bool EnableVulkanValidationLayers = Debug;
 constexpr const unsigned int CommandPoolBatchSize = 2;
+// Frames recorded while earlier ones are still rendered, 1 to 4. More of them
+// keep the device busy at the cost of input latency.
+constexpr const unsigned int FramesInFlight = 2;
+constexpr const FramePacing Pacing = FramePacing::Throughput;
+// Falls back to FIFO when the surface does not support the preferred mode,
+// switchable at runtime with Vulkan::Renderer::set_present_policy
+constexpr const PresentPolicy Presentation = PresentPolicy::LowLatency;
+// Upper limit of the frame rate of the main loop, 0 disables the limiter
+constexpr const unsigned int FrameRateLimit = 0;
+// Simulation time between two frames rendered headless, in milliseconds, so
+// every run renders the same images
+constexpr const unsigned int HeadlessFrameTime = 16;
+// CPU trace zones, counters and flows, recorded only between
+// Profiling::Start and Profiling::Stop. Turning it off compiles them out.
+constexpr const bool Tracing = true;
+// Size of the ring buffer of every thread, the oldest events are overwritten
+constexpr const unsigned long TraceEventsPerThread = 1ul << 16u;
+// Timestamped scopes a frame may record, the rest are not measured
+constexpr const unsigned int GpuScopesPerFrame = 16;
+// Durations kept per GPU scope label for the rolling statistics
+constexpr const unsigned long GpuTimingHistory = 256;
+// Device memory is allocated in chunks per memory type, starting at the base
+// size and doubling with every chunk, up to the max size or an eighth of the
+// heap. Both have to be powers of two.
+constexpr const unsigned long long MemoryChunkBaseSize = 16ull << 20u;
+constexpr const unsigned long long MemoryChunkMaxSize = 256ull << 20u;
+// Resources at least this large get device memory of their own
+constexpr const unsigned long long DedicatedAllocationSize = 32ull << 20u;
+// Blocks up to this size released by a thread are kept for its next
+// requests, at most the capacity per thread. Threads beyond the cache count
+// share caches.
+constexpr const unsigned long long AllocatorCachedBlockSize = 64ull << 10u;
+constexpr const unsigned int AllocatorCacheCapacity = 32;
+constexpr const unsigned int AllocatorThreadCaches = 8;
+// Chunks used up to this share are emptied by moving textures and geometry
+// elsewhere, 0 disables defragmentation
+constexpr const double DefragmentationOccupancy = 0.25;
+// Resource data moved by the defragmenter in a single frame, in bytes, at
+// least one resource is moved regardless
+constexpr const unsigned long long DefragmentationBudget = 8ull << 20u;
+// Frames between looking for chunks to empty, while none are being emptied
+constexpr const unsigned int DefragmentationInterval = 60;
+// Sets in the first descriptor pool, chained pools grow from there
+constexpr const unsigned long DescriptorSetsPerPool = 64;
+// Encode textures to BC7 at import time when the device supports it
+constexpr const bool CompressTextures = true;
+constexpr const char* const TextureCacheDirectory = "texture_cache";
+// Sample textures from one descriptor array indexed per draw, when supported
+constexpr const bool BindlessTextures = true;
+// Upper limit of the bindless texture array, clamped to the device limits
+constexpr const unsigned int BindlessTextureCapacity = 4096;
+// Device memory the texture streamer may fill with texel data, in bytes
+constexpr const unsigned long long TextureStreamingBudget = 256ull << 20u;
+// Texel data uploaded by the texture streamer in a single frame, in bytes
+constexpr const unsigned long long TextureStreamingUploadLimit = 16ull << 20u;
+// Mip levels of this size or smaller are always resident
+constexpr const unsigned int TextureStreamingMinResidentSize = 64;
+// Frames a texture has to stay unseen before its top mips may be evicted
+constexpr const unsigned int TextureStreamingEvictionDelay = 120;
+// Pipeline cache data kept between runs, discarded when the driver changes
+constexpr const char* const PipelineCacheFile = "pipeline_cache.bin";
+// Threads compiling pipeline variants in the background, 0 leaves one
+// hardware thread for the renderer and uses the rest
+constexpr const unsigned int PipelineCompileThreads = 0;
+// Compile the GLSL sources of the shaders when they are found, instead of
+// loading the SPIR-V prebuilt by CMake
+constexpr const bool CompileShadersAtRuntime = Debug;
+constexpr const char* const ShaderCacheDirectory = "shader_cache";
+// Recompile edited shader sources in the background, and recreate the
+// pipelines using them at the next frame
+constexpr const bool ShaderHotReload = CompileShadersAtRuntime;
+// How often the shader sources are checked for changes, in milliseconds
+constexpr const unsigned int ShaderWatchInterval = 500;
+// See benchmark/object_data for the costs of the strategies
+constexpr const ObjectDataStrategy ObjectData =
+    ObjectDataStrategy::DynamicUniformBuffer;
 
 static_assert(CommandPoolBatchSize > 0,
               "Command pool factor should be a positive number");
+static_assert(FramesInFlight >= 1 && FramesInFlight <= 4,
+              "Frames in flight should be between 1 and 4");
+static_assert((MemoryChunkBaseSize & (MemoryChunkBaseSize - 1)) == 0 &&
+                  (MemoryChunkMaxSize & (MemoryChunkMaxSize - 1)) == 0 &&
+                  MemoryChunkBaseSize <= MemoryChunkMaxSize,
+              "Memory chunk sizes should be ascending powers of two");
 }  // namespace Configuration
 #endif
@@ -1,7 +1,10 @@
 #include <iostream>
 
+#include <Profiling/Trace.hpp>
+#include <Renderer/FramePacer.hpp>
 #include <Renderer/Vulkan/Renderer.hpp>
 #include <Window/GLFWWindowService.hpp>
+#include <Window/HeadlessWindowService.hpp>
 
 #include <Core/Logger/StreamLogger.hpp>
 
@@ -9,47 +12,179 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+// Renders frame_count frames as fast as possible, with a fixed simulation
+// step. ENGINE_CAPTURE names a PNG the last frame is written to,
+// ENGINE_FRAME_TIMES a CSV receiving the time of every frame.
+void RenderHeadless(Core::StreamLogger& logger, IWindowService& service,
+                    const IWindow& window, Vulkan::Renderer& renderer,
+                    unsigned int frame_count) {
+    const auto* capture_path = std::getenv("ENGINE_CAPTURE");
+    const auto* frame_times_path = std::getenv("ENGINE_FRAME_TIMES");
+
+    std::vector<double> frame_times;
+    frame_times.reserve(frame_count);
+    for (auto frame = 0u; !window.should_close(); ++frame) {
+        if (capture_path && frame + 1 == frame_count) {
+            renderer.capture(capture_path);
+        }
+
+        service.pre_render_hook();
+        const auto start = std::chrono::steady_clock::now();
+        renderer.render(frame * Configuration::HeadlessFrameTime);
+        frame_times.push_back(std::chrono::duration<double, std::milli>(
+                                  std::chrono::steady_clock::now() - start)
+                                  .count());
+        service.post_render_hook();
+    }
+    if (frame_times.empty()) {
+        return;
+    }
+
+    if (frame_times_path) {
+        std::ofstream file(frame_times_path);
+        file << "frame,milliseconds\n";
+        for (auto i = 0u; i < frame_times.size(); ++i) {
+            file << i << "," << frame_times[i] << "\n";
+        }
+    }
+
+    auto sorted = frame_times;
+    std::sort(sorted.begin(), sorted.end());
+    const auto total =
+        std::accumulate(frame_times.begin(), frame_times.end(), 0.0);
+    logger.info("Frames: " + std::to_string(frame_times.size()) +
+                ", mean: " + std::to_string(total / frame_times.size()) +
+                " ms, median: " + std::to_string(sorted[sorted.size() / 2]) +
+                " ms, max: " + std::to_string(sorted.back()) + " ms");
+}
+}  // namespace
 
 int main() {
     Core::StreamLogger logger(100, std::cout);
 
-    GLFWWindowService window_service;
+    // Records a CPU trace of the whole run, for chrome://tracing
+    Profiling::SetThreadName("Main");
+    const auto* trace_path = std::getenv("ENGINE_TRACE");
+    if (trace_path) {
+        Profiling::Start();
+    }
+    const auto write_trace = [trace_path]() {
+        if (trace_path) {
+            Profiling::Stop();
+            Profiling::Write(trace_path);
+        }
+    };
+
+    // Renders a fixed number of frames without a display, e.g. on CI
+    // machines using lavapipe or SwiftShader
+    unsigned int headless_frames = 0;
+    if (const auto* value = std::getenv("ENGINE_HEADLESS_FRAMES")) {
+        headless_frames = static_cast<unsigned int>(std::stoul(value));
+    }
+
+    std::unique_ptr<IWindowService> window_service;
+    if (headless_frames > 0) {
+        window_service =
+            std::make_unique<HeadlessWindowService>(headless_frames);
+    } else {
+        window_service = std::make_unique<GLFWWindowService>();
+    }
 
 //    try {
-        window_service.setup(IWindowService::RendererType::Vulkan);
-        auto window = window_service.spawn_window(800, 600, "Vulkan engine");
-        Vulkan::Renderer renderer(window_service, window);
+        window_service->setup(IWindowService::RendererType::Vulkan);
+        auto window = window_service->spawn_window(800, 600, "Vulkan engine");
+
+        // Trades input latency for throughput without rebuilding
+        auto frames_in_flight = Configuration::FramesInFlight;
+        if (const auto* value = std::getenv("ENGINE_FRAMES_IN_FLIGHT")) {
+            frames_in_flight = static_cast<unsigned int>(std::stoul(value));
+        }
+        Vulkan::Renderer renderer(*window_service, window, frames_in_flight);
 
         renderer.initialize();
 
+        // Device memory statistics at exit, as JSON
+        const auto* memory_statistics_path = std::getenv("ENGINE_MEMORY_STATS");
+        const auto write_reports = [&]() {
+            write_trace();
+            if (memory_statistics_path) {
+                std::ofstream file(memory_statistics_path);
+                Vulkan::Memory::WriteJson(file,
+                                          renderer.allocator_statistics());
+                file << std::endl;
+            }
+        };
+
+        if (headless_frames > 0) {
+            RenderHeadless(logger, *window_service, *window, renderer,
+                           headless_frames);
+            write_reports();
+            return 0;
+        }
+
+        FramePacer pacer(
+            Configuration::FrameRateLimit > 0
+                ? std::chrono::duration_cast<FramePacer::Clock::duration>(
+                      std::chrono::duration<double>(
+                          1.0 / Configuration::FrameRateLimit))
+                : FramePacer::Clock::duration::zero());
+
         unsigned int frames_rendered = 0;
         using namespace std::chrono_literals;
         auto measured_from = std::chrono::high_resolution_clock::now();
         const auto start_time = measured_from;
         while (!window->should_close()) {
+            pacer.limit();
+            if (Configuration::Pacing == FramePacing::LowLatency) {
+                renderer.wait_for_frame();
+            }
+
+            window_service->pre_render_hook();
+            pacer.input_sampled();
+
+            // Sampled with the input, the simulation matches what was polled
             auto time_now = std::chrono::high_resolution_clock::now();
             auto elapsed_sec = std::chrono::duration_cast<std::chrono::seconds>(
                                    time_now - measured_from)
                                    .count();
 
             frames_rendered++;
-            window_service.pre_render_hook();
 
             renderer.render(
                 std::chrono::duration_cast<std::chrono::milliseconds>(
                     time_now - start_time)
                     .count());
+            pacer.submitted(renderer.last_submit());
 
-            window_service.post_render_hook();
+            window_service->post_render_hook();
 
             if (elapsed_sec > 5) {
+                const auto to_ms = [](FramePacer::Clock::duration duration) {
+                    return std::to_string(
+                        std::chrono::duration<double, std::milli>(duration)
+                            .count());
+                };
                 logger.info("FPS: " +
-                            std::to_string(frames_rendered / elapsed_sec));
+                            std::to_string(frames_rendered / elapsed_sec) +
+                            ", input to submit: " +
+                            to_ms(pacer.average_latency()) + " ms (max " +
+                            to_ms(pacer.max_latency()) + " ms)");
+                pacer.reset_latency();
                 measured_from = std::chrono::high_resolution_clock::now();
                 frames_rendered = 0;
             }
         }
+        write_reports();
     //} catch (std::exception &ex) {
 //        logger.error(ex.what());
     //}
@@ -0,0 +1,486 @@
+//
+// Created by Dániel Molnár on 2019-10-20.
+//
+
+// ----- own header -----
+#include <Asset/BlockCompression.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+// ----- libraries -----
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ----- in-project dependencies
+
+namespace {
+using Asset::BlockCompression::BlockDimension;
+constexpr const unsigned int TexelsPerBlock = BlockDimension * BlockDimension;
+
+// Structure of arrays, so four texels can be processed at once.
+struct BlockTexels {
+    alignas(16) float channel[4][TexelsPerBlock];
+};
+
+struct Endpoints {
+    std::array<float, 4> start;
+    std::array<float, 4> end;
+};
+
+BlockTexels Unpack(const std::uint8_t* texels) {
+    BlockTexels block;
+    for (auto i = 0u; i < TexelsPerBlock; ++i) {
+        for (auto c = 0u; c < 4; ++c) {
+            block.channel[c][i] = texels[i * 4 + c];
+        }
+    }
+    return block;
+}
+
+// Projects every texel onto the axis through mean: t = dot(texel - mean, axis)
+void Project(const BlockTexels& block, const std::array<float, 4>& mean,
+             const std::array<float, 4>& axis, unsigned int channels,
+             float* out) {
+#if defined(__SSE2__)
+    for (auto i = 0u; i < TexelsPerBlock; i += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (auto c = 0u; c < channels; ++c) {
+            __m128 centered = _mm_sub_ps(_mm_load_ps(&block.channel[c][i]),
+                                         _mm_set1_ps(mean[c]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(centered, _mm_set1_ps(axis[c])));
+        }
+        _mm_storeu_ps(out + i, sum);
+    }
+#else
+    for (auto i = 0u; i < TexelsPerBlock; ++i) {
+        out[i] = 0.0f;
+        for (auto c = 0u; c < channels; ++c) {
+            out[i] += (block.channel[c][i] - mean[c]) * axis[c];
+        }
+    }
+#endif
+}
+
+// Principal component analysis of the block colors. The endpoints are the
+// extremes of the texel projections onto the principal axis.
+Endpoints FitEndpoints(const BlockTexels& block, unsigned int channels) {
+    std::array<float, 4> mean = {};
+    std::array<float, 4> min = {255.0f, 255.0f, 255.0f, 255.0f};
+    std::array<float, 4> max = {};
+    for (auto c = 0u; c < channels; ++c) {
+        for (auto i = 0u; i < TexelsPerBlock; ++i) {
+            mean[c] += block.channel[c][i];
+            min[c] = std::min(min[c], block.channel[c][i]);
+            max[c] = std::max(max[c], block.channel[c][i]);
+        }
+        mean[c] /= TexelsPerBlock;
+    }
+
+    float covariance[4][4] = {};
+    for (auto i = 0u; i < TexelsPerBlock; ++i) {
+        for (auto a = 0u; a < channels; ++a) {
+            for (auto b = a; b < channels; ++b) {
+                covariance[a][b] += (block.channel[a][i] - mean[a]) *
+                                    (block.channel[b][i] - mean[b]);
+            }
+        }
+    }
+    for (auto a = 0u; a < channels; ++a) {
+        for (auto b = 0u; b < a; ++b) {
+            covariance[a][b] = covariance[b][a];
+        }
+    }
+
+    std::array<float, 4> axis = {};
+    for (auto c = 0u; c < channels; ++c) axis[c] = max[c] - min[c];
+
+    for (auto iteration = 0; iteration < 8; ++iteration) {
+        std::array<float, 4> next = {};
+        for (auto a = 0u; a < channels; ++a) {
+            for (auto b = 0u; b < channels; ++b) {
+                next[a] += covariance[a][b] * axis[b];
+            }
+        }
+        float length = 0.0f;
+        for (auto c = 0u; c < channels; ++c) length += next[c] * next[c];
+        if (length <= std::numeric_limits<float>::epsilon()) break;
+        length = std::sqrt(length);
+        for (auto c = 0u; c < channels; ++c) axis[c] = next[c] / length;
+    }
+
+    float length = 0.0f;
+    for (auto c = 0u; c < channels; ++c) length += axis[c] * axis[c];
+    if (length <= std::numeric_limits<float>::epsilon()) {
+        // Flat block, both endpoints are the same color
+        return {mean, mean};
+    }
+    length = std::sqrt(length);
+    for (auto c = 0u; c < channels; ++c) axis[c] /= length;
+
+    float projections[TexelsPerBlock];
+    Project(block, mean, axis, channels, projections);
+    const auto [low, high] =
+        std::minmax_element(projections, projections + TexelsPerBlock);
+
+    Endpoints endpoints = {mean, mean};
+    for (auto c = 0u; c < channels; ++c) {
+        endpoints.start[c] =
+            std::clamp(mean[c] + axis[c] * *low, 0.0f, 255.0f);
+        endpoints.end[c] =
+            std::clamp(mean[c] + axis[c] * *high, 0.0f, 255.0f);
+    }
+    return endpoints;
+}
+
+float SquaredDistance(const BlockTexels& block, unsigned int texel,
+                      const std::array<int, 4>& color,
+                      unsigned int channels) {
+    float distance = 0.0f;
+    for (auto c = 0u; c < channels; ++c) {
+        const auto delta = block.channel[c][texel] - color[c];
+        distance += delta * delta;
+    }
+    return distance;
+}
+
+template <size_t PaletteSize>
+unsigned int NearestIndex(const BlockTexels& block, unsigned int texel,
+                          const std::array<std::array<int, 4>, PaletteSize>&
+                              palette,
+                          unsigned int channels) {
+    auto best = 0u;
+    auto best_distance = std::numeric_limits<float>::max();
+    for (auto i = 0u; i < PaletteSize; ++i) {
+        const auto distance =
+            SquaredDistance(block, texel, palette[i], channels);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// ----- BC1 -----
+
+std::uint16_t PackRGB565(const std::array<float, 4>& color) {
+    const auto r = static_cast<unsigned int>(std::lround(color[0] * 31 / 255));
+    const auto g = static_cast<unsigned int>(std::lround(color[1] * 63 / 255));
+    const auto b = static_cast<unsigned int>(std::lround(color[2] * 31 / 255));
+    return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+std::array<int, 4> UnpackRGB565(std::uint16_t color) {
+    const int r = (color >> 11) & 0x1f;
+    const int g = (color >> 5) & 0x3f;
+    const int b = color & 0x1f;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+}
+
+void EncodeColorBlock(const BlockTexels& block, std::uint8_t* out,
+                      bool allow_transparency) {
+    bool has_transparency = false;
+    if (allow_transparency) {
+        for (auto i = 0u; i < TexelsPerBlock; ++i) {
+            has_transparency |= block.channel[3][i] < 128.0f;
+        }
+    }
+
+    const auto endpoints = FitEndpoints(block, 3);
+    auto color0 = PackRGB565(endpoints.end);
+    auto color1 = PackRGB565(endpoints.start);
+
+    // color0 > color1 selects the opaque four color mode, the opposite order
+    // selects three colors and transparent black
+    if ((color0 < color1) != has_transparency) std::swap(color0, color1);
+
+    std::uint32_t indices = 0;
+    if (color0 != color1) {
+        const auto c0 = UnpackRGB565(color0);
+        const auto c1 = UnpackRGB565(color1);
+        std::array<std::array<int, 4>, 4> palette = {c0, c1};
+        for (auto c = 0u; c < 3; ++c) {
+            if (has_transparency) {
+                palette[2][c] = (c0[c] + c1[c]) / 2;
+            } else {
+                palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+                palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+            }
+        }
+
+        for (auto i = 0u; i < TexelsPerBlock; ++i) {
+            std::uint32_t index;
+            if (has_transparency && block.channel[3][i] < 128.0f) {
+                index = 3;
+            } else if (has_transparency) {
+                std::array<std::array<int, 4>, 3> opaque = {
+                    palette[0], palette[1], palette[2]};
+                index = NearestIndex(block, i, opaque, 3);
+            } else {
+                index = NearestIndex(block, i, palette, 3);
+            }
+            indices |= index << (2 * i);
+        }
+    } else if (has_transparency) {
+        for (auto i = 0u; i < TexelsPerBlock; ++i) {
+            if (block.channel[3][i] < 128.0f) indices |= 3u << (2 * i);
+        }
+    }
+
+    out[0] = color0 & 0xff;
+    out[1] = color0 >> 8;
+    out[2] = color1 & 0xff;
+    out[3] = color1 >> 8;
+    for (auto i = 0u; i < 4; ++i) out[4 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+// ----- BC4 -----
+
+void EncodeSingleChannel(const BlockTexels& block, unsigned int channel,
+                         std::uint8_t* out) {
+    const auto [low, high] = std::minmax_element(
+        block.channel[channel], block.channel[channel] + TexelsPerBlock);
+    const auto a0 = static_cast<int>(*high);
+    const auto a1 = static_cast<int>(*low);
+
+    std::uint64_t indices = 0;
+    if (a0 != a1) {
+        // a0 > a1 selects the eight value mode, six values are interpolated
+        std::array<int, 8> palette = {a0, a1};
+        for (auto i = 1; i < 7; ++i) {
+            palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+
+        for (auto i = 0u; i < TexelsPerBlock; ++i) {
+            auto best = 0u;
+            auto best_distance = std::numeric_limits<float>::max();
+            for (auto j = 0u; j < palette.size(); ++j) {
+                const auto distance =
+                    std::abs(block.channel[channel][i] - palette[j]);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = j;
+                }
+            }
+            indices |= static_cast<std::uint64_t>(best) << (3 * i);
+        }
+    }
+
+    out[0] = static_cast<std::uint8_t>(a0);
+    out[1] = static_cast<std::uint8_t>(a1);
+    for (auto i = 0u; i < 6; ++i) out[2 + i] = (indices >> (8 * i)) & 0xff;
+}
+
+// ----- BC7 -----
+
+class BitWriter {
+   private:
+    std::uint8_t* _out;
+    unsigned int _position = 0;
+
+   public:
+    explicit BitWriter(std::uint8_t* out) : _out(out) {
+        std::fill(_out, _out + 16, 0);
+    }
+
+    void write(std::uint32_t value, unsigned int bits) {
+        for (auto i = 0u; i < bits; ++i, ++_position) {
+            if ((value >> i) & 1u) {
+                _out[_position / 8] |= 1u << (_position % 8);
+            }
+        }
+    }
+};
+
+constexpr const std::array<int, 16> BC7Weights = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct QuantizedEndpoint {
+    std::array<int, 4> value;  // 7 bit
+    int p_bit;
+
+    [[nodiscard]] int expanded(unsigned int channel) const {
+        return (value[channel] << 1) | p_bit;
+    }
+};
+
+QuantizedEndpoint QuantizeMode6(const std::array<float, 4>& endpoint) {
+    QuantizedEndpoint best = {};
+    auto best_error = std::numeric_limits<float>::max();
+    for (auto p_bit = 0; p_bit < 2; ++p_bit) {
+        QuantizedEndpoint candidate = {{}, p_bit};
+        float error = 0.0f;
+        for (auto c = 0u; c < 4; ++c) {
+            candidate.value[c] = std::clamp(
+                static_cast<int>(std::lround((endpoint[c] - p_bit) / 2.0f)), 0,
+                127);
+            const auto delta = endpoint[c] - candidate.expanded(c);
+            error += delta * delta;
+        }
+        if (error < best_error) {
+            best_error = error;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+// Mode 6: one subset, RGBA 7.7.7.7 endpoints with unique p-bits and 4 bit
+// indices. It is the best single-mode compromise for smooth color textures.
+void EncodeMode6(const BlockTexels& block, std::uint8_t* out) {
+    const auto endpoints = FitEndpoints(block, 4);
+    auto e0 = QuantizeMode6(endpoints.start);
+    auto e1 = QuantizeMode6(endpoints.end);
+
+    std::array<std::array<int, 4>, 16> palette;
+    for (auto i = 0u; i < palette.size(); ++i) {
+        for (auto c = 0u; c < 4; ++c) {
+            palette[i][c] = ((64 - BC7Weights[i]) * e0.expanded(c) +
+                             BC7Weights[i] * e1.expanded(c) + 32) >>
+                            6;
+        }
+    }
+
+    std::array<unsigned int, TexelsPerBlock> indices;
+    for (auto i = 0u; i < TexelsPerBlock; ++i) {
+        indices[i] = NearestIndex(block, i, palette, 4);
+    }
+
+    // The anchor index is stored with an implicit zero MSB
+    if (indices[0] & 8u) {
+        std::swap(e0, e1);
+        for (auto& index : indices) index = 15 - index;
+    }
+
+    BitWriter writer(out);
+    writer.write(1u << 6, 7);
+    for (auto c = 0u; c < 4; ++c) {
+        writer.write(e0.value[c], 7);
+        writer.write(e1.value[c], 7);
+    }
+    writer.write(e0.p_bit, 1);
+    writer.write(e1.p_bit, 1);
+    writer.write(indices[0], 3);
+    for (auto i = 1u; i < TexelsPerBlock; ++i) writer.write(indices[i], 4);
+}
+
+// Gathers the 4x4 block at (block_x, block_y), replicating the edge texels
+// of images that are not a multiple of the block size.
+void FetchBlock(const std::uint8_t* rgba, unsigned int width,
+                unsigned int height, unsigned int block_x,
+                unsigned int block_y, std::uint8_t* out) {
+    for (auto y = 0u; y < BlockDimension; ++y) {
+        const auto source_y = std::min(block_y * BlockDimension + y, height - 1);
+        for (auto x = 0u; x < BlockDimension; ++x) {
+            const auto source_x =
+                std::min(block_x * BlockDimension + x, width - 1);
+            std::copy_n(rgba + (source_y * width + source_x) * 4, 4,
+                        out + (y * BlockDimension + x) * 4);
+        }
+    }
+}
+
+using BlockEncoder = void (*)(const std::uint8_t*, std::uint8_t*);
+
+BlockEncoder SelectEncoder(Asset::TextureFormat format) {
+    using namespace Asset::BlockCompression;
+    switch (format) {
+        case Asset::TextureFormat::BC1:
+            return EncodeBC1;
+        case Asset::TextureFormat::BC3:
+            return EncodeBC3;
+        case Asset::TextureFormat::BC5:
+            return EncodeBC5;
+        case Asset::TextureFormat::BC7:
+            return EncodeBC7;
+        default:
+            throw std::invalid_argument("Format is not block compressed");
+    }
+}
+}  // namespace
+
+namespace Asset::BlockCompression {
+
+size_t LevelSize(TextureFormat format, unsigned int width,
+                 unsigned int height) {
+    if (!IsCompressed(format)) {
+        return static_cast<size_t>(width) * height * BlockBytes(format);
+    }
+    const size_t blocks_x = (width + BlockDimension - 1) / BlockDimension;
+    const size_t blocks_y = (height + BlockDimension - 1) / BlockDimension;
+    return blocks_x * blocks_y * BlockBytes(format);
+}
+
+void EncodeBC1(const std::uint8_t* texels, std::uint8_t* out) {
+    EncodeColorBlock(Unpack(texels), out, true);
+}
+
+void EncodeBC3(const std::uint8_t* texels, std::uint8_t* out) {
+    const auto block = Unpack(texels);
+    EncodeSingleChannel(block, 3, out);
+    EncodeColorBlock(block, out + 8, false);
+}
+
+void EncodeBC5(const std::uint8_t* texels, std::uint8_t* out) {
+    const auto block = Unpack(texels);
+    EncodeSingleChannel(block, 0, out);
+    EncodeSingleChannel(block, 1, out + 8);
+}
+
+void EncodeBC7(const std::uint8_t* texels, std::uint8_t* out) {
+    EncodeMode6(Unpack(texels), out);
+}
+
+std::vector<std::byte> Compress(const std::byte* rgba, unsigned int width,
+                                unsigned int height, TextureFormat format,
+                                unsigned int thread_count) {
+    const auto encode = SelectEncoder(format);
+    const auto block_bytes = BlockBytes(format);
+    const auto blocks_x = (width + BlockDimension - 1) / BlockDimension;
+    const auto blocks_y = (height + BlockDimension - 1) / BlockDimension;
+
+    std::vector<std::byte> compressed(LevelSize(format, width, height));
+    const auto* source = reinterpret_cast<const std::uint8_t*>(rgba);
+    auto* destination = reinterpret_cast<std::uint8_t*>(compressed.data());
+
+    const auto encode_rows = [&](unsigned int first_row,
+                                 unsigned int last_row) {
+        std::uint8_t texels[TexelsPerBlock * 4];
+        for (auto y = first_row; y < last_row; ++y) {
+            for (auto x = 0u; x < blocks_x; ++x) {
+                FetchBlock(source, width, height, x, y, texels);
+                encode(texels,
+                       destination + (y * blocks_x + x) * block_bytes);
+            }
+        }
+    };
+
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_count = std::min(thread_count, blocks_y);
+
+    if (thread_count <= 1) {
+        encode_rows(0, blocks_y);
+        return compressed;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    const auto rows_per_thread = (blocks_y + thread_count - 1) / thread_count;
+    for (auto first = 0u; first < blocks_y; first += rows_per_thread) {
+        workers.emplace_back(encode_rows, first,
+                             std::min(first + rows_per_thread, blocks_y));
+    }
+    for (auto& worker : workers) worker.join();
+
+    return compressed;
+}
+}  // namespace Asset::BlockCompression
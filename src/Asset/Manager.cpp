@@ -11,16 +11,20 @@
 // ----- libraries -----
 
 // ----- in-project dependencies
+#include <Profiling/Trace.hpp>
 
 namespace Asset {
 
 ID Manager::counter = 0;
 
-Manager::Manager(std::vector<Core::FileManager::Path> search_paths)
-    : _file_manager(std::move(search_paths)) {}
+Manager::Manager(std::vector<Core::FileManager::Path> search_paths,
+                 Core::FileManager::Path cache_directory)
+    : _file_manager(std::move(search_paths)),
+      _cache_directory(std::move(cache_directory)) {}
 
 std::optional<std::reference_wrapper<const Image>> Manager::load_image(
     const std::string& name) {
+    TRACE_ZONE("Asset::Manager::load_image");
     try {
         if (auto path = _file_manager.find(name)) {
             auto [it, success] = _resources.insert(
@@ -39,6 +43,7 @@ std::optional<std::reference_wrapper<const Image>> Manager::load_image(
 
 std::optional<std::reference_wrapper<const Mesh>> Manager::load_mesh(
     const std::string& name) {
+    TRACE_ZONE("Asset::Manager::load_mesh");
     try {
         if (auto path = _file_manager.find(name)) {
             auto [it, success] = _resources.insert(
@@ -54,4 +59,23 @@ std::optional<std::reference_wrapper<const Mesh>> Manager::load_mesh(
     return {};
 }
 
+std::optional<std::reference_wrapper<const Texture>> Manager::load_texture(
+    const std::string& name, TextureFormat format) {
+    TRACE_ZONE("Asset::Manager::load_texture");
+    try {
+        if (auto path = _file_manager.find(name)) {
+            auto [it, success] = _resources.insert(
+                {counter, std::make_unique<Texture>(counter, *path, format,
+                                                    _cache_directory)});
+
+            if (success) {
+                ++counter;
+                return dynamic_cast<const Texture&>(*it->second);
+            }
+        }
+    } catch (std::runtime_error&) {
+    }
+    return {};
+}
+
 }  // namespace Asset
@@ -6,6 +6,8 @@
 #include <Asset/Mesh.hpp>
 
 // ----- std -----
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 // ----- libraries -----
@@ -39,6 +41,9 @@ Mesh::Mesh(ID id, std::string file_name)
         auto [u, v, w] = _has_texture_coords ? mesh->mTextureCoords[0][i]
                                           : aiVector3D{0, 0, 0};
 
+        _bounding_radius =
+            std::max(_bounding_radius, std::sqrt(x * x + y * y + z * z));
+
         Vertex vert = {{x, y, z}, {r, g, b}, {u, v}};
         _vertices.emplace_back(std::move(vert));
     }
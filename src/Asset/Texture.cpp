@@ -0,0 +1,154 @@
+//
+// Created by Dániel Molnár on 2019-10-20.
+//
+
+// ----- own header -----
+#include <Asset/Texture.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+// ----- libraries -----
+#include <stb/stb_image.h>
+
+// ----- in-project dependencies
+#include <Data/File.hpp>
+#include <Data/Hash.hpp>
+
+namespace {
+std::string Extension(const std::string& file_name) {
+    auto extension = std::filesystem::path(file_name).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return extension;
+}
+
+// 2x2 box filter, odd edges are folded into the last texel
+std::vector<std::byte> Downsample(const std::byte* source, unsigned int width,
+                                  unsigned int height) {
+    const auto target_width = std::max(width / 2, 1u);
+    const auto target_height = std::max(height / 2, 1u);
+    std::vector<std::byte> target(target_width * target_height * 4);
+
+    const auto* texels = reinterpret_cast<const std::uint8_t*>(source);
+    for (auto y = 0u; y < target_height; ++y) {
+        const auto y0 = std::min(y * 2, height - 1);
+        const auto y1 = std::min(y * 2 + 1, height - 1);
+        for (auto x = 0u; x < target_width; ++x) {
+            const auto x0 = std::min(x * 2, width - 1);
+            const auto x1 = std::min(x * 2 + 1, width - 1);
+            for (auto c = 0u; c < 4; ++c) {
+                const unsigned int sum = texels[(y0 * width + x0) * 4 + c] +
+                                         texels[(y0 * width + x1) * 4 + c] +
+                                         texels[(y1 * width + x0) * 4 + c] +
+                                         texels[(y1 * width + x1) * 4 + c];
+                target[(y * target_width + x) * 4 + c] =
+                    static_cast<std::byte>((sum + 2) / 4);
+            }
+        }
+    }
+    return target;
+}
+
+Asset::TextureData BuildMipChain(const std::byte* texels, unsigned int width,
+                                 unsigned int height) {
+    Asset::TextureData texture;
+    texture.data.assign(texels, texels + width * height * 4);
+    texture.levels.push_back({width, height, 0, texture.data.size()});
+
+    while (width > 1 || height > 1) {
+        const auto& previous = texture.levels.back();
+        auto level = Downsample(texture.data.data() + previous.offset, width,
+                                height);
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+
+        texture.levels.push_back(
+            {width, height, texture.data.size(), level.size()});
+        texture.data.insert(texture.data.end(), level.begin(), level.end());
+    }
+    return texture;
+}
+}  // namespace
+
+namespace Asset {
+Texture::Texture(ID id, std::string file_name, TextureFormat format,
+                 const std::filesystem::path& cache_directory)
+    : Resource(id), _file_name(std::move(file_name)) {
+    const auto extension = Extension(_file_name);
+    if (extension == ".ktx2" || extension == ".dds") {
+        auto file = File::Read(_file_name);
+        if (!file) throw std::runtime_error("Could not read texture");
+
+        auto texture = extension == ".ktx2"
+                           ? TextureContainer::ReadKTX2(*file)
+                           : TextureContainer::ReadDDS(*file);
+        if (!texture) throw std::runtime_error("Unsupported texture container");
+
+        _texture = std::move(*texture);
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    auto* pixels = stbi_load(_file_name.c_str(), &width, &height, &channels,
+                             STBI_rgb_alpha);
+    if (pixels == nullptr) {
+        throw std::runtime_error("Could not load image");
+    }
+
+    _texture = BuildMipChain(reinterpret_cast<const std::byte*>(pixels),
+                             width, height);
+    stbi_image_free(pixels);
+
+    if (BlockCompression::IsCompressed(format)) {
+        encode(format, cache_directory);
+    }
+}
+
+void Texture::encode(TextureFormat format,
+                     const std::filesystem::path& cache_directory) {
+    auto key = Hash::FNV1a(_texture.data.data(), _texture.data.size());
+    key = Hash::Combine(key, Hash::FNV1a(width()));
+    key = Hash::Combine(key, Hash::FNV1a(height()));
+    key = Hash::Combine(key, Hash::FNV1a(format));
+    key = Hash::Combine(key, Hash::FNV1a(BlockCompression::EncoderVersion));
+
+    std::ostringstream cache_name;
+    cache_name << std::hex << std::setw(16) << std::setfill('0') << key
+               << ".dds";
+    const auto cache_path = cache_directory / cache_name.str();
+
+    if (auto file = File::Read(cache_path)) {
+        if (auto cached = TextureContainer::ReadDDS(*file);
+            cached && cached->format == format &&
+            cached->levels.size() == _texture.levels.size()) {
+            _texture = std::move(*cached);
+            return;
+        }
+    }
+
+    TextureData encoded;
+    encoded.format = format;
+    encoded.srgb = _texture.srgb;
+    for (const auto& level : _texture.levels) {
+        auto blocks = BlockCompression::Compress(
+            _texture.data.data() + level.offset, level.width, level.height,
+            format);
+
+        encoded.levels.push_back(
+            {level.width, level.height, encoded.data.size(), blocks.size()});
+        encoded.data.insert(encoded.data.end(), blocks.begin(), blocks.end());
+    }
+    _texture = std::move(encoded);
+
+    File::Write(cache_path, TextureContainer::WriteDDS(_texture));
+}
+}  // namespace Asset
@@ -0,0 +1,326 @@
+//
+// Created by Dániel Molnár on 2019-10-20.
+//
+
+// ----- own header -----
+#include <Asset/TextureContainer.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+
+namespace {
+using Asset::TextureFormat;
+
+template <class T>
+std::optional<T> Read(const std::vector<std::byte>& file, size_t offset) {
+    if (offset + sizeof(T) > file.size()) return std::nullopt;
+    T value;
+    std::memcpy(&value, file.data() + offset, sizeof(T));
+    return value;
+}
+
+template <class T>
+void Write(std::vector<std::byte>& file, T value) {
+    const auto offset = file.size();
+    file.resize(offset + sizeof(T));
+    std::memcpy(file.data() + offset, &value, sizeof(T));
+}
+
+constexpr std::uint32_t FourCC(char a, char b, char c, char d) {
+    return static_cast<std::uint32_t>(a) | static_cast<std::uint32_t>(b) << 8 |
+           static_cast<std::uint32_t>(c) << 16 |
+           static_cast<std::uint32_t>(d) << 24;
+}
+
+struct FormatDescription {
+    TextureFormat format;
+    bool srgb;
+};
+
+// ----- KTX2 -----
+
+constexpr const std::array<std::uint8_t, 12> KTX2Identifier = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+// KTX2 stores VkFormat values, only the ones we can upload are mapped
+std::optional<FormatDescription> FromVkFormat(std::uint32_t vk_format) {
+    switch (vk_format) {
+        case 37:  // VK_FORMAT_R8G8B8A8_UNORM
+            return FormatDescription{TextureFormat::R8G8B8A8, false};
+        case 43:  // VK_FORMAT_R8G8B8A8_SRGB
+            return FormatDescription{TextureFormat::R8G8B8A8, true};
+        case 131:  // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        case 133:  // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+            return FormatDescription{TextureFormat::BC1, false};
+        case 132:  // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+        case 134:  // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+            return FormatDescription{TextureFormat::BC1, true};
+        case 137:  // VK_FORMAT_BC3_UNORM_BLOCK
+            return FormatDescription{TextureFormat::BC3, false};
+        case 138:  // VK_FORMAT_BC3_SRGB_BLOCK
+            return FormatDescription{TextureFormat::BC3, true};
+        case 141:  // VK_FORMAT_BC5_UNORM_BLOCK
+            return FormatDescription{TextureFormat::BC5, false};
+        case 145:  // VK_FORMAT_BC7_UNORM_BLOCK
+            return FormatDescription{TextureFormat::BC7, false};
+        case 146:  // VK_FORMAT_BC7_SRGB_BLOCK
+            return FormatDescription{TextureFormat::BC7, true};
+        default:
+            return std::nullopt;
+    }
+}
+
+// ----- DDS -----
+
+constexpr const std::uint32_t DDSMagic = FourCC('D', 'D', 'S', ' ');
+constexpr const std::uint32_t DDSHeaderSize = 124;
+constexpr const std::uint32_t DDSPixelFormatSize = 32;
+constexpr const size_t DDSDataOffset = 4 + DDSHeaderSize;
+constexpr const size_t DDSDX10DataOffset = DDSDataOffset + 20;
+
+constexpr const std::uint32_t DDSDCaps = 0x1;
+constexpr const std::uint32_t DDSDHeight = 0x2;
+constexpr const std::uint32_t DDSDWidth = 0x4;
+constexpr const std::uint32_t DDSDPixelFormat = 0x1000;
+constexpr const std::uint32_t DDSDMipMapCount = 0x20000;
+constexpr const std::uint32_t DDSDLinearSize = 0x80000;
+constexpr const std::uint32_t DDPFFourCC = 0x4;
+constexpr const std::uint32_t DDSCapsComplex = 0x8;
+constexpr const std::uint32_t DDSCapsTexture = 0x1000;
+constexpr const std::uint32_t DDSCapsMipMap = 0x400000;
+constexpr const std::uint32_t D3D10ResourceDimensionTexture2D = 3;
+
+std::optional<FormatDescription> FromDXGIFormat(std::uint32_t dxgi_format) {
+    switch (dxgi_format) {
+        case 28:  // DXGI_FORMAT_R8G8B8A8_UNORM
+            return FormatDescription{TextureFormat::R8G8B8A8, false};
+        case 29:  // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+            return FormatDescription{TextureFormat::R8G8B8A8, true};
+        case 71:  // DXGI_FORMAT_BC1_UNORM
+            return FormatDescription{TextureFormat::BC1, false};
+        case 72:  // DXGI_FORMAT_BC1_UNORM_SRGB
+            return FormatDescription{TextureFormat::BC1, true};
+        case 77:  // DXGI_FORMAT_BC3_UNORM
+            return FormatDescription{TextureFormat::BC3, false};
+        case 78:  // DXGI_FORMAT_BC3_UNORM_SRGB
+            return FormatDescription{TextureFormat::BC3, true};
+        case 83:  // DXGI_FORMAT_BC5_UNORM
+            return FormatDescription{TextureFormat::BC5, false};
+        case 98:  // DXGI_FORMAT_BC7_UNORM
+            return FormatDescription{TextureFormat::BC7, false};
+        case 99:  // DXGI_FORMAT_BC7_UNORM_SRGB
+            return FormatDescription{TextureFormat::BC7, true};
+        default:
+            return std::nullopt;
+    }
+}
+
+std::uint32_t ToDXGIFormat(TextureFormat format, bool srgb) {
+    switch (format) {
+        case TextureFormat::R8G8B8A8:
+            return srgb ? 29 : 28;
+        case TextureFormat::BC1:
+            return srgb ? 72 : 71;
+        case TextureFormat::BC3:
+            return srgb ? 78 : 77;
+        case TextureFormat::BC5:
+            return 83;
+        case TextureFormat::BC7:
+            return srgb ? 99 : 98;
+    }
+    return 0;
+}
+
+std::optional<FormatDescription> FromLegacyFourCC(std::uint32_t four_cc) {
+    if (four_cc == FourCC('D', 'X', 'T', '1')) {
+        return FormatDescription{TextureFormat::BC1, false};
+    } else if (four_cc == FourCC('D', 'X', 'T', '5')) {
+        return FormatDescription{TextureFormat::BC3, false};
+    } else if (four_cc == FourCC('A', 'T', 'I', '2') ||
+               four_cc == FourCC('B', 'C', '5', 'U')) {
+        return FormatDescription{TextureFormat::BC5, false};
+    }
+    return std::nullopt;
+}
+
+// Lays out a tightly packed mip chain and checks that it fits the file
+bool FillLevels(Asset::TextureData& texture, unsigned int width,
+                unsigned int height, unsigned int level_count,
+                size_t available) {
+    size_t offset = 0;
+    for (auto level = 0u; level < std::max(level_count, 1u); ++level) {
+        const auto level_width = std::max(width >> level, 1u);
+        const auto level_height = std::max(height >> level, 1u);
+        const auto size = Asset::BlockCompression::LevelSize(
+            texture.format, level_width, level_height);
+        texture.levels.push_back({level_width, level_height, offset, size});
+        offset += size;
+    }
+    return offset <= available;
+}
+}  // namespace
+
+namespace Asset::TextureContainer {
+
+std::optional<TextureData> ReadKTX2(const std::vector<std::byte>& file) {
+    constexpr size_t HeaderOffset = 12;
+    constexpr size_t LevelIndexOffset = HeaderOffset + 9 * 4 + 4 * 4 + 2 * 8;
+
+    if (file.size() < LevelIndexOffset ||
+        std::memcmp(file.data(), KTX2Identifier.data(),
+                    KTX2Identifier.size()) != 0) {
+        return std::nullopt;
+    }
+
+    const auto vk_format = Read<std::uint32_t>(file, HeaderOffset);
+    const auto width = Read<std::uint32_t>(file, HeaderOffset + 8);
+    const auto height = Read<std::uint32_t>(file, HeaderOffset + 12);
+    const auto depth = Read<std::uint32_t>(file, HeaderOffset + 16);
+    const auto layers = Read<std::uint32_t>(file, HeaderOffset + 20);
+    const auto faces = Read<std::uint32_t>(file, HeaderOffset + 24);
+    const auto level_count = Read<std::uint32_t>(file, HeaderOffset + 28);
+    const auto supercompression = Read<std::uint32_t>(file, HeaderOffset + 32);
+
+    // Only plain 2D textures without supercompression are supported
+    if (*depth > 1 || *layers > 1 || *faces != 1 || *supercompression != 0) {
+        return std::nullopt;
+    }
+
+    const auto format = FromVkFormat(*vk_format);
+    if (!format) return std::nullopt;
+
+    TextureData texture;
+    texture.format = format->format;
+    texture.srgb = format->srgb;
+
+    // Level 0 is the base level, but the data is stored smallest mip first
+    size_t data_begin = file.size();
+    size_t data_end = 0;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> ranges;
+    for (auto level = 0u; level < std::max(*level_count, 1u); ++level) {
+        const auto entry = LevelIndexOffset + level * 24;
+        const auto offset = Read<std::uint64_t>(file, entry);
+        const auto length = Read<std::uint64_t>(file, entry + 8);
+        // Compared without the sum, which wraps for malformed entries
+        if (!offset || !length || *offset > file.size() ||
+            *length > file.size() - *offset) {
+            return std::nullopt;
+        }
+        ranges.emplace_back(*offset, *length);
+        data_begin = std::min<size_t>(data_begin, *offset);
+        data_end = std::max<size_t>(data_end, *offset + *length);
+    }
+
+    if (!FillLevels(texture, *width, *height, ranges.size(),
+                    data_end - data_begin)) {
+        return std::nullopt;
+    }
+
+    // Repack largest first, which is the order the uploader expects
+    texture.data.reserve(data_end - data_begin);
+    for (auto level = 0u; level < ranges.size(); ++level) {
+        auto& mip = texture.levels.at(level);
+        if (mip.size != ranges[level].second) return std::nullopt;
+        mip.offset = texture.data.size();
+        texture.data.insert(texture.data.end(),
+                            file.begin() + ranges[level].first,
+                            file.begin() + ranges[level].first + mip.size);
+    }
+
+    return texture;
+}
+
+std::optional<TextureData> ReadDDS(const std::vector<std::byte>& file) {
+    if (Read<std::uint32_t>(file, 0) != DDSMagic ||
+        Read<std::uint32_t>(file, 4) != DDSHeaderSize) {
+        return std::nullopt;
+    }
+
+    const auto height = Read<std::uint32_t>(file, 12);
+    const auto width = Read<std::uint32_t>(file, 16);
+    const auto level_count = Read<std::uint32_t>(file, 28);
+    const auto pixel_format_flags = Read<std::uint32_t>(file, 80);
+    const auto four_cc = Read<std::uint32_t>(file, 84);
+    if (!height || !width || !level_count || !pixel_format_flags ||
+        !four_cc || !(*pixel_format_flags & DDPFFourCC)) {
+        return std::nullopt;
+    }
+
+    std::optional<FormatDescription> format;
+    size_t data_offset = DDSDataOffset;
+    if (*four_cc == FourCC('D', 'X', '1', '0')) {
+        const auto dxgi_format = Read<std::uint32_t>(file, DDSDataOffset);
+        const auto dimension = Read<std::uint32_t>(file, DDSDataOffset + 4);
+        const auto array_size = Read<std::uint32_t>(file, DDSDataOffset + 12);
+        if (!dxgi_format || dimension != D3D10ResourceDimensionTexture2D ||
+            array_size != 1u) {
+            return std::nullopt;
+        }
+        format = FromDXGIFormat(*dxgi_format);
+        data_offset = DDSDX10DataOffset;
+    } else {
+        format = FromLegacyFourCC(*four_cc);
+    }
+    if (!format || data_offset > file.size()) return std::nullopt;
+
+    TextureData texture;
+    texture.format = format->format;
+    texture.srgb = format->srgb;
+    if (!FillLevels(texture, *width, *height, *level_count,
+                    file.size() - data_offset)) {
+        return std::nullopt;
+    }
+
+    const auto& last = texture.levels.back();
+    texture.data.assign(file.begin() + data_offset,
+                        file.begin() + data_offset + last.offset + last.size);
+
+    return texture;
+}
+
+std::vector<std::byte> WriteDDS(const TextureData& texture) {
+    if (texture.levels.empty()) return {};
+
+    const auto& base = texture.levels.front();
+    std::vector<std::byte> file;
+    file.reserve(DDSDX10DataOffset + texture.data.size());
+
+    Write<std::uint32_t>(file, DDSMagic);
+    Write<std::uint32_t>(file, DDSHeaderSize);
+    Write<std::uint32_t>(file, DDSDCaps | DDSDHeight | DDSDWidth |
+                                   DDSDPixelFormat | DDSDMipMapCount |
+                                   DDSDLinearSize);
+    Write<std::uint32_t>(file, base.height);
+    Write<std::uint32_t>(file, base.width);
+    Write<std::uint32_t>(file, static_cast<std::uint32_t>(base.size));
+    Write<std::uint32_t>(file, 0);  // depth
+    Write<std::uint32_t>(file, texture.levels.size());
+    for (auto i = 0; i < 11; ++i) Write<std::uint32_t>(file, 0);
+
+    Write<std::uint32_t>(file, DDSPixelFormatSize);
+    Write<std::uint32_t>(file, DDPFFourCC);
+    Write<std::uint32_t>(file, FourCC('D', 'X', '1', '0'));
+    for (auto i = 0; i < 5; ++i) Write<std::uint32_t>(file, 0);
+
+    auto caps = DDSCapsTexture;
+    if (texture.levels.size() > 1) caps |= DDSCapsComplex | DDSCapsMipMap;
+    Write<std::uint32_t>(file, caps);
+    for (auto i = 0; i < 4; ++i) Write<std::uint32_t>(file, 0);
+
+    Write<std::uint32_t>(file, ToDXGIFormat(texture.format, texture.srgb));
+    Write<std::uint32_t>(file, D3D10ResourceDimensionTexture2D);
+    Write<std::uint32_t>(file, 0);  // misc flags
+    Write<std::uint32_t>(file, 1);  // array size
+    Write<std::uint32_t>(file, 0);  // alpha mode
+
+    file.insert(file.end(), texture.data.begin(), texture.data.end());
+    return file;
+}
+}  // namespace Asset::TextureContainer
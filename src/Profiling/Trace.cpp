@@ -0,0 +1,297 @@
+//
+// Created by Dániel Molnár on 2019-11-07.
+//
+
+// ----- own header -----
+#include <Profiling/Trace.hpp>
+
+// ----- std -----
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+
+namespace Profiling {
+namespace {
+enum class EventType : std::uint8_t { Zone, Counter, FlowBegin, FlowEnd };
+
+struct Event {
+    EventType type;
+    const char* name;
+    Clock::time_point time;
+    // Duration of zones, in nanoseconds, id of flows
+    std::uint64_t argument;
+    // Only for counters
+    double value;
+};
+
+// The owning thread is the only writer, the lock is only contended while
+// the trace is started or written
+class ThreadBuffer {
+   private:
+    std::vector<Event> _events;
+    std::size_t _capacity = 0;
+    std::size_t _next = 0;
+    bool _wrapped = false;
+
+   public:
+    std::mutex guard;
+    const unsigned int thread_id;
+    std::string name;
+
+    explicit ThreadBuffer(unsigned int id) : thread_id(id) {}
+
+    // Drops the events recorded so far
+    void reset(std::size_t capacity) {
+        _events.clear();
+        _events.reserve(capacity);
+        _capacity = capacity;
+        _next = 0;
+        _wrapped = false;
+    }
+
+    void push(const Event& event) {
+        if (_capacity == 0) {
+            return;
+        }
+        if (_events.size() < _capacity) {
+            _events.push_back(event);
+            return;
+        }
+
+        _events[_next] = event;
+        _next = (_next + 1) % _events.size();
+        _wrapped = true;
+    }
+
+    // Oldest first
+    template <class Function>
+    void for_each(Function&& function) const {
+        for (auto i = 0u; i < _events.size(); ++i) {
+            function(_events[(_wrapped ? _next + i : i) % _events.size()]);
+        }
+    }
+};
+
+struct Registry {
+    std::mutex guard;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    // Also in buffers, by name
+    std::map<std::string, std::shared_ptr<ThreadBuffer>> tracks;
+    std::size_t capacity = 0;
+    Clock::time_point epoch = Clock::now();
+    std::atomic<std::uint64_t> next_flow = 1;
+};
+
+Registry& GetRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+// The registry has to be locked
+std::shared_ptr<ThreadBuffer> AddBuffer(Registry& registry) {
+    auto result = std::make_shared<ThreadBuffer>(
+        static_cast<unsigned int>(registry.buffers.size() + 1));
+    result->reset(registry.capacity);
+    registry.buffers.push_back(result);
+    return result;
+}
+
+// Buffers stay registered after their thread exits, so its events are
+// written as well
+ThreadBuffer& LocalBuffer() {
+    thread_local const std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto& registry = GetRegistry();
+        std::unique_lock lock(registry.guard);
+        return AddBuffer(registry);
+    }();
+    return *buffer;
+}
+
+ThreadBuffer& TrackBuffer(const char* track) {
+    auto& registry = GetRegistry();
+    std::unique_lock lock(registry.guard);
+    auto& buffer = registry.tracks[track];
+    if (!buffer) {
+        buffer = AddBuffer(registry);
+        buffer->name = track;
+    }
+    return *buffer;
+}
+
+void Record(const Event& event) {
+    auto& buffer = LocalBuffer();
+    std::unique_lock lock(buffer.guard);
+    buffer.push(event);
+}
+
+std::string Escape(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (const auto character : text) {
+        if (character == '"' || character == '\\') {
+            result.push_back('\\');
+        }
+        result.push_back(character);
+    }
+    return result;
+}
+
+double Microseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+}  // namespace
+
+namespace Detail {
+void RecordZone(const char* name, Clock::time_point start,
+                Clock::time_point end) {
+    Record({EventType::Zone, name, start,
+            static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end -
+                                                                     start)
+                    .count()),
+            0.0});
+}
+}  // namespace Detail
+
+void Start(std::size_t events_per_thread) {
+    if constexpr (!Configuration::Tracing) {
+        return;
+    }
+
+    auto& registry = GetRegistry();
+    std::unique_lock lock(registry.guard);
+    registry.capacity = events_per_thread;
+    registry.epoch = Clock::now();
+    for (auto& buffer : registry.buffers) {
+        std::unique_lock buffer_lock(buffer->guard);
+        buffer->reset(events_per_thread);
+    }
+    Detail::recording.store(true);
+}
+
+void Stop() { Detail::recording.store(false); }
+
+void Write(const std::string& path) {
+    if constexpr (!Configuration::Tracing) {
+        return;
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not write trace to " + path);
+    }
+
+    auto& registry = GetRegistry();
+    std::unique_lock lock(registry.guard);
+
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    auto first = true;
+    const auto separate = [&file, &first]() {
+        if (!first) {
+            file << ",\n";
+        }
+        first = false;
+    };
+
+    for (const auto& buffer : registry.buffers) {
+        std::unique_lock buffer_lock(buffer->guard);
+        const auto thread = ", \"pid\": 1, \"tid\": " +
+                            std::to_string(buffer->thread_id);
+        if (!buffer->name.empty()) {
+            separate();
+            file << "{\"name\": \"thread_name\", \"ph\": \"M\"" << thread
+                 << ", \"args\": {\"name\": \"" << Escape(buffer->name)
+                 << "\"}}";
+        }
+
+        buffer->for_each([&](const Event& event) {
+            // Left over from before the trace was started
+            if (event.time < registry.epoch) {
+                return;
+            }
+
+            separate();
+            file << "{\"name\": \"" << Escape(event.name) << "\"" << thread
+                 << ", \"ts\": " << Microseconds(event.time - registry.epoch);
+            switch (event.type) {
+                case EventType::Zone:
+                    file << ", \"ph\": \"X\", \"dur\": "
+                         << static_cast<double>(event.argument) / 1000.0;
+                    break;
+                case EventType::Counter:
+                    file << ", \"ph\": \"C\", \"args\": {\"value\": "
+                         << event.value << "}";
+                    break;
+                case EventType::FlowBegin:
+                    file << ", \"ph\": \"s\", \"cat\": \"flow\", \"id\": "
+                         << event.argument;
+                    break;
+                case EventType::FlowEnd:
+                    file << ", \"ph\": \"f\", \"bp\": \"e\", \"cat\": "
+                            "\"flow\", \"id\": "
+                         << event.argument;
+                    break;
+            }
+            file << "}";
+        });
+    }
+    file << "\n]}" << std::endl;
+}
+
+void SetThreadName(std::string name) {
+    if constexpr (!Configuration::Tracing) {
+        return;
+    }
+
+    auto& buffer = LocalBuffer();
+    std::unique_lock lock(buffer.guard);
+    buffer.name = std::move(name);
+}
+
+void Counter(const char* name, double value) {
+    if (Recording()) {
+        Record({EventType::Counter, name, Clock::now(), 0, value});
+    }
+}
+
+void TrackZone(const char* track, const char* name, Clock::time_point start,
+               Clock::duration duration) {
+    if (!Recording()) {
+        return;
+    }
+
+    auto& buffer = TrackBuffer(track);
+    std::unique_lock lock(buffer.guard);
+    buffer.push({EventType::Zone, name, start,
+                 static_cast<std::uint64_t>(
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         duration)
+                         .count()),
+                 0.0});
+}
+
+std::uint64_t BeginFlow(const char* name) {
+    if (!Recording()) {
+        return 0;
+    }
+
+    const auto id = GetRegistry().next_flow.fetch_add(1);
+    Record({EventType::FlowBegin, name, Clock::now(), id, 0.0});
+    return id;
+}
+
+void EndFlow(const char* name, std::uint64_t id) {
+    // Flows begun before the trace was started have no id
+    if (Recording() && id != 0) {
+        Record({EventType::FlowEnd, name, Clock::now(), id, 0.0});
+    }
+}
+}  // namespace Profiling
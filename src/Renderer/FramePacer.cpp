@@ -0,0 +1,66 @@
+//
+// Created by Dániel Molnár on 2019-11-04.
+//
+
+// ----- own header -----
+#include <Renderer/FramePacer.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <thread>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+
+namespace {
+// Sleeps tend to overshoot by the scheduler's granularity, the end of the wait
+// is spent yielding instead
+constexpr auto SleepMargin = std::chrono::milliseconds(2);
+}  // namespace
+
+FramePacer::FramePacer(Clock::duration target_frame_time)
+    : _target_frame_time(target_frame_time), _next_frame(Clock::now()) {}
+
+void FramePacer::limit() {
+    if (_target_frame_time == Clock::duration::zero()) {
+        return;
+    }
+
+    if (const auto sleep = _next_frame - Clock::now() - SleepMargin;
+        sleep > Clock::duration::zero()) {
+        std::this_thread::sleep_for(sleep);
+    }
+    while (Clock::now() < _next_frame) {
+        std::this_thread::yield();
+    }
+
+    _next_frame = std::max(_next_frame, Clock::now()) + _target_frame_time;
+}
+
+void FramePacer::input_sampled() { _input_sampled = Clock::now(); }
+
+void FramePacer::submitted(Clock::time_point submit_time) {
+    // Nothing was submitted since the input, e.g. the swapchain was recreated
+    if (submit_time < _input_sampled) {
+        return;
+    }
+
+    const auto latency = submit_time - _input_sampled;
+    _latency_sum += latency;
+    _latency_max = std::max(_latency_max, latency);
+    ++_latency_samples;
+}
+
+FramePacer::Clock::duration FramePacer::average_latency() const {
+    if (_latency_samples == 0) {
+        return Clock::duration::zero();
+    }
+    return _latency_sum / _latency_samples;
+}
+
+void FramePacer::reset_latency() {
+    _latency_sum = Clock::duration::zero();
+    _latency_max = Clock::duration::zero();
+    _latency_samples = 0;
+}
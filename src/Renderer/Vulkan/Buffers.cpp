@@ -6,7 +6,9 @@
 #include <Renderer/Vulkan/Buffers.hpp>
 
 // ----- std -----
+#include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 // ----- libraries -----
 
@@ -15,6 +17,7 @@
 #include <Renderer/Vulkan/Images.hpp>
 #include <Renderer/Vulkan/LogicalDevice.hpp>
 #include <Renderer/Vulkan/Memory/Allocator.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
 #include <Renderer/Vulkan/PhysicalDevice.hpp>
 #include <Renderer/Vulkan/Utils.hpp>
 
@@ -79,11 +82,9 @@ void Buffer::allocate() {
                 throw std::runtime_error("Could not create buffer");
             }
         }
-        VkMemoryRequirements mem_req;
-        vkGetBufferMemoryRequirements(_logical_device.handle(), _buffer,
-                                      &mem_req);
-
-        _block = &_logical_device.request_memory(mem_req, _properties);
+        _block = &_logical_device.request_buffer_memory(
+            _buffer, _properties,
+            Memory::BufferCategory(_usage, _properties));
 
         vkBindBufferMemory(_logical_device.handle(), _buffer, _block->memory(),
                            _block->offset().value);
@@ -101,7 +102,14 @@ void Buffer::transfer(void* data, const SubBufferDescriptor& desc) {
     transfer(data, desc.size, desc.offset);
 }
 
-void Buffer::copy_to(TempCommandBuffer& buffer, Buffer& dst,
+void Buffer::read(void* data, unsigned int size,
+                  unsigned int source_offset) const {
+    if (!_block) throw std::runtime_error("Buffer has no memory allocated!");
+
+    _block->read(data, size, source_offset);
+}
+
+void Buffer::copy_to(VkCommandBuffer command_buffer, Buffer& dst,
                      const std::vector<SubBufferDescriptor>& src_descs,
                      const std::vector<SubBufferDescriptor>& dst_descs) {
     if (!has_usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT) ||
@@ -118,33 +126,62 @@ void Buffer::copy_to(TempCommandBuffer& buffer, Buffer& dst,
 
         copy_regions.push_back(copy_region);
     }
-    vkCmdCopyBuffer(buffer.handle(), handle(), dst.handle(),
+    vkCmdCopyBuffer(command_buffer, handle(), dst.handle(),
                     copy_regions.size(), copy_regions.data());
 }
 
-void Buffer::copy_to(TempCommandBuffer& buffer,
+void Buffer::copy_to(VkCommandBuffer command_buffer,
                      const SubBufferDescriptor& src_desc, Image& dst) {
-    if (!has_usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT)) {
+    copy_to(command_buffer, std::vector{src_desc}, dst);
+}
+
+void Buffer::copy_to(VkCommandBuffer command_buffer,
+                     const std::vector<SubBufferDescriptor>& mip_descs,
+                     Image& dst) {
+    if (!has_usage(VK_BUFFER_USAGE_TRANSFER_SRC_BIT) ||
+        mip_descs.size() > dst.mip_levels()) {
         throw std::runtime_error("Can not execute buffer data copy");
     }
 
-    dst.transition_layout(buffer.handle(),
+    dst.transition_layout(command_buffer,
                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-    VkBufferImageCopy buffer_image_copy = {};
-    buffer_image_copy.imageExtent = dst.extent();
-    buffer_image_copy.bufferOffset = src_desc.offset;
-    buffer_image_copy.bufferImageHeight = 0;
-    buffer_image_copy.bufferRowLength = 0;
+    std::vector<VkBufferImageCopy> copy_regions;
+    copy_regions.reserve(mip_descs.size());
+    for (auto level = 0u; level < mip_descs.size(); ++level) {
+        const auto extent = dst.extent();
+
+        VkBufferImageCopy buffer_image_copy = {};
+        buffer_image_copy.imageExtent = {std::max(extent.width >> level, 1u),
+                                         std::max(extent.height >> level, 1u),
+                                         std::max(extent.depth >> level, 1u)};
+        buffer_image_copy.bufferOffset = mip_descs.at(level).offset;
+        buffer_image_copy.bufferImageHeight = 0;
+        buffer_image_copy.bufferRowLength = 0;
+
+        buffer_image_copy.imageSubresource.aspectMask =
+            VK_IMAGE_ASPECT_COLOR_BIT;
+        buffer_image_copy.imageSubresource.mipLevel = level;
+        buffer_image_copy.imageSubresource.baseArrayLayer = 0;
+        buffer_image_copy.imageSubresource.layerCount = dst.array_layers();
+
+        copy_regions.push_back(buffer_image_copy);
+    }
 
-    buffer_image_copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    buffer_image_copy.imageSubresource.mipLevel = 0;
-    buffer_image_copy.imageSubresource.baseArrayLayer = 0;
-    buffer_image_copy.imageSubresource.layerCount = dst.array_layers();
+    vkCmdCopyBufferToImage(command_buffer, handle(), dst.handle(),
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           copy_regions.size(), copy_regions.data());
+}
+
+std::unique_ptr<Buffer> Buffer::relocate(VkCommandBuffer command_buffer) {
+    auto moved = std::make_unique<Buffer>(_logical_device, _size, _usage,
+                                          _sharing_mode, _properties);
+    copy_to(command_buffer, *moved, {{_usage, _size, 0}},
+            {{_usage, _size, 0}});
 
-    vkCmdCopyBufferToImage(buffer.handle(), handle(), dst.handle(),
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                           &buffer_image_copy);
+    std::swap(_buffer, moved->_buffer);
+    std::swap(_block, moved->_block);
+    return moved;
 }
 
 // ------ VERTEX BUFFER -------
@@ -214,4 +251,13 @@ SubBufferDescriptor DynamicUniformBuffer::acquire_slot() {
     return SubBufferDescriptor{_usage, _element_size,
                                _dynamic_alignment * _next_slot++};
 }
+
+// ------ STORAGE BUFFER -------
+
+StorageBuffer::StorageBuffer(LogicalDevice& logical_device,
+                             VkDeviceSize buffer_size)
+    : Buffer(logical_device, buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+             VK_SHARING_MODE_EXCLUSIVE,
+             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                 VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {}
 }  // namespace Vulkan
@@ -60,6 +60,10 @@ void CommandPool::free_buffers() {
                          _command_buffers.size(), _command_buffers.data());
 }
 
+void CommandPool::reset() const {
+    vkResetCommandPool(_swapchain.device().handle(), _command_pool, 0);
+}
+
 TempCommandBuffer::TempCommandBuffer(
     const Vulkan::CommandPool& command_pool,
     const Vulkan::LogicalDevice& logical_device)
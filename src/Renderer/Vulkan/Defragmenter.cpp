@@ -0,0 +1,140 @@
+//
+// Created by Dániel Molnár on 2019-11-10.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Defragmenter.hpp>
+
+// ----- std -----
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Profiling/Trace.hpp>
+#include <Renderer/Vulkan/Buffers.hpp>
+#include <Renderer/Vulkan/Drawable.hpp>
+#include <Renderer/Vulkan/GpuProfiler.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/Memory/Allocator.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
+#include <Renderer/Vulkan/Texture2D.hpp>
+
+namespace Vulkan {
+Defragmenter::Defragmenter(LogicalDevice& logical_device,
+                           unsigned int frame_count, double max_occupancy,
+                           VkDeviceSize budget, unsigned int interval)
+    : _logical_device(logical_device),
+      _max_occupancy(max_occupancy),
+      _budget(budget),
+      _interval(interval),
+      _slots(frame_count) {}
+
+void Defragmenter::begin_frame(unsigned int frame) {
+    _current = frame;
+    _slots.at(_current) = {};
+}
+
+bool Defragmenter::plan(
+    const std::vector<std::unique_ptr<Texture2D>>& textures,
+    const std::vector<Drawable>& drawables) {
+    TRACE_ZONE("Defragmenter::plan");
+    _textures.clear();
+    _buffers.clear();
+
+    auto& allocator = _logical_device.allocator();
+    if (!allocator.evacuation_in_progress()) {
+        if (++_idle_frames < _interval) {
+            return false;
+        }
+        _idle_frames = 0;
+    }
+    if (!allocator.begin_evacuation(
+            _max_occupancy,
+            {Memory::Category::Geometry, Memory::Category::Texture})) {
+        return false;
+    }
+
+    VkDeviceSize planned = 0;
+    const auto take = [this, &allocator,
+                       &planned](const Memory::Block* block) {
+        if (block == nullptr || !allocator.evacuating(*block)) {
+            return false;
+        }
+        const auto size = block->size().value;
+        if (planned > 0 && planned + size > _budget) {
+            return false;
+        }
+        planned += size;
+        return true;
+    };
+
+    for (const auto& texture : textures) {
+        if (take(texture->block())) {
+            _textures.push_back(texture.get());
+        }
+    }
+    for (const auto& drawable : drawables) {
+        if (take(drawable.buffer().block())) {
+            _buffers.push_back(&drawable.buffer());
+        }
+    }
+
+    if (_textures.empty() && _buffers.empty()) {
+        // What is left in the chunks is not known here, they are used again
+        allocator.end_evacuation();
+        return false;
+    }
+    return true;
+}
+
+void Defragmenter::record(VkCommandBuffer command_buffer,
+                          GpuProfiler* profiler) {
+    TRACE_ZONE("Defragmenter::record");
+    if (_textures.empty() && _buffers.empty()) {
+        return;
+    }
+
+    const Memory::TagScope tag("Relocated");
+    auto scope = GpuProfiler::NoScope;
+    if (profiler) {
+        scope = profiler->begin(command_buffer, "Defragment");
+    }
+
+    auto& slot = _slots.at(_current);
+    for (auto* texture : _textures) {
+        _relocated_size += texture->block()->size().value;
+        slot.textures.push_back(texture->relocate(command_buffer));
+    }
+    for (auto* buffer : _buffers) {
+        _relocated_size += buffer->block()->size().value;
+        slot.buffers.push_back(buffer->relocate(command_buffer));
+    }
+
+    if (!_buffers.empty()) {
+        // The geometry is drawn from the new buffers in the same frame
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask =
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1,
+                             &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    if (profiler) {
+        profiler->end(command_buffer, scope);
+    }
+    Profiling::Counter("Relocated bytes",
+                       static_cast<double>(_relocated_size));
+
+    _textures.clear();
+    _buffers.clear();
+}
+
+void Defragmenter::release() {
+    for (auto& slot : _slots) {
+        slot = {};
+    }
+}
+}  // namespace Vulkan
@@ -0,0 +1,88 @@
+//
+// Created by Dániel Molnár on 2019-10-24.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Descriptors/BindlessTextureSet.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/Representation.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorSet.hpp>
+#include <Renderer/Vulkan/ImageView.hpp>
+#include <Renderer/Vulkan/Images.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/PhysicalDevice.hpp>
+#include <configuration.hpp>
+
+namespace {
+unsigned int Capacity(const Vulkan::PhysicalDevice& physical_device) {
+    if (!physical_device.supports_bindless_textures()) {
+        throw std::runtime_error("Device does not support bindless textures");
+    }
+
+    const auto& limits = physical_device.descriptor_indexing_properties();
+    return std::min(
+        {Configuration::BindlessTextureCapacity,
+         limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+         limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+         limits.maxDescriptorSetUpdateAfterBindSamplers,
+         limits.maxDescriptorSetUpdateAfterBindSampledImages});
+}
+}  // namespace
+
+namespace Vulkan {
+BindlessTextureSet::BindlessTextureSet(LogicalDevice& logical_device,
+                                       const PhysicalDevice& physical_device)
+    : _logical_device(logical_device),
+      _capacity(Capacity(physical_device)),
+      _layout(logical_device, {Bindless_texture_descriptor(_capacity)},
+              {VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+               VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT}),
+      _pool(logical_device,
+            {{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, _capacity}}, 1,
+            VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT),
+      _descriptor_set(_pool.allocate_set(_layout.handle())) {}
+
+unsigned int BindlessTextureSet::add(const Image& image, const ImageView& view,
+                                     VkSampler sampler) {
+    unsigned int index;
+    if (!_free_indices.empty()) {
+        index = _free_indices.back();
+        _free_indices.pop_back();
+    } else if (_next_index < _capacity) {
+        index = _next_index++;
+    } else {
+        throw std::runtime_error("Bindless texture array is full");
+    }
+
+    DescriptorWriteBatch<> batch(_logical_device);
+    write(index, image, view, sampler, batch);
+    return index;
+}
+
+void BindlessTextureSet::write(unsigned int index, const Image& image,
+                               const ImageView& view, VkSampler sampler,
+                               DescriptorWriteBatch<>& batch) {
+    VkDescriptorImageInfo image_info = {};
+    image_info.imageLayout = image.layout();
+    image_info.imageView = view.handle();
+    image_info.sampler = sampler;
+
+    batch.write(_descriptor_set->handle(),
+                Bindless_texture_descriptor(_capacity), index, image_info);
+}
+
+void BindlessTextureSet::remove(unsigned int index) {
+    _free_indices.push_back(index);
+}
+
+const VkDescriptorSet& BindlessTextureSet::handle() const {
+    return _descriptor_set->handle();
+}
+}  // namespace Vulkan
@@ -0,0 +1,232 @@
+//
+// Created by Dániel Molnár on 2019-10-25.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Descriptors/DescriptorAllocator.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/Hash.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorSet.hpp>
+#include <Renderer/Vulkan/ImageView.hpp>
+#include <Renderer/Vulkan/Images.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+
+namespace {
+std::uint64_t HashLayoutBinding(std::uint64_t seed,
+                                const VkDescriptorSetLayoutBinding& layout,
+                                unsigned int index) {
+    seed = Hash::Combine(seed, Hash::FNV1a(layout.binding));
+    seed = Hash::Combine(seed, Hash::FNV1a(layout.descriptorType));
+    return Hash::Combine(seed, Hash::FNV1a(index));
+}
+
+bool SameLayoutBinding(const VkDescriptorSetLayoutBinding& a,
+                       const VkDescriptorSetLayoutBinding& b) {
+    return a.binding == b.binding && a.descriptorType == b.descriptorType;
+}
+
+constexpr const unsigned int MaxPoolGrowth = 16;
+}  // namespace
+
+namespace Vulkan {
+// DescriptorBindings
+
+DescriptorBindings::DescriptorBindings() : _hash(Hash::FNV1aOffsetBasis) {}
+
+DescriptorBindings& DescriptorBindings::image(
+    VkDescriptorSetLayoutBinding layout, unsigned int index,
+    const Image& image, const ImageView& view, VkSampler sampler) {
+    _images.push_back({layout, index, &image, &view, sampler});
+
+    _hash = HashLayoutBinding(_hash, layout, index);
+    _hash = Hash::Combine(_hash, Hash::FNV1a(view.handle()));
+    _hash = Hash::Combine(_hash, Hash::FNV1a(sampler));
+    _hash = Hash::Combine(_hash, Hash::FNV1a(image.layout()));
+    return *this;
+}
+
+DescriptorBindings& DescriptorBindings::buffer(
+    VkDescriptorSetLayoutBinding layout, unsigned int index,
+    const Buffer& buffer, SubBufferDescriptor descriptor) {
+    _buffers.push_back({layout, index, &buffer, descriptor});
+
+    _hash = HashLayoutBinding(_hash, layout, index);
+    _hash = Hash::Combine(_hash, Hash::FNV1a(buffer.handle()));
+    _hash = Hash::Combine(_hash, Hash::FNV1a(descriptor.offset));
+    _hash = Hash::Combine(_hash, Hash::FNV1a(descriptor.size));
+    return *this;
+}
+
+bool DescriptorBindings::operator==(const DescriptorBindings& other) const {
+    return std::equal(
+               _images.begin(), _images.end(), other._images.begin(),
+               other._images.end(),
+               [](const ImageBinding& a, const ImageBinding& b) {
+                   return SameLayoutBinding(a.layout, b.layout) &&
+                          a.index == b.index &&
+                          a.view->handle() == b.view->handle() &&
+                          a.sampler == b.sampler &&
+                          a.image->layout() == b.image->layout();
+               }) &&
+           std::equal(_buffers.begin(), _buffers.end(),
+                      other._buffers.begin(), other._buffers.end(),
+                      [](const BufferBinding& a, const BufferBinding& b) {
+                          return SameLayoutBinding(a.layout, b.layout) &&
+                                 a.index == b.index &&
+                                 a.buffer->handle() == b.buffer->handle() &&
+                                 a.descriptor.offset == b.descriptor.offset &&
+                                 a.descriptor.size == b.descriptor.size;
+                      });
+}
+
+void DescriptorBindings::write(const DescriptorSet& set,
+                               DescriptorWriteBatch<>& batch) const {
+    for (const auto& binding : _images) {
+        VkDescriptorImageInfo image_info = {};
+        image_info.imageLayout = binding.image->layout();
+        image_info.imageView = binding.view->handle();
+        image_info.sampler = binding.sampler;
+
+        batch.write(set.handle(), binding.layout, binding.index, image_info);
+    }
+    for (const auto& binding : _buffers) {
+        VkDescriptorBufferInfo buffer_info = {};
+        buffer_info.buffer = binding.buffer->handle();
+        buffer_info.offset = binding.descriptor.offset;
+        buffer_info.range = binding.descriptor.size;
+
+        batch.write(set.handle(), binding.layout, binding.index, buffer_info);
+    }
+}
+
+// DescriptorAllocator
+
+DescriptorAllocator::DescriptorAllocator(const LogicalDevice& logical_device,
+                                         PoolSizes pool_sizes,
+                                         unsigned long max_sets,
+                                         unsigned int frame_count)
+    : _logical_device(logical_device),
+      _pool_sizes(std::move(pool_sizes)),
+      _max_sets(max_sets),
+      _frame_pools(frame_count) {
+    _pools.emplace_back(create_pool(_growth));
+}
+
+std::unique_ptr<DescriptorPool> DescriptorAllocator::create_pool(
+    unsigned int factor) const {
+    auto pool_sizes = _pool_sizes;
+    for (auto& [type, count] : pool_sizes) {
+        count *= factor;
+    }
+    return std::make_unique<DescriptorPool>(_logical_device, pool_sizes,
+                                            _max_sets * factor);
+}
+
+std::unique_ptr<DescriptorPool> DescriptorAllocator::acquire_transient_pool() {
+    if (_free_pools.empty()) {
+        return create_pool(1);
+    }
+
+    auto pool = std::move(_free_pools.back());
+    _free_pools.pop_back();
+    return pool;
+}
+
+DescriptorSet* DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+    if (auto* set = _pools.back()->try_allocate_set(layout)) {
+        return set;
+    }
+
+    // Pools are only ever appended, a full pool stays full as nothing is
+    // freed from it, so only the newest one is worth trying
+    _growth = std::min(_growth * 2, MaxPoolGrowth);
+    _pools.emplace_back(create_pool(_growth));
+    if (auto* set = _pools.back()->try_allocate_set(layout)) {
+        return set;
+    }
+    throw std::runtime_error("Descriptor set does not fit in an empty pool");
+}
+
+DescriptorSet* DescriptorAllocator::allocate_transient(
+    VkDescriptorSetLayout layout) {
+    auto& pools = _frame_pools.at(_frame);
+    if (!pools.empty()) {
+        if (auto* set = pools.back()->try_allocate_set(layout)) {
+            return set;
+        }
+    }
+
+    pools.emplace_back(acquire_transient_pool());
+    if (auto* set = pools.back()->try_allocate_set(layout)) {
+        return set;
+    }
+    throw std::runtime_error("Descriptor set does not fit in an empty pool");
+}
+
+DescriptorSet* DescriptorAllocator::cached(VkDescriptorSetLayout layout,
+                                           const DescriptorBindings& bindings) {
+    const auto key = Hash::Combine(Hash::FNV1a(layout), bindings.hash());
+
+    auto [first, last] = _cache.equal_range(key);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.layout == layout && it->second.bindings == bindings) {
+            ++it->second.references;
+            return it->second.set;
+        }
+    }
+
+    DescriptorSet* set = nullptr;
+    if (auto it = _free_sets.find(layout); it != _free_sets.end()) {
+        set = it->second;
+        _free_sets.erase(it);
+    } else {
+        set = allocate(layout);
+    }
+    DescriptorWriteBatch<> batch(_logical_device);
+    bindings.write(*set, batch);
+
+    _cache.emplace(key, CachedSet{layout, bindings, set, 1});
+    return set;
+}
+
+void DescriptorAllocator::release_cached(DescriptorSet* set) {
+    auto it =
+        std::find_if(_cache.begin(), _cache.end(), [set](const auto& entry) {
+            return entry.second.set == set;
+        });
+    if (it == _cache.end()) {
+        throw std::invalid_argument("Descriptor set is not cached");
+    }
+
+    if (--it->second.references == 0) {
+        _free_sets.emplace(it->second.layout, set);
+        _cache.erase(it);
+    }
+}
+
+void DescriptorAllocator::begin_frame(unsigned int frame) {
+    _frame = frame;
+
+    auto& pools = _frame_pools.at(_frame);
+    for (auto& pool : pools) {
+        pool->reset();
+        _free_pools.emplace_back(std::move(pool));
+    }
+    pools.clear();
+}
+
+size_t DescriptorAllocator::pool_count() const {
+    auto count = _pools.size() + _free_pools.size();
+    for (const auto& pools : _frame_pools) {
+        count += pools.size();
+    }
+    return count;
+}
+}  // namespace Vulkan
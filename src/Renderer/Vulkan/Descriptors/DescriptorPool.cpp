@@ -17,7 +17,7 @@ namespace Vulkan {
 DescriptorPool::DescriptorPool(
     const Vulkan::LogicalDevice& logical_device,
     const std::vector<std::pair<VkDescriptorType, unsigned long>>& pool_sizes,
-    unsigned long max_sets)
+    unsigned long max_sets, VkDescriptorPoolCreateFlags flags)
     : _logical_device(logical_device) {
     for (const auto& [type, count] : pool_sizes) {
         VkDescriptorPoolSize pool_size;
@@ -33,6 +33,7 @@ DescriptorPool::DescriptorPool(
     create_info.poolSizeCount = _pool_sizes.size();
     create_info.pPoolSizes = _pool_sizes.data();
     create_info.maxSets = max_sets;
+    create_info.flags = flags;
 
     if (vkCreateDescriptorPool(_logical_device.handle(), &create_info, nullptr,
                                &_descriptor_pool) != VK_SUCCESS) {
@@ -79,4 +80,32 @@ DescriptorSet* DescriptorPool::allocate_set(
     return result[0];
 }
 
+DescriptorSet* DescriptorPool::try_allocate_set(
+    const VkDescriptorSetLayout& layout) {
+    VkDescriptorSetAllocateInfo allocate_info = {};
+    allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+
+    allocate_info.descriptorPool = _descriptor_pool;
+    allocate_info.descriptorSetCount = 1;
+    allocate_info.pSetLayouts = &layout;
+
+    VkDescriptorSet desc_set;
+    switch (vkAllocateDescriptorSets(_logical_device.handle(), &allocate_info,
+                                     &desc_set)) {
+        case VK_SUCCESS:
+            return &_descriptor_sets.emplace_back(_logical_device,
+                                                  _descriptor_pool, desc_set);
+        case VK_ERROR_OUT_OF_POOL_MEMORY:
+        case VK_ERROR_FRAGMENTED_POOL:
+            return nullptr;
+        default:
+            throw std::runtime_error("Could not allocate descriptor set!");
+    }
+}
+
+void DescriptorPool::reset() {
+    vkResetDescriptorPool(_logical_device.handle(), _descriptor_pool, 0);
+    _descriptor_sets.clear();
+}
+
 }
\ No newline at end of file
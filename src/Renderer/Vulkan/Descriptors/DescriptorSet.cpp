@@ -61,8 +61,7 @@ void DescriptorSet::write(VkDescriptorSetLayoutBinding layout,
 }
 
 void DescriptorSet::update() {
-    std::vector<VkWriteDescriptorSet> writes;
-    writes.reserve(_scheduled_writes.size());
+    _writes.clear();
 
     VkWriteDescriptorSet write_descriptor = {};
 
@@ -87,11 +86,11 @@ void DescriptorSet::update() {
                 write_descriptor.pImageInfo = image_infos.data();
             });
 
-        writes.push_back(write_descriptor);
+        _writes.push_back(write_descriptor);
     }
 
-    vkUpdateDescriptorSets(_logical_device.handle(), writes.size(),
-                           writes.data(), 0, nullptr);
+    vkUpdateDescriptorSets(_logical_device.handle(), _writes.size(),
+                           _writes.data(), 0, nullptr);
     _scheduled_writes.clear();
 }
 
@@ -6,6 +6,7 @@
 #include "Renderer/Vulkan/Descriptors/DescriptorSetLayout.hpp"
 
 // ----- std -----
+#include <stdexcept>
 
 // ----- libraries -----
 
@@ -15,7 +16,8 @@
 namespace Vulkan {
 DescriptorSetLayout::DescriptorSetLayout(
     LogicalDevice& logical_device,
-    const std::vector<VkDescriptorSetLayoutBinding>& bindings)
+    const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+    const std::vector<VkDescriptorBindingFlagsEXT>& binding_flags)
     : _logical_device(logical_device) {
     VkDescriptorSetLayoutCreateInfo descriptor_set_layout_info = {};
     descriptor_set_layout_info.sType =
@@ -23,6 +25,27 @@ DescriptorSetLayout::DescriptorSetLayout(
     descriptor_set_layout_info.bindingCount = bindings.size();
     descriptor_set_layout_info.pBindings = bindings.data();
 
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info = {};
+    if (!binding_flags.empty()) {
+        if (binding_flags.size() != bindings.size()) {
+            throw std::invalid_argument(
+                "Binding flags have to be given for every binding");
+        }
+
+        binding_flags_info.sType =
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        binding_flags_info.bindingCount = binding_flags.size();
+        binding_flags_info.pBindingFlags = binding_flags.data();
+        descriptor_set_layout_info.pNext = &binding_flags_info;
+
+        for (const auto& flags : binding_flags) {
+            if (flags & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT) {
+                descriptor_set_layout_info.flags |=
+                    VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+            }
+        }
+    }
+
     if (vkCreateDescriptorSetLayout(_logical_device.handle(),
                                     &descriptor_set_layout_info, nullptr,
                                     &_layout) != VK_SUCCESS) {
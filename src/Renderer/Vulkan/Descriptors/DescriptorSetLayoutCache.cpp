@@ -0,0 +1,66 @@
+//
+// Created by Dániel Molnár on 2019-10-30.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Descriptors/DescriptorSetLayoutCache.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/Hash.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+
+namespace {
+bool Equal(const VkDescriptorSetLayoutBinding& a,
+           const VkDescriptorSetLayoutBinding& b) {
+    return a.binding == b.binding && a.descriptorType == b.descriptorType &&
+           a.descriptorCount == b.descriptorCount &&
+           a.stageFlags == b.stageFlags;
+}
+}  // namespace
+
+namespace Vulkan {
+DescriptorSetLayoutCache::DescriptorSetLayoutCache(
+    LogicalDevice& logical_device)
+    : _logical_device(logical_device) {}
+
+DescriptorSetLayout& DescriptorSetLayoutCache::get(
+    std::vector<VkDescriptorSetLayoutBinding> bindings) {
+    std::sort(bindings.begin(), bindings.end(),
+              [](const VkDescriptorSetLayoutBinding& a,
+                 const VkDescriptorSetLayoutBinding& b) {
+                  return a.binding < b.binding;
+              });
+
+    auto key = Hash::FNV1aOffsetBasis;
+    for (const auto& binding : bindings) {
+        if (binding.pImmutableSamplers != nullptr) {
+            throw std::invalid_argument("Immutable samplers are not cached");
+        }
+        key = Hash::FNV1a(binding.binding, key);
+        key = Hash::FNV1a(binding.descriptorType, key);
+        key = Hash::FNV1a(binding.descriptorCount, key);
+        key = Hash::FNV1a(binding.stageFlags, key);
+    }
+
+    std::unique_lock lock(_guard);
+    const auto [first, last] = _layouts.equal_range(key);
+    for (auto it = first; it != last; ++it) {
+        if (std::equal(bindings.begin(), bindings.end(),
+                       it->second.bindings.begin(),
+                       it->second.bindings.end(), Equal)) {
+            return *it->second.layout;
+        }
+    }
+
+    auto layout =
+        std::make_unique<DescriptorSetLayout>(_logical_device, bindings);
+    return *_layouts.emplace(key, Entry{std::move(bindings), std::move(layout)})
+                ->second.layout;
+}
+}  // namespace Vulkan
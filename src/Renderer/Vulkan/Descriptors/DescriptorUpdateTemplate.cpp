@@ -0,0 +1,50 @@
+//
+// Created by Dániel Molnár on 2019-10-26.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Descriptors/DescriptorUpdateTemplate.hpp>
+
+// ----- std -----
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Renderer/Vulkan/Descriptors/DescriptorSet.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorSetLayout.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+
+namespace Vulkan {
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(
+    const LogicalDevice& logical_device, const DescriptorSetLayout& layout,
+    const std::vector<VkDescriptorUpdateTemplateEntry>& entries)
+    : _logical_device(logical_device) {
+    VkDescriptorUpdateTemplateCreateInfo create_info = {};
+    create_info.sType =
+        VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+
+    create_info.descriptorUpdateEntryCount = entries.size();
+    create_info.pDescriptorUpdateEntries = entries.data();
+    create_info.templateType =
+        VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    create_info.descriptorSetLayout = layout.handle();
+
+    if (vkCreateDescriptorUpdateTemplate(_logical_device.handle(),
+                                         &create_info, nullptr,
+                                         &_template) != VK_SUCCESS) {
+        throw std::runtime_error("Could not create descriptor update template");
+    }
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+    vkDestroyDescriptorUpdateTemplate(_logical_device.handle(), _template,
+                                      nullptr);
+}
+
+void DescriptorUpdateTemplate::update(const DescriptorSet& set,
+                                      const void* data) const {
+    vkUpdateDescriptorSetWithTemplate(_logical_device.handle(), set.handle(),
+                                      _template, data);
+}
+}  // namespace Vulkan
@@ -66,7 +66,8 @@ void Drawable::stage(TempCommandBuffer& command_buffer,
                      const Drawable::StageDesc& desc) {
     stage.transfer((void*)_mesh.vertices().data(), desc.vert_desc);
     stage.transfer((void*)_mesh.indices().data(), desc.ind_desc);
-    stage.copy_to(command_buffer, *_buffer, {desc.vert_desc, desc.ind_desc},
+    stage.copy_to(command_buffer.handle(), *_buffer,
+                  {desc.vert_desc, desc.ind_desc},
                   {_vertex_buffer_desc, _index_buffer_desc});
 }
 
@@ -80,12 +81,19 @@ const SubBufferDescriptor& Drawable::uniform_buffer_desc() const {
     return _uniform_buffer_desc;
 }
 
-void Drawable::update(Buffer& buffer,
-                      uint64_t delta_time [[maybe_unused]]) {
+glm::mat4 Drawable::world_matrix() const {
+    return glm::translate(glm::mat4(1.0), _position) * _model;
+}
+
+void Drawable::update(uint64_t delta_time) {
     auto amount_deg = 360.f * (delta_time / 2000.f);
     _model = (glm::rotate(glm::mat4(1.0), glm::radians(amount_deg),
                           glm::vec3(0.0f, 0.0f, 1.0f)));
-    auto trans_mat = glm::translate(glm::mat4(1.0), _position) * _model;
+}
+
+void Drawable::update(Buffer& buffer, uint64_t delta_time) {
+    update(delta_time);
+    auto trans_mat = world_matrix();
 
     buffer.transfer((void*)(&trans_mat), sizeof(trans_mat),
                     _uniform_buffer_desc.offset);
@@ -99,7 +107,7 @@ void Drawable::transform(const glm::mat4& transformation) {
     _model *= transformation;
 }
 
-void Drawable::draw(VkCommandBuffer command_buffer) {
+void Drawable::draw(VkCommandBuffer command_buffer, uint32_t first_instance) {
     VkBuffer vertex_buffers[] = {_buffer->handle()};
     VkDeviceSize offsets[] = {_vertex_buffer_desc.offset};
     vkCmdBindVertexBuffers(command_buffer,
@@ -107,7 +115,8 @@ void Drawable::draw(VkCommandBuffer command_buffer) {
                            vertex_buffers, offsets);
     vkCmdBindIndexBuffer(command_buffer, _buffer->handle(),
                          _index_buffer_desc.offset, VK_INDEX_TYPE_UINT32);
-    vkCmdDrawIndexed(command_buffer, _mesh.indices().size(), 1, 0, 0, 0);
+    vkCmdDrawIndexed(command_buffer, _mesh.indices().size(), 1, 0, 0,
+                     first_instance);
 }
 
 }
\ No newline at end of file
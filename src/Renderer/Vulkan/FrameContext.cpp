@@ -0,0 +1,76 @@
+//
+// Created by Dániel Molnár on 2019-11-03.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/FrameContext.hpp>
+
+// ----- std -----
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Profiling/Trace.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/Swapchain.hpp>
+
+namespace Vulkan {
+FrameContext::FrameContext(LogicalDevice& logical_device,
+                           const Swapchain& swapchain,
+                           std::unique_ptr<Buffer> uniform_buffer,
+                           std::unique_ptr<Buffer> object_buffer)
+    : _logical_device(logical_device),
+      _command_pool(swapchain),
+      _uniform_buffer(std::move(uniform_buffer)),
+      _object_buffer(std::move(object_buffer)) {
+    _command_pool.allocate_buffers(1);
+
+    VkSemaphoreCreateInfo semaphore_info = {};
+    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    VkFenceCreateInfo fence_info = {};
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    // The first wait on the frame returns immediately
+    fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    if (vkCreateSemaphore(_logical_device.handle(), &semaphore_info, nullptr,
+                          &_image_available) != VK_SUCCESS ||
+        vkCreateSemaphore(_logical_device.handle(), &semaphore_info, nullptr,
+                          &_render_finished) != VK_SUCCESS ||
+        vkCreateFence(_logical_device.handle(), &fence_info, nullptr,
+                      &_in_flight) != VK_SUCCESS) {
+        throw std::runtime_error(
+            "Failed to create synchronization objects for a frame");
+    }
+}
+
+FrameContext::~FrameContext() {
+    vkDestroyFence(_logical_device.handle(), _in_flight, nullptr);
+    vkDestroySemaphore(_logical_device.handle(), _render_finished, nullptr);
+    vkDestroySemaphore(_logical_device.handle(), _image_available, nullptr);
+    _command_pool.free_buffers();
+}
+
+void FrameContext::wait() const {
+    TRACE_ZONE("FrameContext::wait");
+    vkWaitForFences(_logical_device.handle(), 1, &_in_flight, VK_TRUE,
+                    std::numeric_limits<uint64_t>::max());
+}
+
+VkCommandBuffer FrameContext::begin() {
+    vkResetFences(_logical_device.handle(), 1, &_in_flight);
+    _command_pool.reset();
+
+    VkCommandBufferBeginInfo begin_info = {};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    const auto command_buffer = this->command_buffer();
+    if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin command buffer recording");
+    }
+    return command_buffer;
+}
+}  // namespace Vulkan
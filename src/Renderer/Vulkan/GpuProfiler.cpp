@@ -0,0 +1,217 @@
+//
+// Created by Dániel Molnár on 2019-11-08.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/GpuProfiler.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Profiling/Trace.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/PhysicalDevice.hpp>
+
+namespace Vulkan {
+namespace {
+std::uint32_t TimestampValidBits(const PhysicalDevice& physical_device,
+                                 unsigned int queue_family) {
+    uint32_t count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device.handle(), &count,
+                                             nullptr);
+    std::vector<VkQueueFamilyProperties> families(count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device.handle(), &count,
+                                             families.data());
+    return queue_family < count ? families[queue_family].timestampValidBits
+                                : 0;
+}
+
+// Nearest rank, of a sorted sample
+double Percentile(const std::vector<double>& sorted, double percentile) {
+    const auto rank = static_cast<std::size_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+}  // namespace
+
+GpuProfiler::GpuProfiler(const PhysicalDevice& physical_device,
+                         const LogicalDevice& logical_device,
+                         unsigned int queue_family, unsigned int frame_count,
+                         unsigned int scopes_per_frame,
+                         std::size_t history_size)
+    : _logical_device(logical_device),
+      _period(physical_device.properties().limits.timestampPeriod),
+      _scopes_per_slot(scopes_per_frame),
+      _history_size(history_size),
+      _slots(frame_count + 1) {
+    const auto valid_bits = TimestampValidBits(physical_device, queue_family);
+    _supported = valid_bits > 0 && _period > 0.0;
+    _valid_mask = valid_bits >= 64 ? std::numeric_limits<std::uint64_t>::max()
+                                   : (std::uint64_t{1} << valid_bits) - 1;
+    if (!_supported) {
+        return;
+    }
+
+    VkQueryPoolCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    create_info.queryCount = 2 * _scopes_per_slot;
+
+    for (auto& slot : _slots) {
+        if (vkCreateQueryPool(_logical_device.handle(), &create_info, nullptr,
+                              &slot.query_pool) != VK_SUCCESS) {
+            for (auto& created : _slots) {
+                vkDestroyQueryPool(_logical_device.handle(),
+                                   created.query_pool, nullptr);
+            }
+            throw std::runtime_error("Could not create timestamp query pool");
+        }
+        slot.scopes.reserve(_scopes_per_slot);
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (auto& slot : _slots) {
+        vkDestroyQueryPool(_logical_device.handle(), slot.query_pool, nullptr);
+    }
+}
+
+void GpuProfiler::reset(VkCommandBuffer command_buffer, unsigned int slot) {
+    _current = slot;
+    if (!_supported) {
+        return;
+    }
+
+    auto& current = _slots.at(slot);
+    collect(current);
+    vkCmdResetQueryPool(command_buffer, current.query_pool, 0,
+                        2 * _scopes_per_slot);
+    current.pending = true;
+    current.recorded = Clock::now();
+}
+
+void GpuProfiler::begin_frame(VkCommandBuffer command_buffer,
+                              unsigned int frame) {
+    if (frame + 1 >= _slots.size()) {
+        throw std::out_of_range("No timestamp queries for the frame");
+    }
+    reset(command_buffer, frame);
+}
+
+void GpuProfiler::begin_immediate(VkCommandBuffer command_buffer) {
+    reset(command_buffer, _slots.size() - 1);
+}
+
+void GpuProfiler::end_immediate() {
+    if (_supported) {
+        collect(_slots.back());
+    }
+}
+
+unsigned int GpuProfiler::begin(VkCommandBuffer command_buffer,
+                                const char* label,
+                                VkPipelineStageFlagBits stage) {
+    auto& slot = _slots[_current];
+    if (!slot.pending || slot.scopes.size() >= _scopes_per_slot) {
+        return NoScope;
+    }
+
+    const auto query = static_cast<std::uint32_t>(2 * slot.scopes.size());
+    vkCmdWriteTimestamp(command_buffer, stage, slot.query_pool, query);
+    slot.scopes.push_back({label, query});
+    return slot.scopes.size() - 1;
+}
+
+void GpuProfiler::end(VkCommandBuffer command_buffer, unsigned int scope,
+                      VkPipelineStageFlagBits stage) {
+    if (scope == NoScope) {
+        return;
+    }
+
+    auto& slot = _slots[_current];
+    vkCmdWriteTimestamp(command_buffer, stage, slot.query_pool,
+                        slot.scopes.at(scope).query + 1);
+}
+
+void GpuProfiler::collect(Slot& slot) {
+    if (!slot.pending) {
+        return;
+    }
+    slot.pending = false;
+    if (slot.scopes.empty()) {
+        return;
+    }
+
+    // Value and availability of every query. Scopes never ended stay
+    // unavailable, they are skipped instead of waited for.
+    std::vector<std::uint64_t> results(4 * slot.scopes.size());
+    const auto result = vkGetQueryPoolResults(
+        _logical_device.handle(), slot.query_pool, 0,
+        static_cast<uint32_t>(2 * slot.scopes.size()),
+        results.size() * sizeof(std::uint64_t), results.data(),
+        2 * sizeof(std::uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        slot.scopes.clear();
+        return;
+    }
+
+    const auto recorded = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              slot.recorded.time_since_epoch())
+                              .count();
+    for (auto i = 0u; i < slot.scopes.size(); ++i) {
+        const auto* query = &results[4 * i];
+        if (query[1] == 0 || query[3] == 0) {
+            continue;
+        }
+
+        const auto begin = query[0] & _valid_mask;
+        const auto ticks = (query[2] - begin) & _valid_mask;
+        const auto duration = static_cast<double>(ticks) * _period;
+
+        auto& history = _histories[slot.scopes[i].label];
+        if (history.samples.size() < _history_size) {
+            history.samples.push_back(duration / 1.0e6);
+        } else {
+            history.samples[history.next] = duration / 1.0e6;
+            history.next = (history.next + 1) % _history_size;
+        }
+
+        if (!Profiling::Recording()) {
+            continue;
+        }
+        const auto start =
+            static_cast<std::int64_t>(static_cast<double>(begin) * _period);
+        if (!_clock_offset || start - recorded < *_clock_offset) {
+            _clock_offset = start - recorded;
+        }
+        Profiling::TrackZone(
+            "GPU", slot.scopes[i].label,
+            Clock::time_point(std::chrono::nanoseconds(start - *_clock_offset)),
+            std::chrono::nanoseconds(static_cast<std::int64_t>(duration)));
+    }
+    slot.scopes.clear();
+}
+
+std::map<std::string, GpuProfiler::Statistics> GpuProfiler::statistics()
+    const {
+    std::map<std::string, Statistics> result;
+    for (const auto& [label, history] : _histories) {
+        auto sorted = history.samples;
+        std::sort(sorted.begin(), sorted.end());
+        result.emplace(
+            label,
+            Statistics{sorted.front(),
+                       std::accumulate(sorted.begin(), sorted.end(), 0.0) /
+                           static_cast<double>(sorted.size()),
+                       Percentile(sorted, 99.0), sorted.size()});
+    }
+    return result;
+}
+}  // namespace Vulkan
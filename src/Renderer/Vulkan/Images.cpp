@@ -6,15 +6,43 @@
 #include <Renderer/Vulkan/Images.hpp>
 
 // ----- std -----
+#include <stdexcept>
+#include <utility>
 
 // ----- libraries -----
 
 // ----- in-project dependencies
 #include <Renderer/Vulkan/LogicalDevice.hpp>
 #include <Renderer/Vulkan/Memory/Block.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
 #include <Renderer/Vulkan/Swapchain.hpp>
 
 namespace Vulkan {
+namespace {
+VkImage CreateAttachment(const LogicalDevice& logical_device,
+                         VkExtent2D extent, VkFormat format,
+                         VkImageUsageFlags usage) {
+    VkImageCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    create_info.imageType = VK_IMAGE_TYPE_2D;
+    create_info.extent = {extent.width, extent.height, 1};
+    create_info.mipLevels = 1;
+    create_info.arrayLayers = 1;
+    create_info.format = format;
+    create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    create_info.usage = usage;
+    create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkImage image = VK_NULL_HANDLE;
+    if (vkCreateImage(logical_device.handle(), &create_info, nullptr,
+                      &image) != VK_SUCCESS) {
+        throw std::runtime_error("Could not create image!");
+    }
+    return image;
+}
+}  // namespace
 
 Image::Image(Vulkan::LogicalDevice& logical_device, VkImage image,
              unsigned int width, unsigned int height, unsigned int depth,
@@ -72,14 +100,28 @@ Image::Image(Vulkan::LogicalDevice& logical_device, VkImageType type,
         throw std::runtime_error("Could not create image!");
     }
 
-    VkMemoryRequirements mem_req;
-    vkGetImageMemoryRequirements(_logical_device.handle(), _image, &mem_req);
-    _block = &_logical_device.request_memory(mem_req, properties);
+    _block = &_logical_device.request_image_memory(
+        _image, properties, Memory::ImageCategory(_usage));
 
     vkBindImageMemory(_logical_device.handle(), _image, _block->memory(),
                       _block->offset().value);
 }
 
+void Image::swap_storage(Image& other) {
+    if (&_logical_device != &other._logical_device) {
+        throw std::invalid_argument(
+            "Images of different devices can not swap storage!");
+    }
+
+    std::swap(_image, other._image);
+    std::swap(_block, other._block);
+    std::swap(_extent, other._extent);
+    std::swap(_mip_levels, other._mip_levels);
+    std::swap(_array_layers, other._array_layers);
+    std::swap(_format, other._format);
+    std::swap(_layout, other._layout);
+}
+
 Image::~Image() {
     if (_image != VK_NULL_HANDLE) {
         vkDestroyImage(_logical_device.handle(), _image, nullptr);
@@ -132,6 +174,13 @@ void Image::transition_layout(VkCommandBuffer command_buffer,
 
         srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
         dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    } else if (_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL &&
+               new_layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+        srcStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
     } else if (_layout == VK_IMAGE_LAYOUT_UNDEFINED &&
                new_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
         barrier.srcAccessMask = 0;
@@ -159,18 +208,32 @@ std::unique_ptr<ImageView> Image::create_view(
 SwapchainImage::SwapchainImage(const Swapchain& swapchain, VkImage image)
     : Image(swapchain.device(), image, swapchain.extent().width,
             swapchain.extent().height, 1, 1, 1, swapchain.format(),
-            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED, swapchain.image_usage(),
             swapchain.image_sharing_mode(),
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {}
 
-// DepthImage
+// AttachmentImage
+
+AttachmentImage::AttachmentImage(LogicalDevice& logical_device,
+                                 VkExtent2D extent, VkFormat format,
+                                 VkImageUsageFlags usage,
+                                 VkMemoryPropertyFlags properties)
+    : Image(logical_device,
+            CreateAttachment(logical_device, extent, format, usage),
+            extent.width, extent.height, 1, 1, 1, format,
+            VK_IMAGE_LAYOUT_UNDEFINED, usage, VK_SHARING_MODE_EXCLUSIVE,
+            properties) {}
+
+VkMemoryRequirements AttachmentImage::memory_requirements(
+    Memory::Resource& resource) const {
+    return _logical_device.image_memory_requirements(_image, resource);
+}
 
-DepthImage::DepthImage(const Swapchain& swapchain, VkFormat depth_format)
-    : Image(swapchain.device(), VK_IMAGE_TYPE_2D, swapchain.extent().width,
-            swapchain.extent().height, 1, 1, 1, depth_format,
-            VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-            VK_SHARING_MODE_EXCLUSIVE, VK_SAMPLE_COUNT_1_BIT, 0,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {}
+void AttachmentImage::bind(const Memory::Block& block) {
+    if (vkBindImageMemory(_logical_device.handle(), _image, block.memory(),
+                          block.offset().value) != VK_SUCCESS) {
+        throw std::runtime_error("Could not bind attachment memory!");
+    }
+}
 
 }
\ No newline at end of file
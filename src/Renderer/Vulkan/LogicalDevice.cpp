@@ -12,6 +12,10 @@
 // ----- libraries -----
 
 // ----- in-project dependencies
+#include <Renderer/Vulkan/Descriptors/DescriptorSetLayoutCache.hpp>
+#include <Renderer/Vulkan/PhysicalDevice.hpp>
+#include <Renderer/Vulkan/Pipelines/PipelineCache.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderModuleCache.hpp>
 #include <Renderer/Vulkan/Renderer.hpp>
 #include <Renderer/Vulkan/Utils.hpp>
 #include <configuration.hpp>
@@ -40,17 +44,47 @@ LogicalDevice::LogicalDevice(PhysicalDevice& physical_device, Surface& surface)
 
     VkPhysicalDeviceFeatures required_features = {};
     required_features.samplerAnisotropy = VK_TRUE; // TODO make it optional
+    required_features.textureCompressionBC =
+        physical_device.features().textureCompressionBC;
+
+    std::vector<const char*> extensions(Renderer::RequiredExtensions.begin(),
+                                        Renderer::RequiredExtensions.end());
 
     VkDeviceCreateInfo create_info = {};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing = {};
+    descriptor_indexing.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    if (Configuration::BindlessTextures &&
+        physical_device.supports_bindless_textures()) {
+        extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+        descriptor_indexing.runtimeDescriptorArray = VK_TRUE;
+        descriptor_indexing.descriptorBindingPartiallyBound = VK_TRUE;
+        descriptor_indexing.descriptorBindingSampledImageUpdateAfterBind =
+            VK_TRUE;
+        create_info.pNext = &descriptor_indexing;
+
+        _bindless_textures = true;
+    }
+    // Queried through vkGetPhysicalDeviceMemoryProperties2, core since 1.1
+    if (physical_device.properties().apiVersion >= VK_API_VERSION_1_1 &&
+        physical_device.supports_extension(
+            VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        _memory_budget = true;
+    }
+    _dedicated_allocation =
+        physical_device.properties().apiVersion >= VK_API_VERSION_1_1;
+
     create_info.queueCreateInfoCount = queue_create_infos.size();
     create_info.pQueueCreateInfos = queue_create_infos.data();
 
     create_info.pEnabledFeatures = &required_features;
 
-    create_info.enabledExtensionCount = Renderer::RequiredExtensions.size();
-    create_info.ppEnabledExtensionNames = Renderer::RequiredExtensions.data();
+    create_info.enabledExtensionCount = extensions.size();
+    create_info.ppEnabledExtensionNames = extensions.data();
 
     if constexpr (Configuration::EnableVulkanValidationLayers) {
         create_info.enabledLayerCount = Renderer::ValidationLayers.size();
@@ -66,16 +100,81 @@ LogicalDevice::LogicalDevice(PhysicalDevice& physical_device, Surface& surface)
 
     vkGetDeviceQueue(_device, *indices.graphics_family, 0, &_graphics_queue);
     vkGetDeviceQueue(_device, *indices.present_family, 0, &_present_queue);
+
+    _pipeline_cache = std::make_unique<PipelineCache>(
+        *this, physical_device, Configuration::PipelineCacheFile);
+    _shader_modules = std::make_unique<ShaderModuleCache>(*this);
+    _descriptor_set_layouts = std::make_unique<DescriptorSetLayoutCache>(*this);
 }
 LogicalDevice::~LogicalDevice() {
     _allocator.deallocate();
     vkDeviceWaitIdle(_device);
+    _descriptor_set_layouts.reset();
+    _shader_modules.reset();
+    _pipeline_cache.reset();
     vkDestroyDevice(_device, nullptr);
 }
 
-const Memory::Block& LogicalDevice::request_memory(
-    VkMemoryRequirements mem_req, VkMemoryPropertyFlags properties) {
-    return _allocator.request_memory(mem_req, properties);
+const Memory::Block& LogicalDevice::request_buffer_memory(
+    VkBuffer buffer, VkMemoryPropertyFlags properties,
+    Memory::Category category) {
+    Memory::Resource resource;
+    resource.buffer = buffer;
+    if (!_dedicated_allocation) {
+        VkMemoryRequirements mem_req;
+        vkGetBufferMemoryRequirements(_device, buffer, &mem_req);
+        return _allocator.request_memory(mem_req, properties, category,
+                                         resource);
+    }
+
+    VkBufferMemoryRequirementsInfo2 info = {};
+    info.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2;
+    info.buffer = buffer;
+    VkMemoryDedicatedRequirements dedicated = {};
+    dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 mem_req = {};
+    mem_req.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    mem_req.pNext = &dedicated;
+    vkGetBufferMemoryRequirements2(_device, &info, &mem_req);
+
+    resource.prefers_dedicated = dedicated.prefersDedicatedAllocation ||
+                                 dedicated.requiresDedicatedAllocation;
+    resource.requires_dedicated = dedicated.requiresDedicatedAllocation;
+    return _allocator.request_memory(mem_req.memoryRequirements, properties,
+                                     category, resource);
+}
+
+const Memory::Block& LogicalDevice::request_image_memory(
+    VkImage image, VkMemoryPropertyFlags properties,
+    Memory::Category category) {
+    Memory::Resource resource;
+    const auto mem_req = image_memory_requirements(image, resource);
+    return _allocator.request_memory(mem_req, properties, category, resource);
+}
+
+VkMemoryRequirements LogicalDevice::image_memory_requirements(
+    VkImage image, Memory::Resource& resource) const {
+    resource.image = image;
+    if (!_dedicated_allocation) {
+        VkMemoryRequirements mem_req;
+        vkGetImageMemoryRequirements(_device, image, &mem_req);
+        return mem_req;
+    }
+
+    VkImageMemoryRequirementsInfo2 info = {};
+    info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2;
+    info.image = image;
+    VkMemoryDedicatedRequirements dedicated = {};
+    dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    VkMemoryRequirements2 mem_req = {};
+    mem_req.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    mem_req.pNext = &dedicated;
+    vkGetImageMemoryRequirements2(_device, &info, &mem_req);
+
+    resource.prefers_dedicated = dedicated.prefersDedicatedAllocation ||
+                                 dedicated.requiresDedicatedAllocation;
+    resource.requires_dedicated = dedicated.requiresDedicatedAllocation;
+    return mem_req.memoryRequirements;
 }
 
 void LogicalDevice::release_memory(const Vulkan::Memory::Block& block) {
@@ -6,48 +6,542 @@
 #include <Renderer/Vulkan/Memory/Allocator.hpp>
 
 // ----- std -----
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_set>
 
 // ----- libraries -----
 #include <Core/Logger/StreamLogger.hpp>
 
 // ----- in-project dependencies
+#include <Profiling/Trace.hpp>
 #include <Renderer/Vulkan/LogicalDevice.hpp>
 #include <Renderer/Vulkan/Memory/Chunk.hpp>
 #include <Renderer/Vulkan/PhysicalDevice.hpp>
+#include <configuration.hpp>
 
 namespace Vulkan::Memory {
+namespace {
+// Threads take the caches in the order of their first use of one
+unsigned int ThreadCacheIndex() {
+    static std::atomic<unsigned int> next = 0;
+    thread_local const unsigned int index = next.fetch_add(1);
+    return index;
+}
+
+void TraceUsage(const Allocator& allocator) {
+    if (Profiling::Recording()) {
+        Profiling::Counter("Device memory allocated",
+                           static_cast<double>(allocator.allocated_size()));
+        Profiling::Counter("Device memory used",
+                           static_cast<double>(allocator.used_size()));
+    }
+}
+
+void AddChunk(Allocator::Usage& usage, const Chunk& chunk) {
+    ++usage.chunk_count;
+    usage.allocation_count += chunk.allocation_count();
+    usage.allocated_size += chunk.size().value;
+    usage.used_size += chunk.used_size();
+    usage.free_size += chunk.size().value - chunk.used_size();
+    usage.largest_free_block =
+        std::max(usage.largest_free_block, chunk.largest_free_block());
+}
+
+void AddUsage(Allocator::Usage& usage, const Allocator::Usage& other) {
+    usage.chunk_count += other.chunk_count;
+    usage.allocation_count += other.allocation_count;
+    usage.allocated_size += other.allocated_size;
+    usage.used_size += other.used_size;
+    usage.free_size += other.free_size;
+    usage.largest_free_block =
+        std::max(usage.largest_free_block, other.largest_free_block);
+}
+
+void WriteUsage(std::ostream& out, const Allocator::Usage& usage) {
+    out << "\"chunks\": " << usage.chunk_count
+        << ", \"allocations\": " << usage.allocation_count
+        << ", \"allocated_bytes\": " << usage.allocated_size
+        << ", \"used_bytes\": " << usage.used_size
+        << ", \"free_bytes\": " << usage.free_size
+        << ", \"largest_free_block\": " << usage.largest_free_block
+        << ", \"fragmentation\": " << usage.fragmentation();
+}
+
+// Largest power of two not above the value, which is not 0
+VkDeviceSize FloorPowerOfTwo(VkDeviceSize value) {
+    VkDeviceSize result = 1;
+    while (result <= value / 2) {
+        result *= 2;
+    }
+    return result;
+}
+}  // namespace
+
+double Allocator::Usage::fragmentation() const {
+    return free_size == 0 ? 0.0
+                          : 1.0 - static_cast<double>(largest_free_block) /
+                                      static_cast<double>(free_size);
+}
 
 Allocator::Allocator(const PhysicalDevice& physical_device,
                      const LogicalDevice& logical_device)
-    : _physical_device(physical_device), _logical_device(logical_device) {}
+    : _physical_device(physical_device), _logical_device(logical_device) {
+    vkGetPhysicalDeviceMemoryProperties(_physical_device.handle(),
+                                        &_memory_properties);
+}
+
+void Allocator::deallocate() {
+    flush_caches();
+    for (auto& type : _memory_types) {
+        std::unique_lock lock(type.guard);
+        drain(type);
+    }
+
+    report_leaks(std::cerr);
+    for (auto& shard : _shards) {
+        shard.allocations.clear();
+    }
+    for (auto& type : _memory_types) {
+        type.chunks.clear();
+    }
+    _allocated_size = 0;
+    _used_size = 0;
+    _evacuating_chunks = 0;
+}
 
-void Allocator::deallocate() { _chunks.clear(); }
+Allocator::AllocationShard& Allocator::shard_of(const Block* block) const {
+    // Blocks are nodes of the chunk trees, the low bits are the same for all
+    return _shards[(reinterpret_cast<std::uintptr_t>(block) >> 6u) %
+                   AllocationShards];
+}
+
+Allocator::ThreadCache& Allocator::thread_cache() {
+    return _caches[ThreadCacheIndex() % _caches.size()];
+}
+
+void Allocator::record(const Block& block, const Allocation& allocation) {
+    auto& shard = shard_of(&block);
+    std::unique_lock lock(shard.guard);
+    shard.allocations[&block] = allocation;
+}
+
+VkDeviceSize Allocator::chunk_size(const MemoryType& type,
+                                   unsigned int memory_type,
+                                   VkDeviceSize request_size) const {
+    // Doubles with every shared chunk of the type
+    auto size = static_cast<VkDeviceSize>(Configuration::MemoryChunkBaseSize);
+    for (const auto& chunk : type.chunks) {
+        if (!chunk.dedicated() && size < Configuration::MemoryChunkMaxSize) {
+            size *= 2;
+        }
+    }
+
+    // Small heaps, e.g. the host-visible device-local one of some discrete
+    // cards, are not taken up by a handful of chunks
+    const auto heap_size =
+        _memory_properties
+            .memoryHeaps[_memory_properties.memoryTypes[memory_type].heapIndex]
+            .size;
+    size = std::min<VkDeviceSize>(
+        {size, Configuration::MemoryChunkMaxSize,
+         FloorPowerOfTwo(std::max<VkDeviceSize>(heap_size / 8, 1))});
+
+    // Blocks are powers of two, as are the chunks they are split from
+    return std::max(size, CeilPowerOfTwo(request_size));
+}
 
 const Block& Allocator::request_memory(VkMemoryRequirements memory_requirements,
-                                       VkMemoryPropertyFlags properties) {
-    using namespace Core::SizeLiterals;
+                                       VkMemoryPropertyFlags properties,
+                                       Category category,
+                                       const Resource& resource) {
+    TRACE_ZONE("Allocator::request_memory");
     auto memory_type_index = Utils::FindMemoryType(
         _physical_device, memory_requirements.memoryTypeBits, properties);
-    auto [begin, end] = _chunks.equal_range(memory_type_index);
-    for (auto it = begin; it != end; ++it) {
-        if (auto block = it->second.request_memory(memory_requirements)) {
-            return block->get();
+    const auto dedicated =
+        resource.prefers_dedicated ||
+        memory_requirements.size >= Configuration::DedicatedAllocationSize;
+    const Allocation allocation{memory_type_index, category,
+                                TagScope::current()};
+
+    const auto block_size = CeilPowerOfTwo(memory_requirements.size);
+    const Block* block = nullptr;
+    if (!dedicated && block_size <= Configuration::AllocatorCachedBlockSize) {
+        auto& cache = thread_cache();
+        std::unique_lock lock(cache.guard);
+        auto it = std::find_if(
+            cache.blocks.begin(), cache.blocks.end(),
+            [&](const Block* cached) {
+                return cached->_owner.memory_type() == memory_type_index &&
+                       cached->size().value == block_size &&
+                       cached->is_aligned(memory_requirements.alignment) &&
+                       !cached->_owner.evacuating();
+            });
+        if (it != cache.blocks.end()) {
+            block = *it;
+            *it = cache.blocks.back();
+            cache.blocks.pop_back();
+            _cached_size -= block_size;
         }
     }
 
-    auto new_it = _chunks.emplace(
-        std::piecewise_construct, std::forward_as_tuple(memory_type_index),
-        std::forward_as_tuple(_logical_device, properties, memory_type_index,
-                              256_MB));
+    if (!block) {
+        auto& type = _memory_types[memory_type_index];
+        std::unique_lock lock(type.guard);
+        drain(type);
+        block = &place(type, memory_type_index, memory_requirements,
+                       properties, dedicated, resource);
+    }
 
-    const auto& ret = new_it->second.request_memory(memory_requirements)->get();
+    _used_size += block->size().value;
+    record(*block, allocation);
+    TraceUsage(*this);
 
-    return ret;
+    return *block;
+}
+
+const Block& Allocator::place(MemoryType& type, unsigned int memory_type,
+                              VkMemoryRequirements memory_requirements,
+                              VkMemoryPropertyFlags properties, bool dedicated,
+                              const Resource& resource) {
+    for (auto& chunk : type.chunks) {
+        if (dedicated || chunk.dedicated() || chunk.evacuating()) {
+            continue;
+        }
+        if (auto found = chunk.request_memory(memory_requirements)) {
+            return found->get();
+        }
+    }
+
+    const auto size =
+        dedicated ? memory_requirements.size
+                  : chunk_size(type, memory_type, memory_requirements.size);
+    auto& chunk = type.chunks.emplace_back(_logical_device, properties,
+                                           memory_type, size,
+                                           dedicated ? &resource : nullptr);
+    auto found = chunk.request_memory(memory_requirements);
+    if (!found) {
+        type.chunks.pop_back();
+        throw std::runtime_error("Could not place memory block in chunk");
+    }
+    _allocated_size += chunk.size().value;
+    ++_chunk_changes;
+    return found->get();
 }
 
 void Allocator::release_memory(const Vulkan::Memory::Block& block) {
+    TRACE_ZONE("Allocator::release_memory");
+    const auto size = block.size().value;
+    {
+        auto& shard = shard_of(&block);
+        std::unique_lock lock(shard.guard);
+        shard.allocations.erase(&block);
+    }
+    _used_size -= size;
+
+    const auto& chunk = block._owner;
+    if (!chunk.dedicated() && size <= Configuration::AllocatorCachedBlockSize) {
+        auto& cache = thread_cache();
+        std::unique_lock lock(cache.guard);
+        // Checked under the lock, so a chunk marked meanwhile finds the block
+        // when releasing its cached ones
+        if (!chunk.evacuating() &&
+            cache.blocks.size() < Configuration::AllocatorCacheCapacity) {
+            cache.blocks.push_back(&block);
+            _cached_size += size;
+            TraceUsage(*this);
+            return;
+        }
+    }
+
+    release_to_chunk(block);
+    TraceUsage(*this);
+}
+
+void Allocator::release_to_chunk(const Block& block) {
+    auto& type = _memory_types[block._owner.memory_type()];
+    std::unique_lock lock(type.guard, std::try_to_lock);
+    if (lock) {
+        release_locked(type, block);
+    } else {
+        auto* pending = new PendingRelease{
+            &block, type.pending.load(std::memory_order_relaxed)};
+        while (!type.pending.compare_exchange_weak(pending->next, pending,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+        }
+        // Released by the holder, unless it let go meanwhile
+        if (!lock.try_lock()) {
+            return;
+        }
+    }
+    drain(type);
+}
+
+void Allocator::release_locked(MemoryType& type, const Block& block) const {
     auto& chunk = block._owner;
     chunk.release_memory(block);
+    ++_chunk_changes;
+    free_if_unused(type, chunk);
 }
 
+void Allocator::drain(MemoryType& type) const {
+    auto* pending = type.pending.exchange(nullptr, std::memory_order_acquire);
+    while (pending) {
+        release_locked(type, *pending->block);
+        auto* next = pending->next;
+        delete pending;
+        pending = next;
+    }
+}
+
+void Allocator::flush_caches() {
+    for (auto& cache : _caches) {
+        std::vector<const Block*> blocks;
+        {
+            std::unique_lock lock(cache.guard);
+            blocks.swap(cache.blocks);
+        }
+        for (const auto* block : blocks) {
+            _cached_size -= block->size().value;
+            release_to_chunk(*block);
+        }
+    }
+}
+
+void Allocator::release_cached(MemoryType& type, const Chunk& chunk) {
+    std::vector<const Block*> blocks;
+    for (auto& cache : _caches) {
+        std::unique_lock lock(cache.guard);
+        const auto owned = std::partition(
+            cache.blocks.begin(), cache.blocks.end(),
+            [&chunk](const Block* block) { return &block->_owner != &chunk; });
+        blocks.insert(blocks.end(), owned, cache.blocks.end());
+        cache.blocks.erase(owned, cache.blocks.end());
+    }
+    for (const auto* block : blocks) {
+        _cached_size -= block->size().value;
+        release_locked(type, *block);
+    }
+}
+
+void Allocator::free_if_unused(MemoryType& type, const Chunk& chunk) const {
+    if (!chunk.empty()) {
+        return;
+    }
+
+    auto freed = type.chunks.end();
+    auto spares = 0u;
+    for (auto it = type.chunks.begin(); it != type.chunks.end(); ++it) {
+        if (&*it == &chunk) {
+            freed = it;
+        } else if (!it->dedicated() && it->empty()) {
+            ++spares;
+        }
+    }
+    if (freed == type.chunks.end() ||
+        (!chunk.dedicated() && !chunk.evacuating() && spares == 0)) {
+        return;
+    }
+
+    if (chunk.evacuating()) {
+        --_evacuating_chunks;
+    }
+    _allocated_size -= chunk.size().value;
+    type.chunks.erase(freed);
+}
+
+bool Allocator::begin_evacuation(double max_occupancy,
+                                 const std::vector<Category>& relocatable) {
+    if (evacuation_in_progress()) {
+        return true;
+    }
+    if (const auto changes = _chunk_changes.load();
+        _checked_changes.exchange(changes) == changes) {
+        return false;
+    }
+
+    // Blocks of other categories would keep the chunks alive, cached blocks
+    // are not recorded, they are released when their chunk is marked
+    std::unordered_set<const Chunk*> pinned;
+    for (auto& shard : _shards) {
+        std::unique_lock lock(shard.guard);
+        for (const auto& [block, allocation] : shard.allocations) {
+            if (std::find(relocatable.begin(), relocatable.end(),
+                          allocation.category) == relocatable.end()) {
+                pinned.insert(&block->_owner);
+            }
+        }
+    }
+
+    auto evacuating = false;
+    for (auto& type : _memory_types) {
+        std::unique_lock lock(type.guard);
+        // The occupancy is measured after the deferred releases
+        drain(type);
+        for (auto it = type.chunks.begin(); it != type.chunks.end();) {
+            auto& chunk = *it++;
+            const auto occupancy = static_cast<double>(chunk.used_size()) /
+                                   static_cast<double>(chunk.size().value);
+            if (chunk.dedicated() || chunk.empty() ||
+                occupancy > max_occupancy || pinned.count(&chunk) > 0) {
+                continue;
+            }
+
+            // Otherwise the blocks would only move to a new chunk
+            VkDeviceSize room = 0;
+            for (const auto& other : type.chunks) {
+                if (&other != &chunk && !other.dedicated() &&
+                    !other.evacuating()) {
+                    room += other.size().value - other.used_size();
+                }
+            }
+            if (room < chunk.used_size()) {
+                continue;
+            }
+
+            chunk.set_evacuating(true);
+            ++_evacuating_chunks;
+            evacuating = true;
+            release_cached(type, chunk);
+        }
+    }
+    return evacuating;
+}
+
+void Allocator::end_evacuation() {
+    for (auto& type : _memory_types) {
+        std::unique_lock lock(type.guard);
+        for (auto& chunk : type.chunks) {
+            if (chunk.evacuating()) {
+                chunk.set_evacuating(false);
+                --_evacuating_chunks;
+            }
+        }
+    }
+}
+
+Allocator::Statistics Allocator::statistics() const {
+    Statistics statistics;
+    for (auto i = 0u; i < _memory_types.size(); ++i) {
+        std::unique_lock lock(_memory_types[i].guard);
+        drain(_memory_types[i]);
+        for (const auto& chunk : _memory_types[i].chunks) {
+            AddChunk(statistics.memory_types[i], chunk);
+        }
+    }
+    for (auto& shard : _shards) {
+        std::unique_lock lock(shard.guard);
+        for (const auto& [block, allocation] : shard.allocations) {
+            const auto index = static_cast<std::size_t>(allocation.category);
+            auto& category = statistics.categories[index];
+            ++category.allocation_count;
+            category.used_size += block->size().value;
+        }
+    }
+    statistics.cached_size = _cached_size.load();
+
+    VkPhysicalDeviceMemoryProperties memory_properties = {};
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget = {};
+    budget.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    statistics.budget_available = _logical_device.memory_budget();
+    if (statistics.budget_available) {
+        // Core since 1.1, the instance is created for that
+        VkPhysicalDeviceMemoryProperties2 properties = {};
+        properties.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties.pNext = &budget;
+        vkGetPhysicalDeviceMemoryProperties2(_physical_device.handle(),
+                                             &properties);
+        memory_properties = properties.memoryProperties;
+    } else {
+        vkGetPhysicalDeviceMemoryProperties(_physical_device.handle(),
+                                            &memory_properties);
+    }
+
+    statistics.heaps.resize(memory_properties.memoryHeapCount);
+    for (auto i = 0u; i < memory_properties.memoryHeapCount; ++i) {
+        auto& heap = statistics.heaps[i];
+        heap.size = memory_properties.memoryHeaps[i].size;
+        heap.flags = memory_properties.memoryHeaps[i].flags;
+        heap.budget = budget.heapBudget[i];
+        heap.process_usage = budget.heapUsage[i];
+    }
+    for (const auto& [memory_type, usage] : statistics.memory_types) {
+        const auto heap =
+            memory_properties.memoryTypes[memory_type].heapIndex;
+        AddUsage(statistics.heaps.at(heap).usage, usage);
+        AddUsage(statistics.total, usage);
+    }
+    return statistics;
+}
+
+void Allocator::report_leaks(std::ostream& out) const {
+    std::vector<std::pair<const Block*, Allocation>> leaks;
+    for (auto& shard : _shards) {
+        std::unique_lock lock(shard.guard);
+        leaks.insert(leaks.end(), shard.allocations.begin(),
+                     shard.allocations.end());
+    }
+    if (leaks.empty()) {
+        return;
+    }
+
+    std::sort(leaks.begin(), leaks.end(), [](const auto& a, const auto& b) {
+        return a.first->size() > b.first->size();
+    });
+
+    out << leaks.size() << " device memory blocks were never released:\n";
+    for (const auto& [block, allocation] : leaks) {
+        out << "  " << block->size().value << " bytes, "
+            << CategoryName(allocation.category) << ", memory type "
+            << allocation.memory_type << ", tagged " << allocation.tag
+            << "\n";
+    }
+    out << std::flush;
+}
+
+void WriteJson(std::ostream& out, const Allocator::Statistics& statistics) {
+    out << "{";
+    WriteUsage(out, statistics.total);
+    out << ", \"cached_bytes\": " << statistics.cached_size;
+
+    out << ", \"memory_types\": [";
+    auto first = true;
+    for (const auto& [memory_type, usage] : statistics.memory_types) {
+        out << (first ? "" : ", ") << "{\"index\": " << memory_type << ", ";
+        WriteUsage(out, usage);
+        out << "}";
+        first = false;
+    }
+
+    out << "], \"heaps\": [";
+    for (auto i = 0u; i < statistics.heaps.size(); ++i) {
+        const auto& heap = statistics.heaps[i];
+        out << (i == 0 ? "" : ", ") << "{\"index\": " << i
+            << ", \"size\": " << heap.size << ", \"device_local\": "
+            << ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "true"
+                                                                : "false")
+            << ", ";
+        WriteUsage(out, heap.usage);
+        if (statistics.budget_available) {
+            out << ", \"budget\": " << heap.budget
+                << ", \"process_usage\": " << heap.process_usage;
+        }
+        out << "}";
+    }
+
+    out << "], \"categories\": {";
+    for (auto i = 0u; i < CategoryCount; ++i) {
+        const auto& category = statistics.categories[i];
+        out << (i == 0 ? "" : ", ") << "\""
+            << CategoryName(static_cast<Category>(i))
+            << "\": {\"allocations\": " << category.allocation_count
+            << ", \"used_bytes\": " << category.used_size << "}";
+    }
+    out << "}}";
+}
 }  // namespace Vulkan::Memory
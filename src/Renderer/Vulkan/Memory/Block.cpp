@@ -21,4 +21,10 @@ void Block::transfer(void* data, size_t size, size_t target_offset) const {
     _owner.unmap();
 }
 
+void Block::read(void* data, size_t size, size_t source_offset) const {
+    _owner.map();
+    _owner.read(data, size, _offset + source_offset);
+    _owner.unmap();
+}
+
 }  // namespace Vulkan::Memory
@@ -0,0 +1,78 @@
+//
+// Created by Dániel Molnár on 2019-11-09.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Memory/Category.hpp>
+
+// ----- std -----
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+
+namespace Vulkan::Memory {
+namespace {
+thread_local const char* CurrentTag = nullptr;
+}  // namespace
+
+const char* CategoryName(Category category) {
+    switch (category) {
+        case Category::Geometry:
+            return "geometry";
+        case Category::Uniform:
+            return "uniform";
+        case Category::Storage:
+            return "storage";
+        case Category::Staging:
+            return "staging";
+        case Category::Readback:
+            return "readback";
+        case Category::Texture:
+            return "texture";
+        case Category::Attachment:
+            return "attachment";
+        case Category::Other:
+        default:
+            return "other";
+    }
+}
+
+Category BufferCategory(VkBufferUsageFlags usage,
+                        VkMemoryPropertyFlags properties) {
+    const auto host_visible = properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
+        return Category::Geometry;
+    } else if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+        return Category::Uniform;
+    } else if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+        return Category::Storage;
+    } else if (host_visible && (usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT)) {
+        return Category::Readback;
+    } else if (host_visible && (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT)) {
+        return Category::Staging;
+    }
+    return Category::Other;
+}
+
+Category ImageCategory(VkImageUsageFlags usage) {
+    if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                 VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+        return Category::Attachment;
+    } else if (usage & VK_IMAGE_USAGE_SAMPLED_BIT) {
+        return Category::Texture;
+    }
+    return Category::Other;
+}
+
+TagScope::TagScope(const char* tag) : _previous(CurrentTag) {
+    CurrentTag = tag;
+}
+
+TagScope::~TagScope() { CurrentTag = _previous; }
+
+const char* TagScope::current() {
+    return CurrentTag ? CurrentTag : "untagged";
+}
+}  // namespace Vulkan::Memory
@@ -6,8 +6,8 @@
 #include <Renderer/Vulkan/Memory/Chunk.hpp>
 
 // ----- std -----
+#include <algorithm>
 #include <cstring>
-#include <iostream>  // todo remove
 
 // ----- libraries -----
 
@@ -15,18 +15,23 @@
 #include <Core/Logger/StreamLogger.hpp>
 #include <Renderer/Vulkan/LogicalDevice.hpp>
 
-namespace {
-unsigned int get_greater_power_of_two(unsigned int of) {
-    return std::pow(2, std::ceil(std::log2(of)));
-}
-}  // namespace
-
 namespace Vulkan::Memory {
+VkDeviceSize CeilPowerOfTwo(VkDeviceSize value) {
+    VkDeviceSize result = 1;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
 
 Chunk::Chunk(const Vulkan::LogicalDevice& logical_device,
              VkMemoryPropertyFlags properties, unsigned int memory_type_index,
-             Core::SizeLiterals::Byte size)
-    : _logical_device(logical_device), _properties(properties), _size(size) {
+             Core::SizeLiterals::Byte size, const Resource* dedicated_to)
+    : _logical_device(logical_device),
+      _properties(properties),
+      _memory_type(memory_type_index),
+      _size(size),
+      _dedicated(dedicated_to != nullptr) {
     using namespace Core::SizeLiterals;
     VkMemoryAllocateInfo alloc_info = {};
     alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -34,6 +39,15 @@ Chunk::Chunk(const Vulkan::LogicalDevice& logical_device,
     Core::SizeLiterals::Byte byte_size = size;
     alloc_info.allocationSize = byte_size.value;
 
+    VkMemoryDedicatedAllocateInfo dedicated_info = {};
+    dedicated_info.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    if (dedicated_to && _logical_device.dedicated_allocation() &&
+        (dedicated_to->buffer || dedicated_to->image)) {
+        dedicated_info.buffer = dedicated_to->buffer;
+        dedicated_info.image = dedicated_to->image;
+        alloc_info.pNext = &dedicated_info;
+    }
+
     if (vkAllocateMemory(_logical_device.handle(), &alloc_info, nullptr,
                          &_memory) != VK_SUCCESS) {
         throw std::runtime_error("Could not allocate memory chunk!");
@@ -129,22 +143,52 @@ std::optional<std::reference_wrapper<const Block>> Chunk::find_or_create_suffici
 std::optional<std::reference_wrapper<const Block>> Chunk::request_memory(
     VkMemoryRequirements memory_requirements) {
     using namespace Core::SizeLiterals;
-    Byte nearest = get_greater_power_of_two(memory_requirements.size);
-
-    const auto& ret =
-        find_or_create_sufficient_node(nearest, memory_requirements.alignment);
-    ret->get().set_free(false);
+    std::optional<std::reference_wrapper<const Block>> ret;
+    if (_dedicated) {
+        // The single block spans the whole chunk, and is never split
+        if (auto root = _blocks.find(Block(*this, _size, 0_B));
+            root && root->get().value().free() &&
+            memory_requirements.size <= _size.value) {
+            ret = std::cref(root->get().value());
+        }
+    } else {
+        Byte nearest = CeilPowerOfTwo(memory_requirements.size);
+        ret = find_or_create_sufficient_node(nearest,
+                                             memory_requirements.alignment);
+    }
+    if (ret) {
+        ret->get().set_free(false);
+        _used_size += ret->get().size().value;
+        ++_allocation_count;
+    }
 
     return ret;
 }
 
 void Chunk::release_memory(const Vulkan::Memory::Block& block) {
+    _used_size -= block.size().value;
+    --_allocation_count;
     block.set_free(true);
     if (auto node = _blocks.find(block)) {
         try_merge(node->get());
     }
 }
 
+VkDeviceSize Chunk::largest_free_block() const {
+    namespace DFS = Core::DFS;
+    VkDeviceSize largest = 0;
+    // Only split nodes are taken without being handed out, free nodes are
+    // always leaves. The view does not modify the tree.
+    auto view = DFS::View(const_cast<MemoryTree&>(_blocks));
+    for (auto it = view.begin(); it != view.end(); ++it) {
+        const auto& block = it->value();
+        if (block.free()) {
+            largest = std::max<VkDeviceSize>(largest, block.size().value);
+        }
+    }
+    return largest;
+}
+
 void Chunk::map() {
     if (!(_properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
         throw std::runtime_error("Trying to map non-host-visible memory!");
@@ -170,4 +214,9 @@ void Chunk::transfer(void* data, size_t size, Core::SizeLiterals::Byte offset) {
     std::memcpy(_data + offset.value, data, size);
 }
 
+void Chunk::read(void* data, size_t size,
+                 Core::SizeLiterals::Byte offset) const {
+    std::memcpy(data, _data + offset.value, size);
+}
+
 }
\ No newline at end of file
@@ -109,10 +109,57 @@ Vulkan::PhysicalDevice::PhysicalDevice(Vulkan::Instance& instance,
         }
     }
 
+    if (_device == VK_NULL_HANDLE)
+        throw std::runtime_error("Failed to find suitable GPU");
+
     vkGetPhysicalDeviceProperties(_device, &_properties);
     vkGetPhysicalDeviceFeatures(_device, &_features);
 
-    if (_device == VK_NULL_HANDLE)
-        throw std::runtime_error("Failed to find suitable GPU");
+    query_extension_features();
+}
+
+void PhysicalDevice::query_extension_features() {
+    unsigned int extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(_device, nullptr, &extension_count,
+                                         nullptr);
+
+    std::vector<VkExtensionProperties> extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(_device, nullptr, &extension_count,
+                                         extensions.data());
+
+    for (const auto& extension : extensions) {
+        _extensions.emplace(extension.extensionName);
+    }
+
+    // The *2 queries are core since 1.1, the instance is created for that
+    if (_properties.apiVersion < VK_API_VERSION_1_1 ||
+        !supports_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+        return;
+    }
+
+    _descriptor_indexing_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &_descriptor_indexing_features;
+    vkGetPhysicalDeviceFeatures2(_device, &features);
+
+    _descriptor_indexing_properties.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2 properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &_descriptor_indexing_properties;
+    vkGetPhysicalDeviceProperties2(_device, &properties);
+
+    // Nothing else is chained, do not keep dangling pointers around
+    _descriptor_indexing_features.pNext = nullptr;
+    _descriptor_indexing_properties.pNext = nullptr;
+}
+
+bool PhysicalDevice::supports_bindless_textures() const {
+    const auto& features = _descriptor_indexing_features;
+    return features.runtimeDescriptorArray &&
+           features.descriptorBindingPartiallyBound &&
+           features.descriptorBindingSampledImageUpdateAfterBind;
 }
 }  // namespace Vulkan
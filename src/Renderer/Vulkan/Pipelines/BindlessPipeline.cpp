@@ -0,0 +1,33 @@
+//
+// Created by Dániel Molnár on 2019-10-24.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Pipelines/BindlessPipeline.hpp>
+
+// ----- std -----
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/Representation.hpp>
+
+namespace Vulkan {
+
+const IPipeline::VertexBindingDescContainer&
+BindlessPipeline::BindingDescriptions() {
+    static IPipeline::VertexBindingDescContainer binding_descs = {
+        Vertex::binding_description()};
+
+    return binding_descs;
+}
+
+const IPipeline::VertexAttribDescContainer&
+BindlessPipeline::AttributeDescriptions() {
+    static IPipeline::VertexAttribDescContainer attrib_descs(
+        Vertex::attribute_descriptions().begin(),
+        Vertex::attribute_descriptions().end());
+
+    return attrib_descs;
+}
+}  // namespace Vulkan
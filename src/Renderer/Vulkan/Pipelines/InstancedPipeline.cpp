@@ -42,10 +42,4 @@ InstancedPipeline::AttributeDescriptions() {
     return attrib_descs;
 }
 
-const IPipeline::PushConstantContainer& InstancedPipeline::PushConstants() {
-    static IPipeline::PushConstantContainer push_constants;
-
-    return push_constants;
-}
-
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+//
+// Created by Dániel Molnár on 2019-10-27.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Pipelines/PipelineCache.hpp>
+
+// ----- std -----
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/File.hpp>
+#include <Data/Hash.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/PhysicalDevice.hpp>
+
+namespace {
+// headerSize, headerVersion, vendorID, deviceID and pipelineCacheUUID
+constexpr const size_t HeaderSize = 4 * sizeof(std::uint32_t) + VK_UUID_SIZE;
+
+std::uint32_t ReadUint32(const std::vector<std::byte>& data, size_t offset) {
+    std::uint32_t value;
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+    return value;
+}
+
+// A cache written by another driver version or another device is rejected by
+// most drivers anyway, but some of them crash on it instead
+bool IsCompatible(const std::vector<std::byte>& data,
+                  const VkPhysicalDeviceProperties& properties) {
+    if (data.size() < HeaderSize) {
+        return false;
+    }
+
+    const auto header_size = ReadUint32(data, 0);
+    const auto header_version = ReadUint32(data, 4);
+    const auto vendor_id = ReadUint32(data, 8);
+    const auto device_id = ReadUint32(data, 12);
+
+    return header_size >= HeaderSize && header_size <= data.size() &&
+           header_version == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           vendor_id == properties.vendorID &&
+           device_id == properties.deviceID &&
+           std::memcmp(data.data() + 16, properties.pipelineCacheUUID,
+                       VK_UUID_SIZE) == 0;
+}
+}  // namespace
+
+namespace Vulkan {
+PipelineCache::PipelineCache(const LogicalDevice& logical_device,
+                             const PhysicalDevice& physical_device,
+                             std::filesystem::path path)
+    : _logical_device(logical_device), _path(std::move(path)) {
+    auto data = File::Read(_path).value_or(std::vector<std::byte>{});
+    if (!IsCompatible(data, physical_device.properties())) {
+        data.clear();
+    }
+
+    VkPipelineCacheCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    create_info.initialDataSize = data.size();
+    create_info.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(_logical_device.handle(), &create_info, nullptr,
+                              &_cache) != VK_SUCCESS) {
+        throw std::runtime_error("Could not create pipeline cache");
+    }
+
+    _warm = !data.empty();
+    if (_warm) {
+        _saved_hash = Hash::FNV1a(data.data(), data.size());
+    }
+}
+
+PipelineCache::~PipelineCache() {
+    vkDestroyPipelineCache(_logical_device.handle(), _cache, nullptr);
+}
+
+void PipelineCache::save() {
+    size_t size = 0;
+    if (vkGetPipelineCacheData(_logical_device.handle(), _cache, &size,
+                               nullptr) != VK_SUCCESS) {
+        return;
+    }
+
+    std::vector<std::byte> data(size);
+    if (vkGetPipelineCacheData(_logical_device.handle(), _cache, &size,
+                               data.data()) != VK_SUCCESS) {
+        return;
+    }
+    data.resize(size);
+
+    const auto hash = Hash::FNV1a(data.data(), data.size());
+    if (hash == _saved_hash) {
+        return;
+    }
+    if (File::Write(_path, data)) {
+        _saved_hash = hash;
+    }
+}
+
+void PipelineCache::record_creation(
+    std::chrono::steady_clock::duration duration) {
+    std::unique_lock lock(_stats_guard);
+    ++_pipelines_created;
+    _creation_time += duration;
+}
+
+unsigned int PipelineCache::pipelines_created() const {
+    std::unique_lock lock(_stats_guard);
+    return _pipelines_created;
+}
+
+std::chrono::steady_clock::duration PipelineCache::creation_time() const {
+    std::unique_lock lock(_stats_guard);
+    return _creation_time;
+}
+}  // namespace Vulkan
@@ -0,0 +1,180 @@
+//
+// Created by Dániel Molnár on 2019-10-28.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Pipelines/PipelineRegistry.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Profiling/Trace.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+
+namespace Vulkan {
+VkPipeline PipelineVariant::handle() const {
+    if (_ready.load()) {
+        return _pipeline;
+    }
+    return _fallback != nullptr ? _fallback->handle() : VK_NULL_HANDLE;
+}
+
+PipelineRegistry::PipelineRegistry(LogicalDevice& logical_device,
+                                   unsigned int thread_count)
+    : _logical_device(logical_device), _thread_count(thread_count) {
+    if (_thread_count == 0) {
+        _thread_count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+}
+
+PipelineRegistry::~PipelineRegistry() {
+    {
+        std::unique_lock lock(_jobs_guard);
+        _stopping = true;
+        _jobs.clear();
+    }
+    _job_added.notify_all();
+    for (auto& worker : _workers) worker.join();
+
+    for (const auto& [key, entry] : _variants) {
+        vkDestroyPipeline(_logical_device.handle(), entry.variant->_pipeline,
+                          nullptr);
+        vkDestroyPipelineLayout(_logical_device.handle(),
+                                entry.variant->_layout, nullptr);
+    }
+}
+
+void PipelineRegistry::work() {
+    Profiling::SetThreadName("Pipeline compiler");
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(_jobs_guard);
+            _job_added.wait(lock,
+                            [this] { return _stopping || !_jobs.empty(); });
+            if (_stopping) {
+                return;
+            }
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+            ++_running;
+        }
+
+        try {
+            TRACE_ZONE("Compile pipeline");
+            Profiling::EndFlow("Pipeline request", job.flow);
+            job.variant->_pipeline = CreateGraphicsPipeline(
+                _logical_device, job.state, job.shaders,
+                job.variant->_layout);
+            job.variant->_ready.store(true);
+        } catch (const std::runtime_error& error) {
+            // The fallback stays in use
+            std::cerr << error.what() << std::endl;
+        }
+        job.shaders.clear();
+
+        {
+            std::unique_lock lock(_jobs_guard);
+            --_running;
+        }
+        _job_done.notify_all();
+    }
+}
+
+std::shared_ptr<const PipelineVariant> PipelineRegistry::request(
+    const PipelineState& state, const IPipeline* fallback) {
+    const auto key = state.hash();
+    const auto [first, last] = _variants.equal_range(key);
+    for (auto it = first; it != last; ++it) {
+        if (it->second.state == state) {
+            return it->second.variant;
+        }
+    }
+
+    auto variant = std::make_shared<PipelineVariant>(
+        CreatePipelineLayout(_logical_device, state), fallback);
+    _variants.emplace(key, Entry{state, variant});
+    enqueue(state, variant);
+
+    return variant;
+}
+
+void PipelineRegistry::enqueue(const PipelineState& state,
+                               std::shared_ptr<PipelineVariant> variant) {
+    TRACE_ZONE("PipelineRegistry::enqueue");
+    Job job;
+    job.state = state;
+    for (const auto& stage : state.shaders) {
+        job.shaders.emplace_back(stage.load(_logical_device));
+    }
+    job.variant = std::move(variant);
+    job.flow = Profiling::BeginFlow("Pipeline request");
+
+    {
+        std::unique_lock lock(_jobs_guard);
+        _jobs.push_back(std::move(job));
+    }
+    _job_added.notify_one();
+
+    if (_workers.empty()) {
+        _workers.reserve(_thread_count);
+        for (auto i = 0u; i < _thread_count; ++i) {
+            _workers.emplace_back(&PipelineRegistry::work, this);
+        }
+    }
+}
+
+void PipelineRegistry::retarget(VkRenderPass render_pass) {
+    wait_idle();
+
+    decltype(_variants) variants;
+    for (auto& [key, entry] : _variants) {
+        entry.state.render_pass = render_pass;
+        recompile(entry);
+        variants.emplace(entry.state.hash(), std::move(entry));
+    }
+    _variants = std::move(variants);
+}
+
+void PipelineRegistry::reload(const std::vector<std::string>& file_names) {
+    wait_idle();
+
+    for (auto& [key, entry] : _variants) {
+        const auto& shaders = entry.state.shaders;
+        const auto uses_file = std::any_of(
+            shaders.begin(), shaders.end(), [&file_names](const auto& stage) {
+                return std::find(file_names.begin(), file_names.end(),
+                                 stage.file_name) != file_names.end();
+            });
+        if (uses_file) {
+            recompile(entry);
+        }
+    }
+}
+
+void PipelineRegistry::recompile(Entry& entry) {
+    auto& variant = *entry.variant;
+    variant._ready.store(false);
+    vkDestroyPipeline(_logical_device.handle(), variant._pipeline, nullptr);
+    variant._pipeline = VK_NULL_HANDLE;
+
+    enqueue(entry.state, entry.variant);
+}
+
+void PipelineRegistry::wait_idle() {
+    std::unique_lock lock(_jobs_guard);
+    _job_done.wait(lock, [this] { return _jobs.empty() && _running == 0; });
+}
+
+size_t PipelineRegistry::pending() const {
+    std::unique_lock lock(_jobs_guard);
+    return _jobs.size() + _running;
+}
+}  // namespace Vulkan
@@ -0,0 +1,263 @@
+//
+// Created by Dániel Molnár on 2019-10-28.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Pipelines/PipelineState.hpp>
+
+// ----- std -----
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/Hash.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/Pipelines/PipelineCache.hpp>
+
+namespace {
+// The Vulkan structs kept in vectors have no padding, so they are compared
+// and hashed bytewise
+template <class T>
+std::uint64_t HashBytes(const std::vector<T>& values, std::uint64_t seed) {
+    return Hash::FNV1a(values.data(), values.size() * sizeof(T), seed);
+}
+
+template <class T>
+bool EqualBytes(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() &&
+           std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+}  // namespace
+
+namespace Vulkan {
+VkPipelineColorBlendAttachmentState PipelineState::OpaqueBlend() {
+    VkPipelineColorBlendAttachmentState blend = {};
+    blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                           VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    blend.blendEnable = VK_FALSE;
+    blend.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+    blend.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+    blend.colorBlendOp = VK_BLEND_OP_ADD;
+    blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    blend.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    return blend;
+}
+
+std::uint64_t PipelineState::hash() const {
+    auto hash = Hash::FNV1aOffsetBasis;
+    for (const auto& shader : shaders) {
+        hash = Hash::FNV1a(shader.stage, hash);
+        hash = Hash::FNV1a(shader.file_name.data(), shader.file_name.size(),
+                           hash);
+        hash = Hash::FNV1a(shader.entry_point.data(),
+                           shader.entry_point.size(), hash);
+        hash = shader.specialization.hash(hash);
+    }
+    hash = HashBytes(bindings, hash);
+    hash = HashBytes(attributes, hash);
+    hash = HashBytes(set_layouts, hash);
+    hash = HashBytes(push_constants, hash);
+
+    hash = Hash::FNV1a(topology, hash);
+    hash = Hash::FNV1a(polygon_mode, hash);
+    hash = Hash::FNV1a(cull_mode, hash);
+    hash = Hash::FNV1a(front_face, hash);
+    hash = Hash::FNV1a(depth_test, hash);
+    hash = Hash::FNV1a(depth_write, hash);
+    hash = Hash::FNV1a(depth_compare_op, hash);
+    hash = Hash::FNV1a(blend, hash);
+    hash = Hash::FNV1a(render_pass, hash);
+    return Hash::FNV1a(subpass, hash);
+}
+
+bool PipelineState::operator==(const PipelineState& other) const {
+    return shaders == other.shaders && EqualBytes(bindings, other.bindings) &&
+           EqualBytes(attributes, other.attributes) &&
+           set_layouts == other.set_layouts &&
+           EqualBytes(push_constants, other.push_constants) &&
+           topology == other.topology && polygon_mode == other.polygon_mode &&
+           cull_mode == other.cull_mode && front_face == other.front_face &&
+           depth_test == other.depth_test &&
+           depth_write == other.depth_write &&
+           depth_compare_op == other.depth_compare_op &&
+           std::memcmp(&blend, &other.blend, sizeof(blend)) == 0 &&
+           render_pass == other.render_pass && subpass == other.subpass;
+}
+
+VkPipelineLayout CreatePipelineLayout(const LogicalDevice& logical_device,
+                                      const PipelineState& state) {
+    VkPipelineLayoutCreateInfo pipeline_layout_info = {};
+    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+
+    pipeline_layout_info.setLayoutCount = state.set_layouts.size();
+    pipeline_layout_info.pSetLayouts = state.set_layouts.data();
+    pipeline_layout_info.pushConstantRangeCount = state.push_constants.size();
+    pipeline_layout_info.pPushConstantRanges = state.push_constants.data();
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(logical_device.handle(), &pipeline_layout_info,
+                               nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("Could not create pipeline layout");
+    }
+    return layout;
+}
+
+VkPipeline CreateGraphicsPipeline(
+    const LogicalDevice& logical_device, const PipelineState& state,
+    const std::vector<std::unique_ptr<IShader>>& shaders,
+    VkPipelineLayout layout) {
+    std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
+    std::vector<VkSpecializationInfo> specializations;
+    shader_stages.reserve(shaders.size());
+    specializations.reserve(shaders.size());
+
+    for (auto i = 0u; i < shaders.size(); ++i) {
+        VkPipelineShaderStageCreateInfo create_info = {};
+
+        create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+
+        create_info.module = shaders[i]->module();
+        create_info.stage = shaders[i]->stage();
+        create_info.pName = shaders[i]->entry_point();
+
+        const auto& specialization = state.shaders[i].specialization;
+        if (!specialization.empty()) {
+            create_info.pSpecializationInfo =
+                &specializations.emplace_back(specialization.info());
+        }
+
+        shader_stages.push_back(create_info);
+    }
+
+    VkPipelineVertexInputStateCreateInfo vertex_input_state_info = {};
+    vertex_input_state_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    vertex_input_state_info.vertexBindingDescriptionCount =
+        state.bindings.size();
+    vertex_input_state_info.pVertexBindingDescriptions = state.bindings.data();
+    vertex_input_state_info.vertexAttributeDescriptionCount =
+        state.attributes.size();
+    vertex_input_state_info.pVertexAttributeDescriptions =
+        state.attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly_info = {};
+    input_assembly_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+
+    input_assembly_info.topology = state.topology;
+    input_assembly_info.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport and scissor are set while recording, so resizing the
+    // swapchain does not invalidate the pipeline
+    VkPipelineViewportStateCreateInfo viewport_state_info = {};
+    viewport_state_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+
+    viewport_state_info.viewportCount = 1;
+    viewport_state_info.pViewports = nullptr;
+    viewport_state_info.scissorCount = 1;
+    viewport_state_info.pScissors = nullptr;
+
+    const std::array dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT,
+                                       VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamic_state_info = {};
+    dynamic_state_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+
+    dynamic_state_info.dynamicStateCount = dynamic_states.size();
+    dynamic_state_info.pDynamicStates = dynamic_states.data();
+
+    VkPipelineRasterizationStateCreateInfo rasterization_state_info = {};
+    rasterization_state_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+
+    rasterization_state_info.depthClampEnable = VK_FALSE;
+    rasterization_state_info.rasterizerDiscardEnable = VK_FALSE;
+    rasterization_state_info.polygonMode = state.polygon_mode;
+    rasterization_state_info.lineWidth = 1.0f;
+    rasterization_state_info.cullMode = state.cull_mode;
+    rasterization_state_info.frontFace = state.front_face;
+    rasterization_state_info.depthBiasEnable = VK_FALSE;
+    rasterization_state_info.depthBiasConstantFactor = 0.0f;
+    rasterization_state_info.depthBiasClamp = 0.0f;
+    rasterization_state_info.depthBiasSlopeFactor = 0.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisample_state_info = {};
+    multisample_state_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+
+    multisample_state_info.sampleShadingEnable = VK_FALSE;
+    multisample_state_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisample_state_info.minSampleShading = 1.0f;
+    multisample_state_info.pSampleMask = nullptr;
+    multisample_state_info.alphaToCoverageEnable = VK_FALSE;
+    multisample_state_info.alphaToOneEnable = VK_FALSE;
+
+    VkPipelineColorBlendStateCreateInfo color_blend_state_info = {};
+    color_blend_state_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+
+    color_blend_state_info.logicOpEnable = VK_FALSE;
+    color_blend_state_info.logicOp = VK_LOGIC_OP_COPY;
+    color_blend_state_info.attachmentCount = 1;
+    color_blend_state_info.pAttachments = &state.blend;
+    color_blend_state_info.blendConstants[0] = 0.0f;
+    color_blend_state_info.blendConstants[1] = 0.0f;
+    color_blend_state_info.blendConstants[2] = 0.0f;
+    color_blend_state_info.blendConstants[3] = 0.0f;
+
+    VkPipelineDepthStencilStateCreateInfo depth_stencil_state_info = {};
+    depth_stencil_state_info.sType =
+        VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depth_stencil_state_info.depthCompareOp = state.depth_compare_op;
+    depth_stencil_state_info.depthTestEnable =
+        state.depth_test ? VK_TRUE : VK_FALSE;
+    depth_stencil_state_info.depthWriteEnable =
+        state.depth_write ? VK_TRUE : VK_FALSE;
+    depth_stencil_state_info.minDepthBounds = 0.0f;
+    depth_stencil_state_info.maxDepthBounds = 1.0f;
+    depth_stencil_state_info.stencilTestEnable = VK_FALSE;
+    depth_stencil_state_info.front = {};
+    depth_stencil_state_info.back = {};
+
+    VkGraphicsPipelineCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+
+    create_info.stageCount = shader_stages.size();
+    create_info.pStages = shader_stages.data();
+    create_info.pVertexInputState = &vertex_input_state_info;
+    create_info.pInputAssemblyState = &input_assembly_info;
+    create_info.pViewportState = &viewport_state_info;
+    create_info.pRasterizationState = &rasterization_state_info;
+    create_info.pMultisampleState = &multisample_state_info;
+    create_info.pDepthStencilState = &depth_stencil_state_info;
+    create_info.pColorBlendState = &color_blend_state_info;
+    create_info.pDynamicState = &dynamic_state_info;
+    create_info.layout = layout;
+    create_info.renderPass = state.render_pass;
+    create_info.subpass = state.subpass;
+    create_info.basePipelineHandle = VK_NULL_HANDLE;
+    create_info.basePipelineIndex = -1;
+
+    auto& cache = logical_device.pipeline_cache();
+    const auto start = std::chrono::steady_clock::now();
+
+    VkPipeline pipeline;
+    if (vkCreateGraphicsPipelines(logical_device.handle(), cache.handle(), 1,
+                                  &create_info, nullptr,
+                                  &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("Could not create graphics pipeline");
+    }
+    cache.record_creation(std::chrono::steady_clock::now() - start);
+
+    return pipeline;
+}
+}  // namespace Vulkan
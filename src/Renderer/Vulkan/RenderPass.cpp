@@ -17,18 +17,17 @@
 
 namespace Vulkan {
 RenderPass::RenderPass(const Vulkan::Swapchain& swapchain)
-    : _swapchain(swapchain) {
-    _depth_image = std::make_unique<DepthImage>(
-        _swapchain, Utils::FindDepthFormat(swapchain.physical_device()));
-    _depth_image_view = _depth_image->create_view(VK_IMAGE_ASPECT_DEPTH_BIT);
-
-    auto temp_buffer = _swapchain.command_pool().allocate_temp_buffer();
-    _depth_image->transition_layout(
-        temp_buffer.handle(), VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-    temp_buffer.flush(_swapchain.device().graphics_queue_handle());
+    : _swapchain(swapchain),
+      _color_format(swapchain.format()),
+      _attachments(swapchain.physical_device(), swapchain.device(),
+                   {"Scene"}),
+      _depth_attachment(_attachments.declare(
+          "Depth", Utils::FindDepthFormat(swapchain.physical_device()),
+          VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, "Scene", "Scene")) {
+    create_depth_image();
 
     VkAttachmentDescription color_attachment = {};
-    color_attachment.format = _swapchain.format();
+    color_attachment.format = _color_format;
     color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
     color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
@@ -94,6 +93,18 @@ RenderPass::RenderPass(const Vulkan::Swapchain& swapchain)
     }
 }
 
+void RenderPass::create_depth_image() {
+    _attachments.create(_swapchain.extent());
+
+    auto temp_buffer = _swapchain.command_pool().allocate_temp_buffer();
+    _attachments.image(_depth_attachment)
+        .transition_layout(temp_buffer.handle(),
+                           VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    temp_buffer.flush(_swapchain.device().graphics_queue_handle());
+}
+
+void RenderPass::resize() { create_depth_image(); }
+
 RenderPass::~RenderPass() {
     vkDestroyRenderPass(_swapchain.device().handle(), _render_pass, nullptr);
 }
@@ -7,12 +7,15 @@
 
 // ----- std -----
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <iostream>  //todo remove
 #include <map>
 #include <set>
+#include <stdexcept>
+#include <string>
 #include <utility>
-#include <thread>
 #include <vector>
 
 // ----- libraries -----
@@ -26,24 +29,141 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <stb/stb_image_write.h>
+
 // ----- in-project dependencies
 #include <Asset/Image.hpp>
+#include <Asset/Texture.hpp>
 #include <Data/Representation.hpp>
+#include <Profiling/Trace.hpp>
 #include <Renderer/Vulkan/Descriptors/DescriptorSet.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorSetLayoutCache.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
+#include <Renderer/Vulkan/Pipelines/BindlessPipeline.hpp>
+#include <Renderer/Vulkan/Pipelines/PipelineCache.hpp>
 #include <Renderer/Vulkan/Pipelines/SingleModelPipeline.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderModuleCache.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderReflection.hpp>
 #include <Renderer/Vulkan/Utils.hpp>
 #include <Window/IWindow.hpp>
 #include <Window/IWindowService.hpp>
 #include <configuration.hpp>
 #include <directories.hpp>
 
+namespace {
+// Whether the bytes of a pixel are stored in BGRA order, throws for the
+// formats a PNG can not be written from directly
+bool IsBgra(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return true;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return false;
+        default:
+            throw std::runtime_error("Captured image is not 8 bit RGBA");
+    }
+}
+
+const glm::vec3 CameraPosition(2.0f, 3.0f, 2.0f);
+const float FieldOfView = glm::radians(45.0f);
+constexpr float NearPlane = 0.1f;
+constexpr float FarPlane = 10.0f;
+
+// Height of the projected bounding sphere, in pixels
+float ProjectedSize(const glm::vec3& camera, const glm::vec3& center,
+                    float radius, float viewport_height) {
+    const auto distance =
+        std::max(glm::distance(camera, center) - radius, NearPlane);
+    return radius / (distance * std::tan(FieldOfView / 2.0f)) *
+           viewport_height;
+}
+
+constexpr bool DynamicObjectData =
+    Configuration::ObjectData == ObjectDataStrategy::DynamicUniformBuffer;
+
+// The descriptor interface shared by the scene shaders. With the dynamic
+// strategy the model matrices live in one buffer bound at different offsets,
+// which reflection can not tell from a plain uniform buffer.
+Vulkan::ShaderInterface SceneInterface(Vulkan::LogicalDevice& logical_device) {
+    auto interface = Vulkan::ShaderInterface::Reflect(
+        logical_device, Vulkan::SingleModelPipeline::ShaderStages());
+    if (DynamicObjectData) {
+        interface.make_dynamic(0, Model_descriptor().binding);
+    }
+    return interface;
+}
+
+// The model entry follows the descriptor the vertex shader declares for it
+std::vector<VkDescriptorUpdateTemplateEntry> SceneUpdateEntries() {
+    const auto entries = SceneDescriptors::update_template_entries();
+    std::vector<VkDescriptorUpdateTemplateEntry> used;
+    for (const auto& entry : entries) {
+        if (entry.dstBinding != Model_descriptor().binding) {
+            used.push_back(entry);
+            continue;
+        }
+
+        switch (Configuration::ObjectData) {
+            case ObjectDataStrategy::PushConstants:
+                break;
+            case ObjectDataStrategy::StorageBuffer:
+                used.push_back(entry);
+                used.back().descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                break;
+            case ObjectDataStrategy::DynamicUniformBuffer:
+            default:
+                used.push_back(entry);
+                break;
+        }
+    }
+    return used;
+}
+
+const SceneDescription& CheckScene(const SceneDescription& scene) {
+    for (const auto texture : scene.drawable_textures) {
+        if (texture >= scene.textures.size()) {
+            throw std::invalid_argument("Drawable texture " +
+                                        std::to_string(texture) +
+                                        " is not in the scene");
+        }
+    }
+    if (scene.alternate_textures &&
+        (scene.alternating_drawable >= scene.drawable_textures.size() ||
+         scene.textures.size() < 2)) {
+        throw std::invalid_argument(
+            "Alternating textures need two textures and drawable " +
+            std::to_string(scene.alternating_drawable));
+    }
+    return scene;
+}
+
+unsigned int CheckFramesInFlight(unsigned int frames_in_flight) {
+    constexpr auto min = Vulkan::Renderer::MinFramesInFlight;
+    constexpr auto max = Vulkan::Renderer::MaxFramesInFlight;
+    if (frames_in_flight < min || frames_in_flight > max) {
+        throw std::invalid_argument("Frames in flight should be between " +
+                                    std::to_string(min) + " and " +
+                                    std::to_string(max));
+    }
+    return frames_in_flight;
+}
+}  // namespace
+
 namespace Vulkan {
 const std::vector<const char*> Renderer::RequiredExtensions = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
 Renderer::Renderer(IWindowService& service,
-                   std::shared_ptr<const IWindow> window)
-    : _asset_manager({"", builtin_texture_dir}),
+                   std::shared_ptr<const IWindow> window,
+                   unsigned int frames_in_flight,
+                   const SceneDescription& scene)
+    : _frames_in_flight(CheckFramesInFlight(frames_in_flight)),
+      _alternate_textures(CheckScene(scene).alternate_textures),
+      _alternating_drawable(scene.alternating_drawable),
+      _camera_position(CameraPosition),
+      _asset_manager({"", builtin_texture_dir}),
       _service(service),
       _window(std::move(window)),
       _instance(_service, "MyCorp", "CorpEngine"),
@@ -51,109 +171,144 @@ Renderer::Renderer(IWindowService& service,
       _physical_device(_instance, _surface),
       _logical_device(_physical_device, _surface),
       _swapchain(_surface, _physical_device, _logical_device),
-      _material_layout(_logical_device, {Texture_sampler_descriptor()}),
-      _uniform_layout(
-          _logical_device,
-          {UniformBufferObject::binding_descriptor(), Model_descriptor()}) {
-    _single_model_pipeline = &_swapchain.attach_pipeline<SingleModelPipeline>(
-        std::vector{_uniform_layout.handle(), _material_layout.handle()});
-
-    if (auto maybe_image = _asset_manager.load_image("chalet.jpg")) {
-        auto& image = maybe_image->get();
-
-        _textures.emplace_back(
-            std::make_unique<Texture2D>(_logical_device, image));
+      _scene_interface(SceneInterface(_logical_device)),
+      _material_layout(_logical_device.descriptor_set_layouts().get(
+          _scene_interface.set_bindings(1))),
+      _uniform_layout(_logical_device.descriptor_set_layouts().get(
+          _scene_interface.set_bindings(0))),
+      _texture_streamer(_logical_device, _frames_in_flight),
+      _defragmenter(_logical_device, _frames_in_flight),
+      _gpu_profiler(
+          _physical_device, _logical_device,
+          *Utils::FindQueueFamilies(_physical_device, _surface).graphics_family,
+          _frames_in_flight) {
+    if (_logical_device.bindless_textures()) {
+        _bindless_textures = std::make_unique<BindlessTextureSet>(
+            _logical_device, _physical_device);
+        const std::vector layouts = {_uniform_layout.handle(),
+                                     _bindless_textures->layout()};
+        _single_model_pipeline =
+            &_swapchain.attach_pipeline<BindlessPipeline>(layouts);
+    } else {
+        const std::vector layouts = {_uniform_layout.handle(),
+                                     _material_layout.handle()};
+        _single_model_pipeline =
+            &_swapchain.attach_pipeline<SingleModelPipeline>(layouts);
+        if (scene.alpha_test) {
+            MaterialSpecialization material;
+            material.alpha_test = VK_TRUE;
+            _scene_pipeline = _swapchain.request_pipeline<SingleModelPipeline>(
+                layouts, _single_model_pipeline, material);
+        }
     }
-    if (auto maybe_image = _asset_manager.load_image("chalet_bw.jpg")) {
-        auto& image = maybe_image->get();
 
-        _textures.emplace_back(
-            std::make_unique<Texture2D>(_logical_device, image));
+    const Memory::TagScope tag("Scene");
+    for (const auto& name : scene.textures) {
+        if (auto maybe_texture =
+                _asset_manager.load_texture(name, texture_format())) {
+            auto& texture = maybe_texture->get();
+
+            _textures.emplace_back(_texture_streamer.create(texture));
+        }
     }
-    if (auto maybe_mesh = _asset_manager.load_mesh("chalet.obj")) {
+    if (auto maybe_mesh = _asset_manager.load_mesh(scene.mesh)) {
         const auto& mesh = maybe_mesh->get();
 
-        auto drawable = &_drawables.emplace_back(_logical_device, mesh);
-        drawable->set_texture(_textures[0].get());
-        _drawables.emplace_back(_logical_device, mesh)
-            .set_texture(_textures[0].get());
-        _drawables.emplace_back(_logical_device, mesh)
-            .set_texture(_textures[1].get());
-        _drawables.emplace_back(_logical_device, mesh)
-            .set_texture(_textures[0].get());
-    }
-
-    std::thread([this]() {
-        int i = 0;
-        while (true) {
-            i = (i + 1) % 2;
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(1s);
-            _drawables[2].set_texture(_textures[i].get());
-            //record_command_buffers(1);
-            // Gotta wait for the current submitted command buffer to finish
-            // presentation, to avoid overwriting it.
-            //vkWaitForFences(_logical_device.handle(), 1,
-            //                &_in_flight[_current_frame], VK_TRUE,
-            //                std::numeric_limits<uint64_t>::max());
-            //_swapchain.command_pool().shift();
+        _drawables.reserve(scene.drawable_textures.size());
+        for (const auto texture : scene.drawable_textures) {
+            _drawables.emplace_back(_logical_device, mesh)
+                .set_texture(_textures.at(texture).get());
         }
-    }).detach();
+    }
+    // Switched at frame boundaries by render(), as long as the assets loaded
+    _alternate_textures = _alternate_textures &&
+                          _drawables.size() > _alternating_drawable &&
+                          _textures.size() > 1;
 
     create_sampler();
     create_desc_pool();
-    create_uniform_buffers();
+    create_frames();
 
-    for (auto& drawable : _drawables) {
-        drawable.consume_uniform_buffer(
-            dynamic_cast<DynamicUniformBuffer&>(*_dynamic_uniform_buffer));
+    if (DynamicObjectData) {
+        // The object buffers of all frames share the same slots
+        for (auto& drawable : _drawables) {
+            drawable.consume_uniform_buffer(dynamic_cast<DynamicUniformBuffer&>(
+                *_frames.front()->object_buffer()));
+        }
     }
 }  // namespace Vulkan
 
 Renderer::~Renderer() {
     shutdown();
 
-    for (auto i = 0ul; i < _image_available.size(); ++i) {
-        vkDestroyFence(_logical_device.handle(), _in_flight.at(i), nullptr);
-        vkDestroySemaphore(_logical_device.handle(), _render_finished.at(i),
-                           nullptr);
-        vkDestroySemaphore(_logical_device.handle(), _image_available.at(i),
-                           nullptr);
-    }
+    // The retired textures release descriptors of the allocator
+    _texture_streamer.release();
+    _defragmenter.release();
+    _frames.clear();
     vkDestroySampler(_logical_device.handle(), _texture_sampler, nullptr);
 }
 
 void Renderer::initialize() {
     stage_drawables();
     stage_textures();
-    write_descriptor_sets();
-    record_command_buffers();
-    create_synchronization_objects();
+
+    // The pipelines are compiled, their modules are only needed again when
+    // the surface format changes, and then the SPIR-V is still in memory
+    _logical_device.shader_modules().trim();
+
+    if (Configuration::ShaderHotReload &&
+        _logical_device.shader_modules().compiles_sources()) {
+        _shader_watcher = std::make_unique<ShaderWatcher>(
+            _logical_device.shader_modules(),
+            std::chrono::milliseconds(Configuration::ShaderWatchInterval));
+    }
 }
 
-void Renderer::stage_textures() {
+Asset::TextureFormat Renderer::texture_format() const {
+    return Configuration::CompressTextures &&
+                   _physical_device.features().textureCompressionBC
+               ? Asset::TextureFormat::BC7
+               : Asset::TextureFormat::R8G8B8A8;
+}
+
+void Renderer::stage_textures(std::size_t first) {
+    TRACE_ZONE("Renderer::stage_textures");
     auto temp_buffer = _swapchain.command_pool().allocate_temp_buffer();
     std::map<Texture2D*, SubBufferDescriptor> stage_desc_map;
     auto stage_buf =
         std::make_unique<PolymorphBuffer<StagingBufferTag>>(_logical_device);
-    for (auto& texture : _textures) {
+    for (auto i = first; i < _textures.size(); ++i) {
+        auto& texture = _textures[i];
         stage_desc_map.emplace(texture.get(), texture->pre_stage(*stage_buf));
     }
 
     stage_buf->allocate();
-
-    for (auto& texture : _textures) {
-        texture->stage(temp_buffer, *stage_buf,
+    _uploaded_size += stage_buf->size();
+
+    _gpu_profiler.begin_immediate(temp_buffer.handle());
+    const auto scope =
+        _gpu_profiler.begin(temp_buffer.handle(), "Upload textures");
+    for (auto i = first; i < _textures.size(); ++i) {
+        auto& texture = _textures[i];
+        texture->stage(temp_buffer.handle(), *stage_buf,
                        stage_desc_map.at(texture.get()));
         texture->transition_layout(temp_buffer.handle(),
                                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
+    _gpu_profiler.end(temp_buffer.handle(), scope);
 
     temp_buffer.flush(_logical_device.graphics_queue_handle());
-
-    for (auto& texture : _textures) {
-        texture->attach_desc_pool(_descriptor_pool.get(), &_material_layout,
-                                  _texture_sampler);
+    _gpu_profiler.end_immediate();
+
+    for (auto i = first; i < _textures.size(); ++i) {
+        auto& texture = _textures[i];
+        if (_bindless_textures) {
+            texture->attach_bindless(_bindless_textures.get(),
+                                     _texture_sampler);
+        } else {
+            texture->attach_descriptors(_descriptor_allocator.get(),
+                                        &_material_layout, _texture_sampler);
+        }
     }
 }
 
@@ -177,7 +332,7 @@ void Renderer::create_sampler() {
     create_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     create_info.mipLodBias = 0.0f;
     create_info.minLod = 0.0f;
-    create_info.maxLod = 0.0f;
+    create_info.maxLod = VK_LOD_CLAMP_NONE;
 
     if (vkCreateSampler(_logical_device.handle(), &create_info, nullptr,
                         &_texture_sampler) != VK_SUCCESS) {
@@ -185,63 +340,193 @@ void Renderer::create_sampler() {
     }
 }
 
-void Renderer::record_command_buffers(unsigned int batch) {
-    for (auto i = 0ul; i < _swapchain.framebuffers().size(); ++i) {
-        const auto& command_buffer = _swapchain.command_pool().buffer(i, batch);
-        const auto& framebuffer = _swapchain.framebuffers().at(i);
-
-        VkCommandBufferBeginInfo begin_info = {};
-        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        begin_info.flags = 0;
-        begin_info.pInheritanceInfo = nullptr;
-
-        if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
-            throw std::runtime_error(
-                "Failed to begin command buffer recording");
+void Renderer::record_command_buffer(FrameContext& frame,
+                                     unsigned int image_index) {
+    TRACE_ZONE("Renderer::record_command_buffer");
+    const auto command_buffer = frame.begin();
+    const auto& framebuffer = _swapchain.framebuffers().at(image_index);
+    const auto scene_set = frame.scene_set().handle();
+
+    VkRenderPassBeginInfo render_pass_begin_info = {};
+    render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_begin_info.renderPass = _swapchain.render_pass().handle();
+    render_pass_begin_info.framebuffer = framebuffer.handle();
+    render_pass_begin_info.renderArea.offset = {0, 0};
+    render_pass_begin_info.renderArea.extent = _swapchain.extent();
+
+    std::array<VkClearValue, 2> clear_values;
+    clear_values[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    clear_values[1].depthStencil = {1.0f, 0};
+    render_pass_begin_info.clearValueCount = clear_values.size();
+    render_pass_begin_info.pClearValues = clear_values.data();
+
+    // The frame was waited for, its results from last time are ready
+    _gpu_profiler.begin_frame(command_buffer, _current_frame);
+    _texture_streamer.record(command_buffer, &_gpu_profiler);
+    _defragmenter.record(command_buffer, &_gpu_profiler);
+    const auto scene_pass = _gpu_profiler.begin(command_buffer, "Scene pass");
+    vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info,
+                         VK_SUBPASS_CONTENTS_INLINE);
+    // The layouts of the variant and the fallback are compatible, the sets
+    // are bound with either
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                      _scene_pipeline ? _scene_pipeline->handle()
+                                      : _single_model_pipeline->handle());
+
+    VkViewport viewport = {};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(_swapchain.extent().width);
+    viewport.height = static_cast<float>(_swapchain.extent().height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+
+    VkRect2D scissor = {};
+    scissor.offset = {0, 0};
+    scissor.extent = _swapchain.extent();
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+    if (_bindless_textures) {
+        // Stays bound for the whole pass, draws only push their index
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                _single_model_pipeline->pipeline_layout(), 1,
+                                1, &_bindless_textures->handle(), 0, nullptr);
+    }
+    if (!DynamicObjectData) {
+        // Without dynamic offsets the scene set is the same for all draws
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                _single_model_pipeline->pipeline_layout(), 0,
+                                1, &scene_set, 0, nullptr);
+    }
+    for (auto j = 0u; j < _drawables.size(); ++j) {
+        auto& drawable = _drawables[j];
+        if (Configuration::ObjectData == ObjectDataStrategy::PushConstants) {
+            const auto model = drawable.world_matrix();
+            vkCmdPushConstants(command_buffer,
+                               _single_model_pipeline->pipeline_layout(),
+                               VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(model),
+                               &model);
         }
-
-        VkRenderPassBeginInfo render_pass_begin_info = {};
-        render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        render_pass_begin_info.renderPass = _swapchain.render_pass().handle();
-        render_pass_begin_info.framebuffer = framebuffer.handle();
-        render_pass_begin_info.renderArea.offset = {0, 0};
-        render_pass_begin_info.renderArea.extent = _swapchain.extent();
-
-        std::array<VkClearValue, 2> clear_values;
-        clear_values[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-        clear_values[1].depthStencil = {1.0f, 0};
-        render_pass_begin_info.clearValueCount = clear_values.size();
-        render_pass_begin_info.pClearValues = clear_values.data();
-
-        vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info,
-                             VK_SUBPASS_CONTENTS_INLINE);
-        for (auto j = 0u; j < _drawables.size(); ++j) {
+        uint32_t offset = drawable.uniform_buffer_desc().offset;
+        if (_bindless_textures) {
+            const MaterialPushConstants material = {
+                drawable.texture()->bindless_index()};
+            vkCmdPushConstants(command_buffer,
+                               _single_model_pipeline->pipeline_layout(),
+                               VK_SHADER_STAGE_FRAGMENT_BIT,
+                               MaterialPushConstants::Offset,
+                               sizeof(material), &material);
+            if (DynamicObjectData) {
+                vkCmdBindDescriptorSets(
+                    command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    _single_model_pipeline->pipeline_layout(), 0, 1,
+                    &scene_set, 1, &offset);
+            }
+        } else if (DynamicObjectData) {
             std::vector<VkDescriptorSet> descs = {
-                _descriptor_set->handle(),
-                _drawables[j].texture()->desc_handle()};
-
-            auto& drawable = _drawables[j];
-            //            vkCmdPushConstants(command_buffer,
-            //                               _single_model_pipeline->pipeline_layout(),
-            //                               VK_SHADER_STAGE_VERTEX_BIT, 0,
-            //                               sizeof(glm::mat4), (const
-            //                               void*)&drawable.model_matrix());
-            uint32_t offset = drawable.uniform_buffer_desc().offset;
-            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                              _single_model_pipeline->handle());
-            vkCmdBindDescriptorSets(command_buffer,
-                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                    _single_model_pipeline->pipeline_layout(),
-                                    0, descs.size(), descs.data(), 1, &offset);
-            drawable.draw(command_buffer);
+                scene_set, drawable.texture()->desc_handle()};
+            vkCmdBindDescriptorSets(
+                command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                _single_model_pipeline->pipeline_layout(), 0, descs.size(),
+                descs.data(), 1, &offset);
+        } else {
+            const auto material = drawable.texture()->desc_handle();
+            vkCmdBindDescriptorSets(
+                command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                _single_model_pipeline->pipeline_layout(), 1, 1, &material, 0,
+                nullptr);
         }
-        vkCmdEndRenderPass(command_buffer);
-        if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
-            throw std::runtime_error("Failed to record the command buffer");
+        // Indexes the storage buffer, the other shaders ignore it
+        drawable.draw(command_buffer, j);
+    }
+    vkCmdEndRenderPass(command_buffer);
+    _gpu_profiler.end(command_buffer, scene_pass);
+    if (!_capture_path.empty()) {
+        const auto capture = _gpu_profiler.begin(command_buffer, "Capture");
+        record_capture(command_buffer, image_index);
+        _gpu_profiler.end(command_buffer, capture);
+    }
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record the command buffer");
+    }
+}
+void Renderer::record_capture(VkCommandBuffer command_buffer,
+                              unsigned int image_index) {
+    const auto extent = _swapchain.extent();
+    const VkDeviceSize size = extent.width * extent.height * 4;
+    // No capture is in flight, the previous one was waited for
+    if (!_capture_buffer || _capture_buffer->size() != size) {
+        const Memory::TagScope tag("Capture");
+        _capture_buffer = std::make_unique<Buffer>(
+            _logical_device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_SHARING_MODE_EXCLUSIVE,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+    const auto image = _swapchain.images().at(image_index).handle();
+
+    // The render pass leaves the image ready for presentation
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, 1, &barrier);
+
+    VkBufferImageCopy region = {};
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageExtent = {extent.width, extent.height, 1};
+    vkCmdCopyImageToBuffer(command_buffer, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           _capture_buffer->handle(), 1, &region);
+
+    // Back to presentation, and the copy made visible to the host
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkMemoryBarrier host_barrier = {};
+    host_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    host_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    host_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(
+        command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0,
+        1, &host_barrier, 0, nullptr, 1, &barrier);
+}
+
+void Renderer::write_capture(const FrameContext& frame) {
+    frame.wait();
+
+    const auto extent = _swapchain.extent();
+    std::vector<unsigned char> pixels(_capture_buffer->size());
+    _capture_buffer->read(pixels.data(), pixels.size());
+    if (IsBgra(_swapchain.format())) {
+        for (auto i = 0u; i < pixels.size(); i += 4) {
+            std::swap(pixels[i], pixels[i + 2]);
         }
     }
+
+    const auto path = std::move(_capture_path);
+    _capture_path.clear();
+    if (!stbi_write_png(path.c_str(), extent.width, extent.height, 4,
+                        pixels.data(), extent.width * 4)) {
+        throw std::runtime_error("Could not write capture to " + path);
+    }
 }
+
 void Renderer::stage_drawables() {
+    TRACE_ZONE("Renderer::stage_drawables");
     auto temp_buffer = _swapchain.command_pool().allocate_temp_buffer();
     std::map<Drawable*, Drawable::StageDesc> stage_desc_map;
     auto stage_buf =
@@ -251,111 +536,189 @@ void Renderer::stage_drawables() {
     }
 
     stage_buf->allocate();
+    _uploaded_size += stage_buf->size();
 
+    _gpu_profiler.begin_immediate(temp_buffer.handle());
+    const auto scope =
+        _gpu_profiler.begin(temp_buffer.handle(), "Upload drawables");
     for (auto& drawable : _drawables) {
         drawable.stage(temp_buffer, *stage_buf, stage_desc_map.at(&drawable));
     }
+    _gpu_profiler.end(temp_buffer.handle(), scope);
 
     temp_buffer.flush(_logical_device.graphics_queue_handle());
+    _gpu_profiler.end_immediate();
 }
 
-void Renderer::create_synchronization_objects() {
-    _image_available.resize(MaxFramesInFlight);
-    _render_finished.resize(MaxFramesInFlight);
-    _in_flight.resize(MaxFramesInFlight);
-
-    VkSemaphoreCreateInfo semaphore_info = {};
-    semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    VkFenceCreateInfo fence_info = {};
-    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    for (auto i = 0ul; i < _image_available.size(); ++i) {
-        auto& image_available = _image_available.at(i);
-        auto& render_finished = _render_finished.at(i);
-        auto& in_flight = _in_flight.at(i);
-
-        if (vkCreateSemaphore(_logical_device.handle(), &semaphore_info,
-                              nullptr, &image_available) != VK_SUCCESS ||
-            vkCreateSemaphore(_logical_device.handle(), &semaphore_info,
-                              nullptr, &render_finished) != VK_SUCCESS ||
-            vkCreateFence(_logical_device.handle(), &fence_info, nullptr,
-                          &in_flight) != VK_SUCCESS) {
-            throw std::runtime_error(
-                "Failed to create synchronization objects for a frame");
+void Renderer::create_desc_pool() {
+    // Most sets are materials, every pool chained later grows, so nothing has
+    // to be known about the scene up front
+    constexpr auto sets = Configuration::DescriptorSetsPerPool;
+    _descriptor_allocator = std::make_unique<DescriptorAllocator>(
+        _logical_device,
+        DescriptorAllocator::PoolSizes{
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, sets / 4},
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, sets / 4},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sets / 4},
+            {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sets}},
+        sets, _frames_in_flight);
+
+    _scene_update_template = std::make_unique<DescriptorUpdateTemplate>(
+        _logical_device, _uniform_layout, SceneUpdateEntries());
+}
+
+void Renderer::create_frames() {
+    const Memory::TagScope tag("Frame resources");
+    _frames.reserve(_frames_in_flight);
+    for (auto i = 0u; i < _frames_in_flight; ++i) {
+        auto uniform_buffer = std::make_unique<UniformBuffer>(
+            _logical_device, sizeof(UniformBufferObject));
+
+        std::unique_ptr<Buffer> object_buffer;
+        switch (Configuration::ObjectData) {
+            case ObjectDataStrategy::PushConstants:
+                break;
+            case ObjectDataStrategy::StorageBuffer:
+                object_buffer = std::make_unique<StorageBuffer>(
+                    _logical_device, sizeof(glm::mat4) * _drawables.size());
+                break;
+            case ObjectDataStrategy::DynamicUniformBuffer:
+            default:
+                object_buffer = std::make_unique<DynamicUniformBuffer>(
+                    _physical_device, _logical_device, sizeof(glm::mat4),
+                    _drawables.size());
+                break;
         }
+
+        _frames.emplace_back(std::make_unique<FrameContext>(
+            _logical_device, _swapchain, std::move(uniform_buffer),
+            std::move(object_buffer)));
     }
 }
 
-void Renderer::create_desc_pool() {
-    _descriptor_pool = std::make_unique<DescriptorPool>(
-        _logical_device,
-        std::vector{std::pair{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                              // Scene + one for each drawable
-                              1ul},
-                    std::pair{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
-                              // Scene + one for each drawable
-                              1ul},
-                    std::pair{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                              _textures.size()}},
-        2ul + _textures.size());
-
-    _descriptor_set = _descriptor_pool->allocate_set(_uniform_layout.handle());
-}
-
-void Renderer::create_uniform_buffers() {
-    _uniform_buffer = std::make_unique<UniformBuffer>(
-        _logical_device, sizeof(UniformBufferObject));
-
-    _dynamic_uniform_buffer = std::make_unique<DynamicUniformBuffer>(
-        _physical_device, _logical_device, sizeof(glm::mat4),
-        _drawables.size());
-    //    _uniform_buffers.reserve(_drawables.size());
-    //    for (const auto& mesh [[maybe_unused]] : _drawables) {
-    //        _uniform_buffers.emplace_back(std::make_unique<UniformBuffer>(
-    //            _logical_device, sizeof(UniformBufferObject)));
-    //    }
-}
-
-void Renderer::write_descriptor_sets() {
-    _descriptor_set->write(UniformBufferObject::binding_descriptor(), 0,
-                           *_uniform_buffer);
-    _descriptor_set->write(
-        Model_descriptor(), 0, *_dynamic_uniform_buffer,
-        {VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(glm::mat4), 0});
-    _descriptor_set->update();
-}
-
-void Renderer::update_uniform_buffer(uint64_t delta_time [[maybe_unused]]) {
-    UniformBufferObject ubo = {};
-    auto camPos =
-        glm::vec3(2.0f, 3.0f, /*(sin(delta_time / 1000.f) + 1)*/ 2.0f);
+void Renderer::write_scene_set(FrameContext& frame) {
+    SceneDescriptors descriptors = {};
+    descriptors.camera.buffer = frame.uniform_buffer().handle();
+    descriptors.camera.offset = 0;
+    descriptors.camera.range = frame.uniform_buffer().size();
+    if (const auto* object_buffer = frame.object_buffer()) {
+        descriptors.model.buffer = object_buffer->handle();
+        descriptors.model.offset = 0;
+        descriptors.model.range =
+            DynamicObjectData ? sizeof(glm::mat4) : object_buffer->size();
+    }
 
-    ubo.view = glm::lookAt(camPos, glm::vec3(0.0f, 0.0f, 0.0f),
+    auto* scene_set =
+        _descriptor_allocator->allocate_transient(_uniform_layout.handle());
+    _scene_update_template->update(*scene_set, descriptors);
+    frame.set_scene_set(scene_set);
+}
+
+void Renderer::update_uniform_buffer(FrameContext& frame,
+                                     uint64_t delta_time [[maybe_unused]]) {
+    UniformBufferObject ubo = {};
+    ubo.view = glm::lookAt(_camera_position, _camera_target,
                            glm::vec3(0.0f, 0.0f, 1.0f));
 
     ubo.proj =
-        glm::perspective(glm::radians(45.0f),
+        glm::perspective(FieldOfView,
                          _swapchain.extent().width /
                              static_cast<float>(_swapchain.extent().height),
-                         0.1f, 10.0f);
+                         NearPlane, FarPlane);
     ubo.proj[1][1] *= -1;  // invert Y of clip coordinate
 
-    _uniform_buffer->transfer((void*)(&ubo), sizeof(ubo));
+    frame.uniform_buffer().transfer((void*)(&ubo), sizeof(ubo));
+}
+
+void Renderer::update_object_data(FrameContext& frame, uint64_t delta_time) {
+    switch (Configuration::ObjectData) {
+        case ObjectDataStrategy::PushConstants:
+            // Pushed while the command buffer of the frame is recorded
+            for (auto& drawable : _drawables) {
+                drawable.update(delta_time);
+            }
+            break;
+        case ObjectDataStrategy::StorageBuffer: {
+            std::vector<glm::mat4> models;
+            models.reserve(_drawables.size());
+            for (auto& drawable : _drawables) {
+                drawable.update(delta_time);
+                models.push_back(drawable.world_matrix());
+            }
+            frame.object_buffer()->transfer(models.data(),
+                                            models.size() * sizeof(glm::mat4));
+            break;
+        }
+        case ObjectDataStrategy::DynamicUniformBuffer:
+        default:
+            for (auto& drawable : _drawables) {
+                drawable.update(*frame.object_buffer(), delta_time);
+            }
+            break;
+    }
 }
 
 void Renderer::recreate_swap_chain() {
     vkDeviceWaitIdle(_logical_device.handle());
 
+    // Only the size dependent images and framebuffers are replaced, the
+    // pipelines, uniform buffers and descriptor sets stay valid
     _swapchain.recreate();
+}
+
+void Renderer::set_present_policy(PresentPolicy policy) {
+    if (policy == _swapchain.present_policy()) {
+        return;
+    }
+
+    _swapchain.set_present_policy(policy);
+    recreate_swap_chain();
+}
+
+void Renderer::report_texture_usage() {
+    const auto viewport_height = static_cast<float>(_swapchain.extent().height);
+    for (const auto& drawable : _drawables) {
+        _texture_streamer.report_usage(
+            *drawable.texture(),
+            ProjectedSize(_camera_position, drawable.position(),
+                          drawable.mesh().bounding_radius(), viewport_height));
+    }
+}
+
+void Renderer::stream_textures() {
+    TRACE_ZONE("Renderer::stream_textures");
+    // Only the current frame was waited for. The planned levels are
+    // uploaded by its command buffer, and swapped in when it comes around
+    // again, the textures get new descriptors instead of rewriting the ones
+    // the other frames in flight use.
+    if (_texture_streamer.begin_frame(_current_frame)) {
+        Profiling::Counter(
+            "Resident texture bytes",
+            static_cast<double>(_texture_streamer.resident_size()));
+    }
+    _texture_streamer.end_frame();
+}
 
-    //    _uniform_buffers.clear();
-    _uniform_buffer.reset();
+void Renderer::defragment() {
+    TRACE_ZONE("Renderer::defragment");
+    // Only the current frame was waited for. The planned resources are
+    // copied by its command buffer, the other frames in flight keep using
+    // the previous storage until this frame comes around again.
+    _defragmenter.begin_frame(_current_frame);
+    _defragmenter.plan(_textures, _drawables);
+}
 
-    create_uniform_buffers();
-    write_descriptor_sets();
+void Renderer::reload_shaders() {
+    const auto file_names = _logical_device.shader_modules().apply_reloads();
+    if (file_names.empty()) {
+        return;
+    }
+
+    // The frames in flight reference the replaced pipelines
+    vkDeviceWaitIdle(_logical_device.handle());
+    _swapchain.reload_shaders(file_names);
 
-    record_command_buffers();
+    _logical_device.shader_modules().trim();
 }
 
 void Renderer::resized(int width [[maybe_unused]],
@@ -363,14 +726,55 @@ void Renderer::resized(int width [[maybe_unused]],
     _framebuffer_resized = true;
 }
 
+void Renderer::capture(std::string path) {
+    if (!(_swapchain.image_usage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+        throw std::runtime_error("Swapchain images can not be read back");
+    }
+    // Fails early instead of after the frame is rendered
+    IsBgra(_swapchain.format());
+
+    _capture_path = std::move(path);
+}
+
+void Renderer::set_camera(const glm::vec3& position,
+                          const glm::vec3& target) {
+    _camera_position = position;
+    _camera_target = target;
+}
+
+unsigned int Renderer::load_texture(const std::string& name) {
+    const Memory::TagScope tag("Loaded textures");
+    auto maybe_texture = _asset_manager.load_texture(name, texture_format());
+    if (!maybe_texture) {
+        throw std::runtime_error("Could not load texture " + name);
+    }
+
+    _textures.emplace_back(_texture_streamer.create(maybe_texture->get()));
+    stage_textures(_textures.size() - 1);
+    return _textures.size() - 1;
+}
+
+void Renderer::set_texture(unsigned int drawable, unsigned int texture) {
+    _drawables.at(drawable).set_texture(_textures.at(texture).get());
+}
+
+void Renderer::wait_for_frame() { _frames.at(_current_frame)->wait(); }
+
 void Renderer::render(uint64_t delta_time) {
-    auto& image_available = _image_available.at(_current_frame);
-    auto& render_finished = _render_finished.at(_current_frame);
-    auto& in_flight = _in_flight.at(_current_frame);
+    TRACE_ZONE("Renderer::render");
+    auto& frame = *_frames.at(_current_frame);
+    const auto image_available = frame.image_available();
+    const auto render_finished = frame.render_finished();
+
+    // Wait until the device is done with the resources of the frame, returns
+    // immediately after wait_for_frame
+    frame.wait();
+    _descriptor_allocator->begin_frame(_current_frame);
+    write_scene_set(frame);
+    stream_textures();
+    defragment();
+    reload_shaders();
 
-    // Wait until the current frame is actually submitted
-    vkWaitForFences(_logical_device.handle(), 1, &in_flight, VK_TRUE,
-                    std::numeric_limits<uint64_t>::max());
     auto image_index = 0u;
 
     // start acquiring next image
@@ -383,10 +787,17 @@ void Renderer::render(uint64_t delta_time) {
     }
     //    std::cout << "Image acquired " << image_index << std::endl;
 
-    update_uniform_buffer(delta_time);
-    for (auto& drawable : _drawables) {
-        drawable.update(*_dynamic_uniform_buffer, delta_time);
+    if (_alternate_textures) {
+        const auto texture = (delta_time / 1000 + 1) % 2;
+        _drawables[_alternating_drawable].set_texture(
+            _textures[texture].get());
     }
+    update_uniform_buffer(frame, delta_time);
+    update_object_data(frame, delta_time);
+    report_texture_usage();
+
+    // Unsignals the fence of the frame, so only after the image is acquired
+    record_command_buffer(frame, image_index);
 
     VkSubmitInfo submit_info = {};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -398,29 +809,43 @@ void Renderer::render(uint64_t delta_time) {
     submit_info.waitSemaphoreCount = 1;
     submit_info.pWaitSemaphores = wait_semaphores;
     submit_info.pWaitDstStageMask = wait_stages;
+    const auto command_buffer = frame.command_buffer();
     submit_info.commandBufferCount = 1;
-    submit_info.pCommandBuffers =
-        &_swapchain.command_pool().buffer(image_index);
+    submit_info.pCommandBuffers = &command_buffer;
 
     VkSemaphore signal_semaphores[] = {render_finished};
     submit_info.signalSemaphoreCount = 1;
     submit_info.pSignalSemaphores = signal_semaphores;
 
-    vkResetFences(_logical_device.handle(), 1, &in_flight);
-    if (vkQueueSubmit(_logical_device.graphics_queue_handle(), 1, &submit_info,
-                      in_flight) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to submit draw command to buffer");
+    {
+        TRACE_ZONE("vkQueueSubmit");
+        if (vkQueueSubmit(_logical_device.graphics_queue_handle(), 1,
+                          &submit_info, frame.in_flight()) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to submit draw command to buffer");
+        }
+    }
+    _last_submit = std::chrono::steady_clock::now();
+
+    if (!_capture_path.empty()) {
+        write_capture(frame);
     }
 
     if (auto result = _swapchain.present(image_index, render_finished);
-        result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR) {
+        result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR ||
+        _framebuffer_resized) {
+        // Surfaces without a fixed extent do not report the resize
+        _framebuffer_resized = false;
         recreate_swap_chain();
     } else if (result != VK_SUCCESS) {
         throw std::runtime_error("Failed to present swap chain image");
     }
 
-    _current_frame = (_current_frame + 1) % MaxFramesInFlight;
+    _current_frame = (_current_frame + 1) % _frames_in_flight;
 }
 
-void Renderer::shutdown() { vkDeviceWaitIdle(_logical_device.handle()); }
+void Renderer::shutdown() {
+    _shader_watcher.reset();
+    vkDeviceWaitIdle(_logical_device.handle());
+    _logical_device.pipeline_cache().save();
+}
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+//
+// Created by Dániel Molnár on 2019-11-01.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Shaders/ShaderCompiler.hpp>
+
+// ----- std -----
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/File.hpp>
+#include <Data/Hash.hpp>
+
+namespace {
+std::string ReadText(const std::filesystem::path& path) {
+    std::ifstream stream(path);
+    std::ostringstream text;
+    text << stream.rdbuf();
+    return text.str();
+}
+
+std::string Quoted(const std::filesystem::path& path) {
+    std::ostringstream quoted;
+    quoted << std::quoted(path.string());
+    return quoted.str();
+}
+}  // namespace
+
+namespace Vulkan {
+ShaderCompiler::ShaderCompiler(std::filesystem::path compiler,
+                               std::filesystem::path cache_directory)
+    : _compiler(std::move(compiler)),
+      _cache_directory(std::move(cache_directory)) {}
+
+bool ShaderCompiler::available() const {
+    std::error_code error;
+    return !_compiler.empty() && std::filesystem::exists(_compiler, error);
+}
+
+Core::BinaryFile::ByteSequence ShaderCompiler::compile(
+    const std::filesystem::path& source) const {
+    auto text = File::Read(source);
+    if (!text) {
+        throw std::runtime_error("Shader source " + source.string() +
+                                 " could not be read");
+    }
+
+    // glslc derives the stage from the extension, and a new compiler may
+    // generate different code
+    const auto extension = source.extension().string();
+    auto key = Hash::FNV1a(text->data(), text->size());
+    key = Hash::Combine(key, Hash::FNV1a(extension.data(), extension.size()));
+    key = Hash::Combine(key, Hash::FNV1a(_compiler.string().data(),
+                                         _compiler.string().size()));
+
+    std::ostringstream cache_name;
+    cache_name << source.stem().string() << extension << '-' << std::hex
+               << std::setw(16) << std::setfill('0') << key << ".spv";
+    const auto cache_path = _cache_directory / cache_name.str();
+
+    if (auto cached = File::Read(cache_path); cached && !cached->empty()) {
+        return std::move(*cached);
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(_cache_directory, error);
+    if (error) {
+        throw std::runtime_error("Could not create shader cache directory " +
+                                 _cache_directory.string());
+    }
+
+    // A failed compilation leaves nothing behind in the cache
+    const auto temporary = File::Temporary(cache_path);
+    auto log = temporary;
+    log += ".log";
+
+    const auto command = Quoted(_compiler) + " " + Quoted(source) + " -o " +
+                         Quoted(temporary) + " 2> " + Quoted(log);
+    const auto status = std::system(command.c_str());
+    const auto output = ReadText(log);
+    std::filesystem::remove(log, error);
+
+    auto code = File::Read(temporary);
+    if (status != 0 || !code || code->empty()) {
+        std::filesystem::remove(temporary, error);
+        throw std::runtime_error("Could not compile " + source.string() +
+                                 ":\n" + output);
+    }
+
+    std::filesystem::rename(temporary, cache_path, error);
+    return std::move(*code);
+}
+
+std::string ShaderCompiler::SourceName(const std::string& spirv_file_name) {
+    const auto stem = std::filesystem::path(spirv_file_name).stem().string();
+    const auto separator = stem.rfind('_');
+    if (separator == std::string::npos) {
+        return stem;
+    }
+    return stem.substr(0, separator) + "." + stem.substr(separator + 1);
+}
+}  // namespace Vulkan
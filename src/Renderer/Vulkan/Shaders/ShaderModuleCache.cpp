@@ -0,0 +1,251 @@
+//
+// Created by Dániel Molnár on 2019-10-29.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Shaders/ShaderModuleCache.hpp>
+
+// ----- std -----
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/Hash.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderCompiler.hpp>
+#include <configuration.hpp>
+#include <directories.hpp>
+
+namespace {
+VkShaderModule CreateShaderModule(const Vulkan::LogicalDevice& logical_device,
+                                  const Core::BinaryFile::ByteSequence& code) {
+    VkShaderModuleCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    create_info.codeSize = code.size();
+    create_info.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule module;
+    if (vkCreateShaderModule(logical_device.handle(), &create_info, nullptr,
+                             &module) != VK_SUCCESS) {
+        throw std::runtime_error("Could not create shader module");
+    }
+
+    return module;
+}
+}  // namespace
+
+namespace Vulkan {
+ShaderModuleCache::ShaderModuleCache(const LogicalDevice& logical_device)
+    : _logical_device(logical_device),
+      _file_manager({std::filesystem::current_path(), builtin_shader_dir}) {
+    if constexpr (Configuration::CompileShadersAtRuntime) {
+        auto compiler = std::make_unique<ShaderCompiler>(
+            glsl_compiler, Configuration::ShaderCacheDirectory);
+        if (compiler->available() &&
+            std::filesystem::is_directory(shader_source_dir)) {
+            _compiler = std::move(compiler);
+        }
+    }
+}
+
+ShaderModuleCache::~ShaderModuleCache() {
+    for (const auto& [hash, module] : _modules) {
+        vkDestroyShaderModule(_logical_device.handle(), module.module, nullptr);
+    }
+}
+
+std::filesystem::path ShaderModuleCache::source_of(
+    const std::string& file_name) const {
+    if (_compiler == nullptr) {
+        return {};
+    }
+
+    std::error_code error;
+    auto source = std::filesystem::path(shader_source_dir) /
+                  ShaderCompiler::SourceName(file_name);
+    return std::filesystem::exists(source, error) ? source
+                                                  : std::filesystem::path();
+}
+
+ShaderModuleCache::File ShaderModuleCache::load(
+    const std::string& file_name) const {
+    if (auto source = source_of(file_name); !source.empty()) {
+        const auto source_time = std::filesystem::last_write_time(source);
+        auto code = _compiler->compile(source);
+        const auto hash = Hash::FNV1a(code.data(), code.size());
+        return {hash, std::move(code), std::move(source), source_time};
+    }
+
+    auto shader_file = _file_manager.binary_file(file_name);
+    if (!shader_file) {
+        throw std::runtime_error("Shader " + file_name + " not found");
+    }
+    auto code = shader_file->read();
+    if (!code) {
+        throw std::runtime_error("Shader file " +
+                                 shader_file->path().string() +
+                                 " could not be read");
+    }
+    const auto hash = Hash::FNV1a(code->data(), code->size());
+    return {hash, std::move(*code), {}, {}};
+}
+
+const ShaderModuleCache::File& ShaderModuleCache::file(
+    const std::string& file_name, std::unique_lock<std::mutex>& lock) {
+    if (auto it = _files.find(file_name); it != _files.end()) {
+        return it->second;
+    }
+
+    // Compiling takes long, the other files are served meanwhile. Threads
+    // asking for the same file may both load it, the first one is kept.
+    lock.unlock();
+    const auto start = std::chrono::steady_clock::now();
+    auto loaded = load(file_name);
+    const auto load_time = std::chrono::steady_clock::now() - start;
+    lock.lock();
+
+    _statistics.load_time += load_time;
+    if (loaded.source.empty()) {
+        ++_statistics.files_loaded;
+    } else {
+        ++_statistics.files_compiled;
+    }
+    return _files.emplace(file_name, std::move(loaded)).first->second;
+}
+
+VkShaderModule ShaderModuleCache::acquire(const std::string& file_name) {
+    std::unique_lock lock(_guard);
+
+    const auto& shader = file(file_name, lock);
+    if (auto it = _modules.find(shader.hash); it != _modules.end()) {
+        ++it->second.references;
+        ++_statistics.hits;
+        return it->second.module;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto module = CreateShaderModule(_logical_device, shader.code);
+    _statistics.compile_time += std::chrono::steady_clock::now() - start;
+    ++_statistics.modules_created;
+
+    _modules.emplace(shader.hash, Module{module, 1});
+    _hashes.emplace(module, shader.hash);
+    return module;
+}
+
+void ShaderModuleCache::release(VkShaderModule module) {
+    std::unique_lock lock(_guard);
+
+    auto it = _hashes.find(module);
+    if (it == _hashes.end()) {
+        throw std::invalid_argument("Shader module is not cached");
+    }
+    --_modules.at(it->second).references;
+}
+
+Core::BinaryFile::ByteSequence ShaderModuleCache::code(
+    const std::string& file_name) {
+    std::unique_lock lock(_guard);
+    return file(file_name, lock).code;
+}
+
+void ShaderModuleCache::recompile_changed() {
+    struct Change {
+        std::string file_name;
+        std::filesystem::path source;
+        std::filesystem::file_time_type source_time;
+    };
+
+    std::vector<Change> changes;
+    {
+        std::unique_lock lock(_guard);
+        for (const auto& [file_name, file] : _files) {
+            if (file.source.empty()) {
+                continue;
+            }
+
+            // A pending reload is compared to, so a file is compiled once
+            // per edit, even before the reload is applied
+            const auto pending = _reloaded.find(file_name);
+            const auto& current =
+                pending != _reloaded.end() ? pending->second : file;
+
+            std::error_code error;
+            const auto time =
+                std::filesystem::last_write_time(file.source, error);
+            if (!error && time != current.source_time) {
+                changes.push_back({file_name, file.source, time});
+            }
+        }
+    }
+
+    // Compiling takes long, acquires go on meanwhile
+    for (auto& change : changes) {
+        File reloaded;
+        reloaded.source = change.source;
+        reloaded.source_time = change.source_time;
+        try {
+            reloaded.code = _compiler->compile(change.source);
+            reloaded.hash =
+                Hash::FNV1a(reloaded.code.data(), reloaded.code.size());
+        } catch (const std::runtime_error& error) {
+            std::cerr << error.what() << std::endl;
+
+            // Keeps the previous code, and waits for the next edit
+            std::unique_lock lock(_guard);
+            auto& current = _reloaded.count(change.file_name) > 0
+                                ? _reloaded.at(change.file_name)
+                                : _files.at(change.file_name);
+            current.source_time = change.source_time;
+            continue;
+        }
+
+        std::unique_lock lock(_guard);
+        _reloaded[change.file_name] = std::move(reloaded);
+    }
+}
+
+std::vector<std::string> ShaderModuleCache::apply_reloads() {
+    std::unique_lock lock(_guard);
+
+    std::vector<std::string> file_names;
+    for (auto& [file_name, reloaded] : _reloaded) {
+        auto& file = _files.at(file_name);
+        if (file.hash == reloaded.hash) {
+            file.source_time = reloaded.source_time;  // only touched
+            continue;
+        }
+
+        file = std::move(reloaded);
+        file_names.push_back(file_name);
+        ++_statistics.files_reloaded;
+    }
+    _reloaded.clear();
+
+    return file_names;
+}
+
+void ShaderModuleCache::trim() {
+    std::unique_lock lock(_guard);
+
+    for (auto it = _modules.begin(); it != _modules.end();) {
+        if (it->second.references > 0) {
+            ++it;
+            continue;
+        }
+        vkDestroyShaderModule(_logical_device.handle(), it->second.module,
+                              nullptr);
+        _hashes.erase(it->second.module);
+        it = _modules.erase(it);
+    }
+}
+
+ShaderModuleCache::Statistics ShaderModuleCache::statistics() const {
+    std::unique_lock lock(_guard);
+    return _statistics;
+}
+}  // namespace Vulkan
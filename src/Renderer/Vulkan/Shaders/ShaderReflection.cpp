@@ -0,0 +1,522 @@
+//
+// Created by Dániel Molnár on 2019-10-30.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Shaders/ShaderReflection.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderModuleCache.hpp>
+
+namespace {
+constexpr const std::uint32_t SpirvMagic = 0x07230203;
+constexpr const size_t SpirvHeaderWords = 5;
+
+// The subset of the SPIR-V specification the reflection needs
+enum Op : std::uint32_t {
+    OpEntryPoint = 15,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72,
+};
+
+enum Decoration : std::uint32_t {
+    DecorationBufferBlock = 3,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11,
+    DecorationLocation = 30,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35,
+};
+
+enum StorageClass : std::uint32_t {
+    StorageClassUniformConstant = 0,
+    StorageClassInput = 1,
+    StorageClassUniform = 2,
+    StorageClassPushConstant = 9,
+    StorageClassStorageBuffer = 12,
+};
+
+enum Dim : std::uint32_t {
+    DimBuffer = 5,
+    DimSubpassData = 6,
+};
+
+struct Type {
+    std::uint32_t opcode;
+    // The words following the result id
+    std::vector<std::uint32_t> operands;
+};
+
+struct Decorations {
+    std::optional<std::uint32_t> set;
+    std::optional<std::uint32_t> binding;
+    std::optional<std::uint32_t> location;
+    std::optional<std::uint32_t> array_stride;
+    bool buffer_block = false;
+    bool built_in = false;
+};
+
+struct MemberDecorations {
+    std::uint32_t offset = 0;
+    std::optional<std::uint32_t> matrix_stride;
+};
+
+struct Variable {
+    std::uint32_t id;
+    std::uint32_t type;
+    std::uint32_t storage_class;
+};
+
+class Module {
+   private:
+    std::unordered_map<std::uint32_t, Type> _types;
+    std::unordered_map<std::uint32_t, std::uint32_t> _constants;
+    std::unordered_map<std::uint32_t, Decorations> _decorations;
+    std::unordered_map<std::uint64_t, MemberDecorations> _members;
+
+    static std::uint64_t MemberKey(std::uint32_t type, std::uint32_t member) {
+        return (static_cast<std::uint64_t>(type) << 32u) | member;
+    }
+
+   public:
+    std::uint32_t execution_model = 0;
+    std::vector<Variable> variables;
+
+    explicit Module(const std::vector<std::byte>& code) {
+        if (code.size() % 4 != 0 || code.size() < SpirvHeaderWords * 4) {
+            throw std::runtime_error("Not a SPIR-V module");
+        }
+        std::vector<std::uint32_t> words(code.size() / 4);
+        std::memcpy(words.data(), code.data(), code.size());
+        if (words[0] != SpirvMagic) {
+            throw std::runtime_error("Not a SPIR-V module");
+        }
+
+        for (auto i = SpirvHeaderWords; i < words.size();) {
+            const auto opcode = words[i] & 0xffffu;
+            const auto word_count = words[i] >> 16u;
+            if (word_count == 0 || i + word_count > words.size()) {
+                throw std::runtime_error("Truncated SPIR-V module");
+            }
+            parse(opcode, &words[i + 1], word_count - 1);
+            i += word_count;
+        }
+    }
+
+    void parse(std::uint32_t opcode, const std::uint32_t* operands,
+               std::uint32_t count) {
+        switch (opcode) {
+            case OpEntryPoint:
+                execution_model = operands[0];
+                break;
+            case OpTypeInt:
+            case OpTypeFloat:
+            case OpTypeVector:
+            case OpTypeMatrix:
+            case OpTypeImage:
+            case OpTypeSampler:
+            case OpTypeSampledImage:
+            case OpTypeArray:
+            case OpTypeRuntimeArray:
+            case OpTypeStruct:
+            case OpTypePointer:
+                _types[operands[0]] = {
+                    opcode, {operands + 1, operands + count}};
+                break;
+            case OpConstant:
+                _constants[operands[1]] = operands[2];
+                break;
+            case OpVariable:
+                variables.push_back({operands[1], operands[0], operands[2]});
+                break;
+            case OpDecorate:
+                decorate(_decorations[operands[0]], operands[1],
+                         count > 2 ? operands[2] : 0);
+                break;
+            case OpMemberDecorate: {
+                auto& member = _members[MemberKey(operands[0], operands[1])];
+                if (operands[2] == DecorationOffset) {
+                    member.offset = operands[3];
+                } else if (operands[2] == DecorationMatrixStride) {
+                    member.matrix_stride = operands[3];
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    static void decorate(Decorations& decorations, std::uint32_t decoration,
+                         std::uint32_t value) {
+        switch (decoration) {
+            case DecorationBufferBlock:
+                decorations.buffer_block = true;
+                break;
+            case DecorationArrayStride:
+                decorations.array_stride = value;
+                break;
+            case DecorationBuiltIn:
+                decorations.built_in = true;
+                break;
+            case DecorationLocation:
+                decorations.location = value;
+                break;
+            case DecorationBinding:
+                decorations.binding = value;
+                break;
+            case DecorationDescriptorSet:
+                decorations.set = value;
+                break;
+            default:
+                break;
+        }
+    }
+
+    [[nodiscard]] const Type& type(std::uint32_t id) const {
+        auto it = _types.find(id);
+        if (it == _types.end()) {
+            throw std::runtime_error("Unknown SPIR-V type");
+        }
+        return it->second;
+    }
+
+    [[nodiscard]] Decorations decorations(std::uint32_t id) const {
+        auto it = _decorations.find(id);
+        return it != _decorations.end() ? it->second : Decorations{};
+    }
+
+    [[nodiscard]] std::uint32_t constant(std::uint32_t id) const {
+        return _constants.at(id);
+    }
+
+    // Size of a type laid out in a block, as given by its offsets and strides
+    [[nodiscard]] std::uint32_t size(std::uint32_t id,
+                                     std::optional<std::uint32_t>
+                                         matrix_stride = std::nullopt) const {
+        const auto& t = type(id);
+        switch (t.opcode) {
+            case OpTypeInt:
+            case OpTypeFloat:
+                return t.operands[0] / 8;
+            case OpTypeVector:
+                return size(t.operands[0]) * t.operands[1];
+            case OpTypeMatrix:
+                return matrix_stride ? *matrix_stride * t.operands[1]
+                                     : size(t.operands[0]) * t.operands[1];
+            case OpTypeArray: {
+                const auto stride = decorations(id).array_stride;
+                return (stride ? *stride : size(t.operands[0])) *
+                       constant(t.operands[1]);
+            }
+            case OpTypeStruct: {
+                std::uint32_t result = 0;
+                for (auto i = 0u; i < t.operands.size(); ++i) {
+                    auto it = _members.find(MemberKey(id, i));
+                    const auto member = it != _members.end()
+                                            ? it->second
+                                            : MemberDecorations{};
+                    result = std::max(
+                        result, member.offset + size(t.operands[i],
+                                                     member.matrix_stride));
+                }
+                return result;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    // Offset of the first member of a block
+    [[nodiscard]] std::uint32_t offset(std::uint32_t id) const {
+        const auto& t = type(id);
+        if (t.opcode != OpTypeStruct || t.operands.empty()) {
+            return 0;
+        }
+
+        auto result = std::numeric_limits<std::uint32_t>::max();
+        for (auto i = 0u; i < t.operands.size(); ++i) {
+            auto it = _members.find(MemberKey(id, i));
+            result = std::min(result,
+                              it != _members.end() ? it->second.offset : 0u);
+        }
+        return result;
+    }
+
+    [[nodiscard]] VkFormat format(std::uint32_t id) const {
+        const auto& t = type(id);
+        const auto components = t.opcode == OpTypeVector ? t.operands[1] : 1;
+        const auto& scalar = t.opcode == OpTypeVector ? type(t.operands[0]) : t;
+        if (scalar.operands[0] != 32) {
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        if (scalar.opcode == OpTypeFloat) {
+            const VkFormat formats[] = {
+                VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT,
+                VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+            return formats[components - 1];
+        }
+        if (scalar.opcode == OpTypeInt && scalar.operands[1] != 0) {
+            const VkFormat formats[] = {
+                VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT,
+                VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+            return formats[components - 1];
+        }
+        if (scalar.opcode == OpTypeInt) {
+            const VkFormat formats[] = {
+                VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT,
+                VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+            return formats[components - 1];
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    [[nodiscard]] VkDescriptorType descriptor_type(
+        std::uint32_t id, std::uint32_t storage_class) const {
+        const auto& t = type(id);
+        switch (t.opcode) {
+            case OpTypeSampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case OpTypeSampledImage:
+                return type(t.operands[0]).operands[1] == DimBuffer
+                           ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+                           : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case OpTypeImage: {
+                const auto dim = t.operands[1];
+                const auto storage = t.operands[5] == 2;
+                if (dim == DimSubpassData) {
+                    return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                }
+                if (dim == DimBuffer) {
+                    return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                                   : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                }
+                return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                               : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            }
+            case OpTypeStruct:
+                return storage_class == StorageClassStorageBuffer ||
+                               decorations(id).buffer_block
+                           ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                           : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            default:
+                throw std::runtime_error("Unsupported descriptor type");
+        }
+    }
+};
+
+VkShaderStageFlagBits Stage(std::uint32_t execution_model) {
+    switch (execution_model) {
+        case 0:
+            return VK_SHADER_STAGE_VERTEX_BIT;
+        case 1:
+            return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        case 2:
+            return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        case 3:
+            return VK_SHADER_STAGE_GEOMETRY_BIT;
+        case 4:
+            return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case 5:
+            return VK_SHADER_STAGE_COMPUTE_BIT;
+        default:
+            throw std::runtime_error("Unsupported execution model");
+    }
+}
+}  // namespace
+
+namespace Vulkan {
+ShaderReflection::ShaderReflection(const std::vector<std::byte>& code) {
+    const Module module(code);
+    _stage = Stage(module.execution_model);
+
+    for (const auto& variable : module.variables) {
+        const auto& pointer = module.type(variable.type);
+        const auto pointee = pointer.operands[1];
+        const auto decorations = module.decorations(variable.id);
+
+        switch (variable.storage_class) {
+            case StorageClassUniformConstant:
+            case StorageClassUniform:
+            case StorageClassStorageBuffer: {
+                auto type = pointee;
+                std::uint32_t count = 1;
+                while (module.type(type).opcode == OpTypeArray) {
+                    const auto& array = module.type(type);
+                    count *= module.constant(array.operands[1]);
+                    type = array.operands[0];
+                }
+                if (module.type(type).opcode == OpTypeRuntimeArray) {
+                    count = 0;
+                    type = module.type(type).operands[0];
+                }
+
+                VkDescriptorSetLayoutBinding layout = {};
+                layout.binding = decorations.binding.value_or(0);
+                layout.descriptorType =
+                    module.descriptor_type(type, variable.storage_class);
+                layout.descriptorCount = count;
+                layout.stageFlags = _stage;
+                layout.pImmutableSamplers = nullptr;
+                _bindings.push_back({decorations.set.value_or(0), layout});
+                break;
+            }
+            case StorageClassPushConstant:
+                _push_constant_offset = module.offset(pointee);
+                _push_constant_size =
+                    module.size(pointee) - _push_constant_offset;
+                break;
+            case StorageClassInput:
+                if (_stage == VK_SHADER_STAGE_VERTEX_BIT &&
+                    !decorations.built_in && decorations.location) {
+                    _inputs.push_back(
+                        {*decorations.location, module.format(pointee)});
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::sort(_inputs.begin(), _inputs.end(),
+              [](const Input& a, const Input& b) {
+                  return a.location < b.location;
+              });
+}
+
+ShaderInterface::ShaderInterface(const std::vector<ShaderReflection>& stages) {
+    for (const auto& stage : stages) {
+        for (const auto& binding : stage.bindings()) {
+            auto& set = _sets[binding.set];
+            auto it = std::find_if(
+                set.begin(), set.end(),
+                [&binding](const VkDescriptorSetLayoutBinding& existing) {
+                    return existing.binding == binding.layout.binding;
+                });
+            if (it == set.end()) {
+                set.push_back(binding.layout);
+                continue;
+            }
+
+            if (it->descriptorType != binding.layout.descriptorType ||
+                it->descriptorCount != binding.layout.descriptorCount) {
+                throw std::runtime_error(
+                    "Shader stages disagree on set " +
+                    std::to_string(binding.set) + " binding " +
+                    std::to_string(binding.layout.binding));
+            }
+            it->stageFlags |= binding.layout.stageFlags;
+        }
+
+        if (stage.push_constant_size() > 0) {
+            _push_constants.push_back(
+                {static_cast<VkShaderStageFlags>(stage.stage()),
+                 stage.push_constant_offset(), stage.push_constant_size()});
+        }
+
+        if (stage.stage() == VK_SHADER_STAGE_VERTEX_BIT) {
+            _vertex_inputs = stage.inputs();
+        }
+    }
+
+    for (auto& [index, set] : _sets) {
+        std::sort(set.begin(), set.end(),
+                  [](const VkDescriptorSetLayoutBinding& a,
+                     const VkDescriptorSetLayoutBinding& b) {
+                      return a.binding < b.binding;
+                  });
+    }
+}
+
+ShaderInterface ShaderInterface::Reflect(
+    LogicalDevice& logical_device, const std::vector<ShaderStage>& stages) {
+    std::vector<ShaderReflection> reflections;
+    reflections.reserve(stages.size());
+    for (const auto& stage : stages) {
+        reflections.emplace_back(
+            logical_device.shader_modules().code(stage.file_name));
+        if (reflections.back().stage() != stage.stage) {
+            throw std::runtime_error("Shader " + stage.file_name +
+                                     " is not of the expected stage");
+        }
+    }
+    return ShaderInterface(reflections);
+}
+
+void ShaderInterface::make_dynamic(unsigned int set, unsigned int binding) {
+    for (auto& layout : _sets.at(set)) {
+        if (layout.binding != binding) {
+            continue;
+        }
+
+        switch (layout.descriptorType) {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                layout.descriptorType =
+                    VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                return;
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                layout.descriptorType =
+                    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+                return;
+            default:
+                throw std::invalid_argument("Only buffers can be dynamic");
+        }
+    }
+    throw std::invalid_argument("No such binding");
+}
+
+std::vector<VkDescriptorSetLayoutBinding> ShaderInterface::set_bindings(
+    unsigned int set) const {
+    auto it = _sets.find(set);
+    return it != _sets.end() ? it->second
+                             : std::vector<VkDescriptorSetLayoutBinding>{};
+}
+
+IPipeline::VertexAttribDescContainer ShaderInterface::vertex_attributes(
+    const IPipeline::VertexAttribDescContainer& declared) const {
+    IPipeline::VertexAttribDescContainer result;
+    result.reserve(_vertex_inputs.size());
+    for (const auto& input : _vertex_inputs) {
+        auto it = std::find_if(
+            declared.begin(), declared.end(),
+            [&input](const VkVertexInputAttributeDescription& attribute) {
+                return attribute.location == input.location;
+            });
+        if (it == declared.end()) {
+            throw std::runtime_error("Vertex input location " +
+                                     std::to_string(input.location) +
+                                     " is not declared");
+        }
+        result.push_back(*it);
+    }
+    return result;
+}
+}  // namespace Vulkan
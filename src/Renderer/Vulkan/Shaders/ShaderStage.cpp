@@ -0,0 +1,46 @@
+//
+// Created by Dániel Molnár on 2019-10-28.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Shaders/ShaderStage.hpp>
+
+// ----- std -----
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Renderer/Vulkan/Shaders/FragmentShader.hpp>
+#include <Renderer/Vulkan/Shaders/VertexShader.hpp>
+#include <configuration.hpp>
+
+namespace Vulkan {
+std::unique_ptr<IShader> ShaderStage::load(
+    LogicalDevice& logical_device) const {
+    switch (stage) {
+        case VK_SHADER_STAGE_VERTEX_BIT:
+            return std::make_unique<VertexShader>(logical_device, file_name,
+                                                  entry_point);
+        case VK_SHADER_STAGE_FRAGMENT_BIT:
+            return std::make_unique<FragmentShader>(logical_device, file_name,
+                                                    entry_point);
+        default:
+            throw std::invalid_argument("Unsupported shader stage");
+    }
+}
+
+ShaderStage ShaderStage::SceneVertex() {
+    switch (Configuration::ObjectData) {
+        case ObjectDataStrategy::PushConstants:
+            return {VK_SHADER_STAGE_VERTEX_BIT,
+                    "shader_push_constants_vert.spv", "main"};
+        case ObjectDataStrategy::StorageBuffer:
+            return {VK_SHADER_STAGE_VERTEX_BIT,
+                    "shader_storage_buffer_vert.spv", "main"};
+        case ObjectDataStrategy::DynamicUniformBuffer:
+        default:
+            return {VK_SHADER_STAGE_VERTEX_BIT, "shader_vert.spv", "main"};
+    }
+}
+}  // namespace Vulkan
@@ -0,0 +1,42 @@
+//
+// Created by Dániel Molnár on 2019-11-01.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Shaders/ShaderWatcher.hpp>
+
+// ----- std -----
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Profiling/Trace.hpp>
+#include <Renderer/Vulkan/Shaders/ShaderModuleCache.hpp>
+
+namespace Vulkan {
+ShaderWatcher::ShaderWatcher(ShaderModuleCache& shader_modules,
+                             std::chrono::milliseconds interval)
+    : _shader_modules(shader_modules),
+      _interval(interval),
+      _thread(&ShaderWatcher::watch, this) {}
+
+ShaderWatcher::~ShaderWatcher() {
+    {
+        std::unique_lock lock(_guard);
+        _stopping = true;
+    }
+    _stop_requested.notify_all();
+    _thread.join();
+}
+
+void ShaderWatcher::watch() {
+    Profiling::SetThreadName("Shader watcher");
+    std::unique_lock lock(_guard);
+    while (!_stop_requested.wait_for(lock, _interval,
+                                     [this] { return _stopping; })) {
+        lock.unlock();
+        _shader_modules.recompile_changed();
+        lock.lock();
+    }
+}
+}  // namespace Vulkan
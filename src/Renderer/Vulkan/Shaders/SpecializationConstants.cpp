@@ -0,0 +1,54 @@
+//
+// Created by Dániel Molnár on 2019-10-31.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/Shaders/SpecializationConstants.hpp>
+
+// ----- std -----
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Data/Hash.hpp>
+
+namespace Vulkan {
+VkSpecializationInfo SpecializationConstants::info() const {
+    VkSpecializationInfo info = {};
+    info.mapEntryCount = _entries.size();
+    info.pMapEntries = _entries.data();
+    info.dataSize = _data.size();
+    info.pData = _data.data();
+
+    return info;
+}
+
+std::uint64_t SpecializationConstants::hash(std::uint64_t seed) const {
+    auto hash = seed;
+    for (const auto& entry : _entries) {
+        hash = Hash::FNV1a(entry.constantID, hash);
+        hash = Hash::FNV1a(_data.data() + entry.offset, entry.size, hash);
+    }
+    return hash;
+}
+
+bool SpecializationConstants::operator==(
+    const SpecializationConstants& other) const {
+    if (_entries.size() != other._entries.size()) {
+        return false;
+    }
+
+    for (auto i = 0u; i < _entries.size(); ++i) {
+        const auto& entry = _entries[i];
+        const auto& other_entry = other._entries[i];
+        if (entry.constantID != other_entry.constantID ||
+            entry.size != other_entry.size ||
+            std::memcmp(_data.data() + entry.offset,
+                        other._data.data() + other_entry.offset,
+                        entry.size) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // namespace Vulkan
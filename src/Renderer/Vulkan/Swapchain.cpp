@@ -12,6 +12,7 @@
 // ----- libraries -----
 
 // ----- in-project dependencies
+#include <Profiling/Trace.hpp>
 #include <Renderer/Vulkan/LogicalDevice.hpp>
 #include <Renderer/Vulkan/PhysicalDevice.hpp>
 #include <Renderer/Vulkan/Pipelines/InstancedPipeline.hpp>
@@ -33,16 +34,50 @@ VkSurfaceFormatKHR ChooseSwapSurfaceFormat(
 }
 
 VkPresentModeKHR ChooseSwapPresentMode(
-    const std::vector<VkPresentModeKHR>& available_present_modes) {
-    for (const auto& present_mode : available_present_modes) {
-        if (present_mode == VK_PRESENT_MODE_MAILBOX_KHR) {
+    const std::vector<VkPresentModeKHR>& available_present_modes,
+    PresentPolicy policy) {
+    std::vector<VkPresentModeKHR> preferred;
+    switch (policy) {
+        case PresentPolicy::LowLatency:
+            preferred = {VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
+        case PresentPolicy::Uncapped:
+            preferred = {VK_PRESENT_MODE_IMMEDIATE_KHR,
+                         VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
+        case PresentPolicy::VSync:
+        default:
+            break;
+    }
+
+    for (const auto& present_mode : preferred) {
+        if (std::find(available_present_modes.begin(),
+                      available_present_modes.end(),
+                      present_mode) != available_present_modes.end()) {
             return present_mode;
         }
     }
 
+    // The only mode every surface supports
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+uint32_t ChooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities,
+                          VkPresentModeKHR present_mode) {
+    // Mailbox and immediate would block on acquire while the presentation
+    // engine holds the minimum, with FIFO blocking is the point
+    auto image_count = capabilities.minImageCount;
+    if (present_mode != VK_PRESENT_MODE_FIFO_KHR) {
+        ++image_count;
+    }
+
+    // Zero means there is no limit
+    if (capabilities.maxImageCount > 0) {
+        image_count = std::min(image_count, capabilities.maxImageCount);
+    }
+    return image_count;
+}
+
 VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities,
                             const IWindow& window) {
     if (capabilities.currentExtent.width !=
@@ -72,24 +107,25 @@ Swapchain::Swapchain(const Surface& surface,
     : _surface(surface),
       _physical_device(physical_device),
       _logical_device(logical_device),
+      _pipeline_registry(logical_device),
       _command_pool(*this) {
     create();
 }
 
-void Swapchain::create() {
+void Swapchain::create(VkSwapchainKHR old_swapchain) {
     auto details = Utils::QuerySwapChainSupport(_physical_device.handle(),
                                                 _surface.handle());
 
     auto format = ChooseSwapSurfaceFormat(details.formats);
 
-    auto present_mode = ChooseSwapPresentMode(details.present_modes);
+    _present_mode =
+        ChooseSwapPresentMode(details.present_modes, _present_policy);
 
     _extent = ChooseSwapExtent(details.capabilities, _surface.window());
     _format = format.format;
 
     unsigned int image_count =
-        std::clamp(details.capabilities.minImageCount + 5, 0u,
-                   details.capabilities.maxImageCount);
+        ChooseImageCount(details.capabilities, _present_mode);
 
     VkSwapchainCreateInfoKHR create_info = {};
     create_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -99,8 +135,13 @@ void Swapchain::create() {
     create_info.imageFormat = _format;
     create_info.imageExtent = _extent;
     create_info.imageArrayLayers = 1;
-    create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    create_info.presentMode = present_mode;
+    _image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (details.capabilities.supportedUsageFlags &
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+        _image_usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
+    create_info.imageUsage = _image_usage;
+    create_info.presentMode = _present_mode;
 
     if (auto indices = Utils::FindQueueFamilies(_physical_device, _surface);
         indices.present_family != indices.graphics_family) {
@@ -120,7 +161,7 @@ void Swapchain::create() {
     create_info.preTransform = details.capabilities.currentTransform;
     create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     create_info.clipped = true;
-    create_info.oldSwapchain = VK_NULL_HANDLE;
+    create_info.oldSwapchain = old_swapchain;
 
     if (vkCreateSwapchainKHR(_logical_device.handle(), &create_info, nullptr,
                              &_swapchain) != VK_SUCCESS) {
@@ -144,21 +185,28 @@ void Swapchain::create() {
         _image_views.emplace_back(image.create_view(VK_IMAGE_ASPECT_COLOR_BIT));
     }
 
-    _render_pass = std::make_unique<RenderPass>(*this);
+    // The render pass only depends on the formats, a resize just replaces
+    // its depth image
+    if (_render_pass == nullptr || _render_pass->color_format() != _format) {
+        _render_pass = std::make_unique<RenderPass>(*this);
+    } else {
+        _render_pass->resize();
+    }
 
     for (const auto& image_view : _image_views) {
         _framebuffers.emplace_back(*image_view, *this);
     }
-    _command_pool.allocate_buffers(image_count);
 }
 
 VkResult Swapchain::acquireNextImage(unsigned int& index, VkSemaphore signal) {
+    TRACE_ZONE("Swapchain::acquireNextImage");
     return vkAcquireNextImageKHR(_logical_device.handle(), _swapchain,
                                  std::numeric_limits<uint64_t>::max(), signal,
                                  VK_NULL_HANDLE, &index);
 }
 
 VkResult Swapchain::present(unsigned int index, VkSemaphore wait) {
+    TRACE_ZONE("Swapchain::present");
     VkPresentInfoKHR present_info = {};
 
     present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -177,21 +225,41 @@ VkResult Swapchain::present(unsigned int index, VkSemaphore wait) {
 }
 
 void Swapchain::teardown() {
-    _command_pool.free_buffers();
-    _render_pass.reset();
     _framebuffers.clear();
     _image_views.clear();
     _images.clear();
-    vkDestroySwapchainKHR(_logical_device.handle(), _swapchain, nullptr);
 }
 
 void Swapchain::recreate() {
+    const auto format = _format;
+    const auto old_swapchain = _swapchain;
+
     teardown();
-    create();
+    create(old_swapchain);
+    vkDestroySwapchainKHR(_logical_device.handle(), old_swapchain, nullptr);
+
+    // Viewport and scissor are dynamic, pipelines only have to follow a new
+    // render pass
+    if (_format != format) {
+        for (auto& pipeline : _pipelines) {
+            pipeline->recreate();
+        }
+        _pipeline_registry.retarget(_render_pass->handle());
+    }
+}
 
-    for (auto& pipeline : _pipelines ) {
-        pipeline->recreate();
+void Swapchain::reload_shaders(const std::vector<std::string>& file_names) {
+    for (auto& pipeline : _pipelines) {
+        const auto uses_file =
+            std::any_of(file_names.begin(), file_names.end(),
+                        [&pipeline](const auto& file_name) {
+                            return pipeline->uses_shader(file_name);
+                        });
+        if (uses_file) {
+            pipeline->recreate();
+        }
     }
+    _pipeline_registry.reload(file_names);
 }
 
 Swapchain::~Swapchain() {
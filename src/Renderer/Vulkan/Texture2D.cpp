@@ -6,63 +6,231 @@
 #include <Renderer/Vulkan/Texture2D.hpp>
 
 // ----- std -----
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 
 // ----- libraries -----
 
 // ----- in-project dependencies
 #include <Data/Representation.hpp>
-#include <Renderer/Vulkan/Descriptors/DescriptorPool.hpp>
+#include <Renderer/Vulkan/Descriptors/BindlessTextureSet.hpp>
+#include <Renderer/Vulkan/Descriptors/DescriptorAllocator.hpp>
 #include <Renderer/Vulkan/Descriptors/DescriptorSetLayout.hpp>
 
+namespace {
+VkFormat ToVkFormat(Asset::TextureFormat format, bool srgb) {
+    switch (format) {
+        case Asset::TextureFormat::R8G8B8A8:
+            return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        case Asset::TextureFormat::BC1:
+            return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+                        : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case Asset::TextureFormat::BC3:
+            return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        case Asset::TextureFormat::BC5:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case Asset::TextureFormat::BC7:
+            return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    }
+    throw std::invalid_argument("Unknown texture format");
+}
+
+unsigned int ResidentLevel(const Asset::Texture& texture,
+                           unsigned int first_mip) {
+    if (first_mip >= texture.levels().size()) {
+        throw std::out_of_range("Texture has no such mip level");
+    }
+    return first_mip;
+}
+
+// Levels from first_mip on, offsets relative to the first resident level
+std::vector<Asset::MipLevel> ResidentLevels(const Asset::Texture& texture,
+                                            unsigned int first_mip) {
+    const auto& levels = texture.levels();
+    const auto base = levels[first_mip].offset;
+
+    std::vector<Asset::MipLevel> resident(levels.begin() + first_mip,
+                                          levels.end());
+    for (auto& level : resident) {
+        level.offset -= base;
+    }
+    return resident;
+}
+}  // namespace
+
 namespace Vulkan {
 Texture2D::Texture2D(LogicalDevice& logical_device, const Asset::Image& image)
     : Image(logical_device, VK_IMAGE_TYPE_2D, image.width(), image.height(), 1,
             1, 1, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL,
             VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                VK_IMAGE_USAGE_SAMPLED_BIT,
             VK_SHARING_MODE_EXCLUSIVE, VK_SAMPLE_COUNT_1_BIT, 0,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
-      _image_asset(image) {
+      _data(image.data()),
+      _data_size(image.size()),
+      _texel_block_size(
+          Asset::BlockCompression::BlockBytes(Asset::TextureFormat::R8G8B8A8)),
+      _levels{{static_cast<unsigned int>(image.width()),
+               static_cast<unsigned int>(image.height()), 0, image.size()}} {
+    _view = create_view(VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+Texture2D::Texture2D(LogicalDevice& logical_device,
+                     const Asset::Texture& texture, unsigned int first_mip)
+    : Image(logical_device, VK_IMAGE_TYPE_2D,
+            texture.levels()[ResidentLevel(texture, first_mip)].width,
+            texture.levels()[first_mip].height, 1,
+            texture.levels().size() - first_mip, 1,
+            ToVkFormat(texture.format(), texture.srgb()),
+            VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_SHARING_MODE_EXCLUSIVE, VK_SAMPLE_COUNT_1_BIT, 0,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+      _data(texture.data() + texture.levels()[first_mip].offset),
+      _data_size(texture.size() - texture.levels()[first_mip].offset),
+      _texel_block_size(Asset::BlockCompression::BlockBytes(texture.format())),
+      _levels(ResidentLevels(texture, first_mip)),
+      _first_mip(first_mip) {
+    _view = create_view(VK_IMAGE_ASPECT_COLOR_BIT);
+}
+
+Texture2D::Texture2D(LogicalDevice& logical_device, const Texture2D& layout)
+    : Image(logical_device, VK_IMAGE_TYPE_2D, layout._extent.width,
+            layout._extent.height, 1, layout._mip_levels,
+            layout._array_layers, layout._format, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_LAYOUT_UNDEFINED, layout._usage, layout._sharing_mode,
+            VK_SAMPLE_COUNT_1_BIT, 0, layout._properties),
+      _data(layout._data),
+      _data_size(layout._data_size),
+      _texel_block_size(layout._texel_block_size),
+      _levels(layout._levels),
+      _first_mip(layout._first_mip) {
     _view = create_view(VK_IMAGE_ASPECT_COLOR_BIT);
 }
 
+Texture2D::~Texture2D() {
+    if (_bindless_set != nullptr) {
+        _bindless_set->remove(_bindless_index);
+    }
+    if (_descriptor_set != nullptr) {
+        _descriptor_allocator->release_cached(_descriptor_set);
+    }
+}
+
 void Texture2D::transfer(Vulkan::TempCommandBuffer& command_buffer,
                          VkQueue queue) {
     auto stage_buf =
         std::make_unique<PolymorphBuffer<StagingBufferTag>>(_logical_device);
     auto desc = pre_stage(*stage_buf);
     stage_buf->allocate();
-    stage(command_buffer, *stage_buf, desc);
+    stage(command_buffer.handle(), *stage_buf, desc);
 
     command_buffer.flush(queue);
 }
 
 SubBufferDescriptor Texture2D::pre_stage(
     Vulkan::PolymorphBuffer<Vulkan::StagingBufferTag>& stage) {
-    return stage.commit_sub_buffer<StagingBufferTag>(_image_asset.size());
+    // Buffer to image copies need offsets aligned to the texel block size
+    return stage.commit_sub_buffer<StagingBufferTag>(
+        _data_size, std::max<VkDeviceSize>(_texel_block_size, 4));
 }
 
-void Texture2D::stage(TempCommandBuffer& command_buffer,
+void Texture2D::stage(VkCommandBuffer command_buffer,
                       PolymorphBuffer<StagingBufferTag>& stage,
                       const SubBufferDescriptor& desc) {
-    stage.transfer((void*)_image_asset.data(), desc);
-    stage.copy_to(command_buffer, desc, *this);
+    stage.transfer((void*)_data, desc);
+
+    std::vector<SubBufferDescriptor> mip_descs;
+    mip_descs.reserve(_levels.size());
+    for (const auto& level : _levels) {
+        mip_descs.push_back(
+            {desc.usage, level.size, desc.offset + level.offset});
+    }
+    stage.copy_to(command_buffer, mip_descs, *this);
 }
 
-void Texture2D::attach_desc_pool(DescriptorPool* pool,
-                                 DescriptorSetLayout* layout,
-                                 VkSampler sampler) {
-    _descriptor_pool = pool;
+void Texture2D::attach_descriptors(DescriptorAllocator* allocator,
+                                   DescriptorSetLayout* layout,
+                                   VkSampler sampler) {
+    if (_descriptor_set != nullptr) {
+        _descriptor_allocator->release_cached(_descriptor_set);
+    }
+    _descriptor_allocator = allocator;
     _descriptor_set_layout = layout;
-    _descriptor_set =
-        _descriptor_pool->allocate_set(_descriptor_set_layout->handle());
-    _descriptor_set->write(Texture_sampler_descriptor(), 0, *this, *_view,
-                           sampler);
-    _descriptor_set->update();
+    _sampler = sampler;
+    _descriptor_set = _descriptor_allocator->cached(
+        _descriptor_set_layout->handle(),
+        DescriptorBindings().image(Texture_sampler_descriptor(), 0, *this,
+                                   *_view, _sampler));
 }
 
 VkDescriptorSet Texture2D::desc_handle() const {
     return _descriptor_set->handle();
 }
 
+void Texture2D::attach_bindless(BindlessTextureSet* set, VkSampler sampler) {
+    _bindless_set = set;
+    _sampler = sampler;
+    _bindless_index = _bindless_set->add(*this, *_view, _sampler);
+}
+
+void Texture2D::swap_residency(Texture2D& other) {
+    swap_storage(other);
+    std::swap(_view, other._view);
+    std::swap(_data, other._data);
+    std::swap(_data_size, other._data_size);
+    std::swap(_levels, other._levels);
+    std::swap(_first_mip, other._first_mip);
+
+    // other releases the previous set or slot when destroyed
+    if (_descriptor_set != nullptr) {
+        other._descriptor_allocator = _descriptor_allocator;
+        other._descriptor_set_layout = _descriptor_set_layout;
+        other._descriptor_set = _descriptor_set;
+        _descriptor_set = _descriptor_allocator->cached(
+            _descriptor_set_layout->handle(),
+            DescriptorBindings().image(Texture_sampler_descriptor(), 0, *this,
+                                       *_view, _sampler));
+    }
+    if (_bindless_set != nullptr) {
+        other._bindless_set = _bindless_set;
+        other._bindless_index = _bindless_index;
+        _bindless_index = _bindless_set->add(*this, *_view, _sampler);
+    }
+}
+
+std::unique_ptr<Texture2D> Texture2D::relocate(
+    VkCommandBuffer command_buffer) {
+    std::unique_ptr<Texture2D> moved(new Texture2D(_logical_device, *this));
+
+    transition_layout(command_buffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    moved->transition_layout(command_buffer,
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    std::vector<VkImageCopy> regions;
+    regions.reserve(_levels.size());
+    for (auto level = 0u; level < _levels.size(); ++level) {
+        VkImageCopy region = {};
+        region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.srcSubresource.mipLevel = level;
+        region.srcSubresource.baseArrayLayer = 0;
+        region.srcSubresource.layerCount = _array_layers;
+        region.dstSubresource = region.srcSubresource;
+        // Whole levels, so block compressed sizes need no rounding
+        region.extent = {_levels[level].width, _levels[level].height, 1};
+        regions.push_back(region);
+    }
+    vkCmdCopyImage(command_buffer, _image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   moved->_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   regions.size(), regions.data());
+
+    moved->transition_layout(command_buffer,
+                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    swap_residency(*moved);
+    return moved;
+}
+
 }  // namespace Vulkan
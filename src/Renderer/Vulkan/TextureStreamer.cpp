@@ -0,0 +1,262 @@
+//
+// Created by Dániel Molnár on 2019-10-22.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/TextureStreamer.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Profiling/Trace.hpp>
+#include <Renderer/Vulkan/GpuProfiler.hpp>
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
+#include <Renderer/Vulkan/Texture2D.hpp>
+
+namespace {
+VkDeviceSize ResidentSize(const Asset::Texture& texture,
+                          unsigned int first_mip) {
+    return texture.size() - texture.levels()[first_mip].offset;
+}
+
+// The largest level which still fits the limit is kept resident all the time
+unsigned int MinResidentLevel(const Asset::Texture& texture) {
+    const auto& levels = texture.levels();
+    for (auto i = 0u; i < levels.size(); ++i) {
+        if (std::max(levels[i].width, levels[i].height) <=
+            Configuration::TextureStreamingMinResidentSize) {
+            return i;
+        }
+    }
+    return levels.size() - 1;
+}
+
+// The level whose height matches the on-screen size, beyond that the sampler
+// would only ever read the smaller levels anyway
+unsigned int DesiredLevel(const Asset::Texture& texture, float screen_size) {
+    const auto ratio = texture.height() / std::max(screen_size, 1.0f);
+    if (ratio <= 1.0f) {
+        return 0;
+    }
+    return static_cast<unsigned int>(std::floor(std::log2(ratio)));
+}
+}  // namespace
+
+namespace Vulkan {
+TextureStreamer::TextureStreamer(LogicalDevice& logical_device,
+                                 unsigned int frame_count,
+                                 VkDeviceSize budget,
+                                 VkDeviceSize upload_limit)
+    : _logical_device(logical_device),
+      _budget(budget),
+      _upload_limit(upload_limit),
+      _slots(frame_count) {}
+
+std::unique_ptr<Texture2D> TextureStreamer::create(
+    const Asset::Texture& texture) {
+    const Memory::TagScope tag("Streamed textures");
+    const auto first_mip = MinResidentLevel(texture);
+    auto result =
+        std::make_unique<Texture2D>(_logical_device, texture, first_mip);
+
+    _entries.push_back({&texture, result.get(), first_mip, first_mip});
+    return result;
+}
+
+TextureStreamer::Entry& TextureStreamer::entry_of(const Texture2D& texture) {
+    auto it = std::find_if(
+        _entries.begin(), _entries.end(),
+        [&texture](const Entry& entry) { return entry.texture == &texture; });
+    if (it == _entries.end()) {
+        throw std::invalid_argument("Texture is not streamed");
+    }
+    return *it;
+}
+
+void TextureStreamer::report_usage(const Texture2D& texture,
+                                   float screen_size) {
+    auto& entry = entry_of(texture);
+    entry.screen_size = std::max(entry.screen_size, screen_size);
+}
+
+void TextureStreamer::fit_budget() {
+    VkDeviceSize total = 0;
+    for (const auto& entry : _entries) {
+        total += ResidentSize(*entry.asset, entry.desired_first_mip);
+    }
+
+    // Drop one level at a time from the least recently used textures, the
+    // smaller ones on screen going first among equals
+    while (total > _budget) {
+        Entry* victim = nullptr;
+        for (auto& entry : _entries) {
+            if (entry.desired_first_mip >= entry.min_first_mip) {
+                continue;
+            }
+            if (victim == nullptr ||
+                entry.last_used_frame < victim->last_used_frame ||
+                (entry.last_used_frame == victim->last_used_frame &&
+                 entry.screen_size < victim->screen_size)) {
+                victim = &entry;
+            }
+        }
+        if (victim == nullptr) {
+            break;  // only the always resident levels are left
+        }
+
+        total -= ResidentSize(*victim->asset, victim->desired_first_mip) -
+                 ResidentSize(*victim->asset, victim->desired_first_mip + 1);
+        ++victim->desired_first_mip;
+    }
+}
+
+bool TextureStreamer::begin_frame(unsigned int frame) {
+    TRACE_ZONE("TextureStreamer::begin_frame");
+    _current = frame;
+    auto& slot = _slots.at(_current);
+    slot.retired.clear();
+    if (slot.replacements.empty()) {
+        return false;
+    }
+
+    // The replacements receive the previous images and descriptors, which
+    // the other frames in flight may still use
+    for (auto i = 0u; i < slot.replacements.size(); ++i) {
+        slot.changes[i].entry->texture->swap_residency(*slot.replacements[i]);
+    }
+    slot.retired = std::move(slot.replacements);
+    slot.replacements.clear();
+    slot.changes.clear();
+    slot.stage.reset();
+    _uploading = false;
+    return true;
+}
+
+bool TextureStreamer::end_frame() {
+    ++_frame;
+    _pending.clear();
+
+    for (auto& entry : _entries) {
+        if (entry.screen_size > 0.0f) {
+            entry.last_used_frame = _frame;
+            entry.desired_first_mip =
+                std::min(DesiredLevel(*entry.asset, entry.screen_size),
+                         entry.min_first_mip);
+        } else if (_frame - entry.last_used_frame >
+                   Configuration::TextureStreamingEvictionDelay) {
+            entry.desired_first_mip = entry.min_first_mip;
+        }
+    }
+
+    // The levels in flight are not resident yet
+    if (!_uploading) {
+        plan();
+    }
+
+    for (auto& entry : _entries) {
+        entry.screen_size = 0.0f;
+    }
+
+    return !_pending.empty();
+}
+
+void TextureStreamer::plan() {
+    fit_budget();
+
+    // Evictions free memory, so they are never held back
+    for (auto& entry : _entries) {
+        if (entry.desired_first_mip > entry.texture->first_mip()) {
+            _pending.push_back({&entry, entry.desired_first_mip});
+        }
+    }
+
+    // Loads go one level at a time, the largest textures on screen first,
+    // until the upload limit of the frame is reached
+    std::vector<Entry*> loads;
+    for (auto& entry : _entries) {
+        if (entry.desired_first_mip < entry.texture->first_mip()) {
+            loads.push_back(&entry);
+        }
+    }
+    std::sort(loads.begin(), loads.end(), [](const Entry* a, const Entry* b) {
+        return a->screen_size > b->screen_size;
+    });
+
+    VkDeviceSize uploaded = 0;
+    for (auto* entry : loads) {
+        const auto first_mip = entry->texture->first_mip() - 1;
+        const auto size = ResidentSize(*entry->asset, first_mip);
+        if (uploaded > 0 && uploaded + size > _upload_limit) {
+            break;
+        }
+
+        uploaded += size;
+        _pending.push_back({entry, first_mip});
+    }
+}
+
+void TextureStreamer::record(VkCommandBuffer command_buffer,
+                             GpuProfiler* profiler) {
+    TRACE_ZONE("TextureStreamer::record");
+    if (_pending.empty()) {
+        return;
+    }
+
+    const Memory::TagScope tag("Streamed textures");
+    auto& slot = _slots.at(_current);
+    slot.stage =
+        std::make_unique<PolymorphBuffer<StagingBufferTag>>(_logical_device);
+
+    std::vector<SubBufferDescriptor> stage_descs;
+    slot.replacements.reserve(_pending.size());
+    stage_descs.reserve(_pending.size());
+    for (const auto& change : _pending) {
+        auto& replacement =
+            slot.replacements.emplace_back(std::make_unique<Texture2D>(
+                _logical_device, *change.entry->asset, change.first_mip));
+        stage_descs.push_back(replacement->pre_stage(*slot.stage));
+    }
+
+    slot.stage->allocate();
+    _uploaded_size += slot.stage->size();
+
+    auto scope = GpuProfiler::NoScope;
+    if (profiler) {
+        scope = profiler->begin(command_buffer, "Stream textures");
+    }
+    for (auto i = 0u; i < slot.replacements.size(); ++i) {
+        slot.replacements[i]->stage(command_buffer, *slot.stage,
+                                    stage_descs[i]);
+        slot.replacements[i]->transition_layout(
+            command_buffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+    if (profiler) {
+        profiler->end(command_buffer, scope);
+    }
+
+    slot.changes = std::move(_pending);
+    _pending.clear();
+    _uploading = true;
+}
+
+void TextureStreamer::release() {
+    for (auto& slot : _slots) {
+        slot = {};
+    }
+    _uploading = false;
+}
+
+VkDeviceSize TextureStreamer::resident_size() const {
+    VkDeviceSize total = 0;
+    for (const auto& entry : _entries) {
+        total += entry.texture->resident_size();
+    }
+    return total;
+}
+}  // namespace Vulkan
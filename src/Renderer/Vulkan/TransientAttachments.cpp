@@ -0,0 +1,231 @@
+//
+// Created by Dániel Molnár on 2019-11-11.
+//
+
+// ----- own header -----
+#include <Renderer/Vulkan/TransientAttachments.hpp>
+
+// ----- std -----
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Renderer/Vulkan/LogicalDevice.hpp>
+#include <Renderer/Vulkan/Memory/Allocator.hpp>
+#include <Renderer/Vulkan/Memory/Block.hpp>
+#include <Renderer/Vulkan/Memory/Category.hpp>
+#include <Renderer/Vulkan/PhysicalDevice.hpp>
+
+namespace Vulkan {
+namespace {
+constexpr VkImageUsageFlags AttachmentUsage =
+    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+    VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+constexpr VkMemoryPropertyFlags DeviceLocalProperties =
+    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+constexpr VkMemoryPropertyFlags LazyProperties =
+    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+    VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+bool HasMemoryType(const PhysicalDevice& physical_device, uint32_t type_bits,
+                   VkMemoryPropertyFlags flags) {
+    VkPhysicalDeviceMemoryProperties properties = {};
+    vkGetPhysicalDeviceMemoryProperties(physical_device.handle(), &properties);
+    for (auto i = 0u; i < properties.memoryTypeCount; ++i) {
+        if ((type_bits & (1u << i)) &&
+            (properties.memoryTypes[i].propertyFlags & flags) == flags) {
+            return true;
+        }
+    }
+    return false;
+}
+
+VkImageAspectFlags ViewAspect(VkImageUsageFlags usage) {
+    return (usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
+               ? VK_IMAGE_ASPECT_DEPTH_BIT
+               : VK_IMAGE_ASPECT_COLOR_BIT;
+}
+}  // namespace
+
+TransientAttachments::TransientAttachments(
+    const PhysicalDevice& physical_device, LogicalDevice& logical_device,
+    std::vector<std::string> pass_order)
+    : _physical_device(physical_device),
+      _logical_device(logical_device),
+      _passes(std::move(pass_order)),
+      _lazily_allocated(HasMemoryType(physical_device, ~0u, LazyProperties)) {
+    for (auto i = 0u; i < _passes.size(); ++i) {
+        if (pass_index(_passes[i]) != i) {
+            throw std::invalid_argument("Pass " + _passes[i] +
+                                        " is listed more than once");
+        }
+    }
+}
+
+TransientAttachments::~TransientAttachments() { release(); }
+
+unsigned int TransientAttachments::pass_index(const std::string& pass) const {
+    const auto it = std::find(_passes.begin(), _passes.end(), pass);
+    if (it == _passes.end()) {
+        throw std::invalid_argument("Unknown pass " + pass);
+    }
+    return static_cast<unsigned int>(it - _passes.begin());
+}
+
+bool TransientAttachments::transient(const Attachment& attachment) const {
+    return (attachment.usage & ~AttachmentUsage) == 0 &&
+           attachment.first_pass == attachment.last_pass;
+}
+
+unsigned int TransientAttachments::declare(const std::string& name,
+                                           VkFormat format,
+                                           VkImageUsageFlags usage,
+                                           const std::string& first_pass,
+                                           const std::string& last_pass) {
+    Attachment attachment;
+    attachment.name = name;
+    attachment.format = format;
+    attachment.usage = usage;
+    attachment.first_pass = pass_index(first_pass);
+    attachment.last_pass = pass_index(last_pass);
+    if (attachment.last_pass < attachment.first_pass) {
+        throw std::invalid_argument("Attachment " + name +
+                                    " ends before its first pass");
+    }
+
+    _attachments.push_back(std::move(attachment));
+    return _attachments.size() - 1;
+}
+
+void TransientAttachments::release() {
+    for (auto& attachment : _attachments) {
+        attachment.view.reset();
+        attachment.image.reset();
+        if (attachment.dedicated) {
+            _logical_device.release_memory(*attachment.dedicated);
+            attachment.dedicated = nullptr;
+        }
+    }
+    for (const auto& slot : _slots) {
+        if (slot.block) {
+            _logical_device.release_memory(*slot.block);
+        }
+    }
+    _slots.clear();
+}
+
+void TransientAttachments::create(VkExtent2D extent) {
+    release();
+    const Memory::TagScope tag("Transient attachments");
+
+    std::vector<VkMemoryRequirements> requirements;
+    std::vector<VkMemoryPropertyFlags> properties;
+    // Indices of the attachments sharing memory
+    std::vector<unsigned int> order;
+    requirements.reserve(_attachments.size());
+    properties.reserve(_attachments.size());
+    for (auto i = 0u; i < _attachments.size(); ++i) {
+        auto& attachment = _attachments[i];
+        const auto lazy = _lazily_allocated && transient(attachment);
+        attachment.image = std::make_unique<AttachmentImage>(
+            _logical_device, extent, attachment.format,
+            lazy ? attachment.usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+                 : attachment.usage,
+            lazy ? LazyProperties : DeviceLocalProperties);
+
+        Memory::Resource resource;
+        const auto& required = requirements.emplace_back(
+            attachment.image->memory_requirements(resource));
+        attachment.size = required.size;
+        // Transient images may still not be allowed in the lazy types
+        properties.push_back(
+            lazy && HasMemoryType(_physical_device, required.memoryTypeBits,
+                                  LazyProperties)
+                ? LazyProperties
+                : DeviceLocalProperties);
+
+        // Only a preference is outweighed by the memory aliasing saves
+        if (resource.requires_dedicated) {
+            attachment.dedicated = &_logical_device.allocator().request_memory(
+                required, properties.back(), Memory::Category::Attachment,
+                resource);
+            attachment.image->bind(*attachment.dedicated);
+            attachment.view =
+                attachment.image->create_view(ViewAspect(attachment.usage));
+        } else {
+            order.push_back(i);
+        }
+    }
+
+    // Largest first, so the smaller ones fit in the slots they share
+    std::stable_sort(order.begin(), order.end(),
+                     [&requirements](unsigned int a, unsigned int b) {
+                         return requirements[a].size > requirements[b].size;
+                     });
+
+    const auto overlap = [this](unsigned int a, unsigned int b) {
+        return _attachments[a].first_pass <= _attachments[b].last_pass &&
+               _attachments[b].first_pass <= _attachments[a].last_pass;
+    };
+    for (const auto index : order) {
+        const auto& required = requirements[index];
+        auto slot = std::find_if(
+            _slots.begin(), _slots.end(), [&](const Slot& candidate) {
+                return candidate.properties == properties[index] &&
+                       (candidate.requirements.memoryTypeBits &
+                        required.memoryTypeBits) != 0 &&
+                       std::none_of(candidate.attachments.begin(),
+                                    candidate.attachments.end(),
+                                    [&](unsigned int other) {
+                                        return overlap(index, other);
+                                    });
+            });
+        if (slot == _slots.end()) {
+            _slots.push_back({required, properties[index], {index}});
+            continue;
+        }
+
+        slot->requirements.size =
+            std::max(slot->requirements.size, required.size);
+        slot->requirements.alignment =
+            std::max(slot->requirements.alignment, required.alignment);
+        slot->requirements.memoryTypeBits &= required.memoryTypeBits;
+        slot->attachments.push_back(index);
+    }
+
+    for (auto& slot : _slots) {
+        slot.block = &_logical_device.allocator().request_memory(
+            slot.requirements, slot.properties, Memory::Category::Attachment);
+        for (const auto index : slot.attachments) {
+            auto& attachment = _attachments[index];
+            attachment.image->bind(*slot.block);
+            attachment.view =
+                attachment.image->create_view(ViewAspect(attachment.usage));
+        }
+    }
+}
+
+VkDeviceSize TransientAttachments::size() const {
+    VkDeviceSize result = 0;
+    for (const auto& slot : _slots) {
+        result += slot.block ? slot.block->size().value : 0;
+    }
+    for (const auto& attachment : _attachments) {
+        result += attachment.dedicated ? attachment.dedicated->size().value : 0;
+    }
+    return result;
+}
+
+VkDeviceSize TransientAttachments::unaliased_size() const {
+    VkDeviceSize result = 0;
+    for (const auto& attachment : _attachments) {
+        result += attachment.size;
+    }
+    return result;
+}
+}  // namespace Vulkan
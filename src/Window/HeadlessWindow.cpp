@@ -0,0 +1,38 @@
+//
+// Created by Dániel Molnár on 2019-11-05.
+//
+
+// ----- own header -----
+#include <Window/HeadlessWindow.hpp>
+
+// ----- std -----
+
+// ----- libraries -----
+
+// ----- in-project dependencies
+#include <Renderer/Vulkan/Renderer.hpp>
+
+HeadlessWindow::HeadlessWindow(unsigned width, unsigned height,
+                               unsigned int frame_count)
+    : _width(static_cast<int>(width)),
+      _height(static_cast<int>(height)),
+      _frame_count(frame_count) {}
+
+std::optional<VkSurfaceKHR> HeadlessWindow::create_surface(
+    Vulkan::Renderer& renderer) const {
+    const auto instance = renderer.get_instance().handle();
+    auto create = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+        vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+    if (!create) {
+        return {};
+    }
+
+    VkHeadlessSurfaceCreateInfoEXT create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+    VkSurfaceKHR surface;
+    if (create(instance, &create_info, nullptr, &surface) != VK_SUCCESS) {
+        return {};
+    }
+    return surface;
+}
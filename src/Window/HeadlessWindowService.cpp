@@ -0,0 +1,50 @@
+//
+// Created by Dániel Molnár on 2019-11-05.
+//
+
+// ----- own header -----
+#include <Window/HeadlessWindowService.hpp>
+
+// ----- std -----
+#include <array>
+
+// ----- libraries -----
+#include <vulkan/vulkan.h>
+
+// ----- in-project dependencies
+
+namespace {
+std::array<const char*, 2> Extensions = {
+    VK_KHR_SURFACE_EXTENSION_NAME, VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME};
+}
+
+HeadlessWindowService::HeadlessWindowService(unsigned int frame_count)
+    : _frame_count(frame_count) {}
+
+std::shared_ptr<IWindow> HeadlessWindowService::spawn_window(
+    unsigned width, unsigned height, const std::string&) {
+    auto window =
+        std::make_shared<HeadlessWindow>(width, height, _frame_count);
+    return _windows.emplace_back(window);
+}
+
+void HeadlessWindowService::pre_render_hook() {}
+
+void HeadlessWindowService::post_render_hook() {
+    for (auto& window : _windows) {
+        window->frame_rendered();
+    }
+}
+
+void HeadlessWindowService::setup(RendererType type) {
+    switch (type) {
+        case RendererType::Vulkan:
+            // Without VK_EXT_headless_surface creating the instance fails
+            break;
+    }
+}
+
+std::pair<unsigned int, const char**> HeadlessWindowService::get_extensions()
+    const {
+    return {static_cast<unsigned int>(Extensions.size()), Extensions.data()};
+}